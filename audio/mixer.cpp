@@ -20,6 +20,8 @@
  *
  */
 
+#include "common/atomic.h"
+#include "common/benchmark.h"
 #include "common/util.h"
 #include "common/system.h"
 #include "common/textconsole.h"
@@ -29,9 +31,22 @@
 #include "audio/audiostream.h"
 #include "audio/timestamp.h"
 
+// The mixer methods may be called by the consumer itself, e.g. from the
+// readBuffer() of a stream being mixed, so it marks its thread. Compilers
+// without thread local storage never see themselves as the consumer.
+#if defined(_MSC_VER)
+#define MIXER_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__)
+#define MIXER_THREAD_LOCAL __thread
+#endif
 
 namespace Audio {
 
+#ifdef MIXER_THREAD_LOCAL
+/** The mixer whose consumer runs on this thread, if any. */
+static MIXER_THREAD_LOCAL const MixerImpl *s_consumer = 0;
+#endif
+
 #pragma mark -
 #pragma mark --- Channel classes ---
 #pragma mark -
@@ -115,15 +130,17 @@ public:
 	int8 getBalance();
 
 	/**
-	 * Notifies the channel that the global sound type
-	 * volume settings changed.
+	 * Sets the volume of the channel's sound type.
+	 *
+	 * @param volume new volume, 0 when the sound type is muted
 	 */
-	void notifyGlobalVolChange() { updateChannelVolumes(); }
+	void setSoundTypeVolume(int volume);
 
 	/**
-	 * Queries how long the channel has been playing.
+	 * Stores the information needed to compute how long the
+	 * channel has been playing.
 	 */
-	Timestamp getElapsedTime();
+	void getTiming(MixerImpl::ChannelTiming &timing) const;
 
 	/**
 	 * Queries the channel's sound type.
@@ -151,6 +168,7 @@ private:
 
 	byte _volume;
 	int8 _balance;
+	int _soundTypeVolume;
 
 	void updateChannelVolumes();
 	st_volume_t _volL, _volR;
@@ -173,15 +191,25 @@ private:
 
 // TODO: parameter "system" is unused
 MixerImpl::MixerImpl(OSystem *system, uint sampleRate)
-	: _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	: _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings(),
+	  _commandHead(0), _commandTail(0), _consumerEpoch(0), _mixing(false) {
 
 	assert(sampleRate > 0);
 
-	for (int i = 0; i != NUM_CHANNELS; i++)
+	_stoppedChannels.reserve(NUM_CHANNELS);
+
+	for (int i = 0; i != NUM_CHANNELS; i++) {
 		_channels[i] = 0;
+		_finishedHandles[i] = (int32)0xFFFFFFFF;
+		memset(&_channelTimings[i], 0, sizeof(_channelTimings[i]));
+		_channelTimings[i].handle = 0xFFFFFFFF;
+	}
 }
 
 MixerImpl::~MixerImpl() {
+	// The callback is not running anymore; free the channels still queued.
+	processCommands();
+
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		delete _channels[i];
 }
@@ -194,10 +222,171 @@ uint MixerImpl::getOutputRate() const {
 	return _sampleRate;
 }
 
+bool MixerImpl::isChannelActive(int index) const {
+	const ChannelState &state = _channelStates[index];
+	return state.active && (uint32)Common::atomicLoad(&_finishedHandles[index]) != state.handle;
+}
+
+int MixerImpl::findChannel(SoundHandle handle) const {
+	const int index = handle._val % NUM_CHANNELS;
+	if (!isChannelActive(index) || _channelStates[index].handle != handle._val)
+		return -1;
+	return index;
+}
+
+int MixerImpl::getSoundTypeVolume(SoundType type) const {
+	const SoundTypeSettings &settings = _soundTypeSettings[type];
+	return settings.mute ? 0 : settings.volume;
+}
+
+void MixerImpl::pushCommand(CommandType type, int index, int value, Channel *channel) {
+	for (;;) {
+		const int32 head = _commandHead;
+		const int32 next = (head + 1) % COMMAND_QUEUE_SIZE;
+
+		if (next != Common::atomicLoad(&_commandTail)) {
+			Command &command = _commands[head];
+			command.type = type;
+			command.index = index;
+			command.handle = _channelStates[index].handle;
+			command.value = value;
+			command.channel = channel;
+			Common::atomicStore(&_commandHead, next);
+			return;
+		}
+
+		// The queue is full, so the callback is stalled or not called at
+		// all. Drain the queue ourselves unless it is running right now, or
+		// we are running inside it.
+		if (isConsumer()) {
+			processCommands();
+		} else if (beginConsuming()) {
+			processCommands();
+			endConsuming();
+		} else {
+			// The callback may be waiting for the lock to call us
+			_mutex.unlock();
+			g_system->delayMillis(1);
+			_mutex.lock();
+		}
+	}
+}
+
+void MixerImpl::stopChannel(int index) {
+	pushCommand(kCommandStop, index);
+	_channelStates[index].active = false;
+}
+
+void MixerImpl::notifySoundTypeChange(SoundType type) {
+	const int volume = getSoundTypeVolume(type);
+
+	for (int i = 0; i != NUM_CHANNELS; ++i) {
+		if (isChannelActive(i) && _channelStates[i].type == type)
+			pushCommand(kCommandSoundTypeVolume, i, volume);
+	}
+}
+
+void MixerImpl::waitForConsumer() {
+	// Callers may free a stream as soon as it is stopped. Any consumer
+	// starting from now on processes the stop command before it touches
+	// the stream, so we only need to wait for one which is already busy.
+	const int32 epoch = Common::atomicLoad(&_consumerEpoch);
+	if (!(epoch & 1) || isConsumer())
+		return;
+
+	while (Common::atomicLoad(&_consumerEpoch) == epoch)
+		g_system->delayMillis(1);
+}
+
+bool MixerImpl::isConsumer() const {
+#ifdef MIXER_THREAD_LOCAL
+	return s_consumer == this;
+#else
+	return false;
+#endif
+}
+
+bool MixerImpl::beginConsuming() {
+	const int32 epoch = Common::atomicLoad(&_consumerEpoch);
+	if ((epoch & 1) || !Common::atomicCompareAndSwap(&_consumerEpoch, epoch, epoch + 1))
+		return false;
+
+#ifdef MIXER_THREAD_LOCAL
+	s_consumer = this;
+#endif
+	return true;
+}
+
+void MixerImpl::endConsuming() {
+#ifdef MIXER_THREAD_LOCAL
+	s_consumer = 0;
+#endif
+	Common::atomicAdd(&_consumerEpoch, 1);
+}
+
+void MixerImpl::processCommands() {
+	const int32 head = Common::atomicLoad(&_commandHead);
+	int32 tail = _commandTail;
+
+	for (; tail != head; tail = (tail + 1) % COMMAND_QUEUE_SIZE) {
+		const Command &command = _commands[tail];
+		Channel *&chan = _channels[command.index];
+
+		if (command.type == kCommandPlay) {
+			// The slot is only reused after the previous channel finished
+			// or was stopped by an earlier command.
+			assert(!chan);
+			chan = command.channel;
+			publishTiming(command.index);
+			continue;
+		}
+
+		// Ignore commands for channels which already finished playing
+		if (!chan || chan->getHandle()._val != command.handle)
+			continue;
+
+		switch (command.type) {
+		case kCommandStop:
+			// A stream being mixed may have stopped its own channel
+			if (_mixing)
+				_stoppedChannels.push_back(chan);
+			else
+				delete chan;
+			chan = 0;
+			break;
+		case kCommandPause:
+			chan->pause(command.value != 0);
+			publishTiming(command.index);
+			break;
+		case kCommandVolume:
+			chan->setVolume(command.value);
+			break;
+		case kCommandBalance:
+			chan->setBalance(command.value);
+			break;
+		case kCommandSoundTypeVolume:
+			chan->setSoundTypeVolume(command.value);
+			break;
+		default:
+			break;
+		}
+	}
+
+	Common::atomicStore(&_commandTail, tail);
+}
+
+void MixerImpl::publishTiming(int index) {
+	ChannelTiming &timing = _channelTimings[index];
+
+	Common::atomicAdd(&timing.sequence, 1);
+	_channels[index]->getTiming(timing);
+	Common::atomicAdd(&timing.sequence, 1);
+}
+
 void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 	int index = -1;
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] == 0) {
+		if (!isChannelActive(i)) {
 			index = i;
 			break;
 		}
@@ -208,8 +397,6 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 		return;
 	}
 
-	_channels[index] = chan;
-
 	SoundHandle chanHandle;
 	chanHandle._val = index + (_handleSeed * NUM_CHANNELS);
 
@@ -217,6 +404,17 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 	_handleSeed++;
 	if (handle)
 		*handle = chanHandle;
+
+	ChannelState &state = _channelStates[index];
+	state.active = true;
+	state.handle = chanHandle._val;
+	state.id = chan->getId();
+	state.type = chan->getType();
+	state.permanent = chan->isPermanent();
+	state.volume = chan->getVolume();
+	state.balance = chan->getBalance();
+
+	pushCommand(kCommandPlay, index, 0, chan);
 }
 
 void MixerImpl::playStream(
@@ -240,7 +438,7 @@ void MixerImpl::playStream(
 	// Prevent duplicate sounds
 	if (id != -1) {
 		for (int i = 0; i != NUM_CHANNELS; i++)
-			if (_channels[i] != 0 && _channels[i]->getId() == id) {
+			if (isChannelActive(i) && _channelStates[i].id == id) {
 				// Delete the stream if were asked to auto-dispose it.
 				// Note: This could cause trouble if the client code does not
 				// yet expect the stream to be gone. The primary example to
@@ -259,6 +457,7 @@ void MixerImpl::playStream(
 
 	// Create the channel
 	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent);
+	chan->setSoundTypeVolume(getSoundTypeVolume(type));
 	chan->setVolume(volume);
 	chan->setBalance(balance);
 	insertChannel(handle, chan);
@@ -267,7 +466,7 @@ void MixerImpl::playStream(
 int MixerImpl::mixCallback(byte *samples, uint len) {
 	assert(samples);
 
-	Common::StackLock lock(_mutex);
+	Common::BenchmarkScope benchmark(Common::Benchmark::kCategoryAudio);
 
 	int16 *buf = (int16 *)samples;
 	// we store stereo, 16-bit samples
@@ -280,64 +479,86 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	//  zero the buf
 	memset(buf, 0, 2 * len * sizeof(int16));
 
+	if (!beginConsuming())
+		return 0;
+
+	processCommands();
+
 	// mix all channels
 	int res = 0, tmp;
+	_mixing = true;
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		if (_channels[i]) {
 			if (_channels[i]->isFinished()) {
+				const uint32 handle = _channels[i]->getHandle()._val;
 				delete _channels[i];
 				_channels[i] = 0;
+				Common::atomicStore(&_finishedHandles[i], (int32)handle);
 			} else if (!_channels[i]->isPaused()) {
 				tmp = _channels[i]->mix(buf, len);
 
+				// The stream may have stopped its channel meanwhile
+				if (_channels[i])
+					publishTiming(i);
+
 				if (tmp > res)
 					res = tmp;
 			}
 		}
+	_mixing = false;
+
+	// Keep the storage, so the callback doesn't allocate next time
+	for (uint i = 0; i < _stoppedChannels.size(); i++)
+		delete _stoppedChannels[i];
+	_stoppedChannels.resize(0);
+
+	endConsuming();
 
 	return res;
 }
 
 void MixerImpl::stopAll() {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && !_channels[i]->isPermanent()) {
-			delete _channels[i];
-			_channels[i] = 0;
+	{
+		Common::StackLock lock(_mutex);
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (isChannelActive(i) && !_channelStates[i].permanent)
+				stopChannel(i);
 		}
 	}
+	waitForConsumer();
 }
 
 void MixerImpl::stopID(int id) {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && _channels[i]->getId() == id) {
-			delete _channels[i];
-			_channels[i] = 0;
+	{
+		Common::StackLock lock(_mutex);
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (isChannelActive(i) && _channelStates[i].id == id)
+				stopChannel(i);
 		}
 	}
+	waitForConsumer();
 }
 
 void MixerImpl::stopHandle(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
+	{
+		Common::StackLock lock(_mutex);
 
-	// Simply ignore stop requests for handles of sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
+		// Simply ignore stop requests for handles of sounds that already terminated
+		const int index = findChannel(handle);
+		if (index == -1)
+			return;
 
-	delete _channels[index];
-	_channels[index] = 0;
+		stopChannel(index);
+	}
+	waitForConsumer();
 }
 
 void MixerImpl::muteSoundType(SoundType type, bool mute) {
 	assert(0 <= type && type < ARRAYSIZE(_soundTypeSettings));
-	_soundTypeSettings[type].mute = mute;
 
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
-	}
+	Common::StackLock lock(_mutex);
+	_soundTypeSettings[type].mute = mute;
+	notifySoundTypeChange(type);
 }
 
 bool MixerImpl::isSoundTypeMuted(SoundType type) const {
@@ -348,37 +569,43 @@ bool MixerImpl::isSoundTypeMuted(SoundType type) const {
 void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
 	Common::StackLock lock(_mutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findChannel(handle);
+	if (index == -1)
 		return;
 
-	_channels[index]->setVolume(volume);
+	_channelStates[index].volume = volume;
+	pushCommand(kCommandVolume, index, volume);
 }
 
 byte MixerImpl::getChannelVolume(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Common::StackLock lock(_mutex);
+
+	const int index = findChannel(handle);
+	if (index == -1)
 		return 0;
 
-	return _channels[index]->getVolume();
+	return _channelStates[index].volume;
 }
 
 void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
 	Common::StackLock lock(_mutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findChannel(handle);
+	if (index == -1)
 		return;
 
-	_channels[index]->setBalance(balance);
+	_channelStates[index].balance = balance;
+	pushCommand(kCommandBalance, index, balance);
 }
 
 int8 MixerImpl::getChannelBalance(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Common::StackLock lock(_mutex);
+
+	const int index = findChannel(handle);
+	if (index == -1)
 		return 0;
 
-	return _channels[index]->getBalance();
+	return _channelStates[index].balance;
 }
 
 uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
@@ -386,29 +613,67 @@ uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
 }
 
 Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
+	Audio::Timestamp ts(0, _sampleRate);
+
+	ChannelTiming timing;
+	{
+		Common::StackLock lock(_mutex);
+
+		const int index = findChannel(handle);
+		if (index == -1)
+			return ts;
+
+		// Retry if the callback updated the timing while we copied it
+		const ChannelTiming &shared = _channelTimings[index];
+		int32 sequence;
+		do {
+			sequence = Common::atomicLoad(&shared.sequence);
+			timing.handle = shared.handle;
+			timing.samplesConsumed = shared.samplesConsumed;
+			timing.mixerTimeStamp = shared.mixerTimeStamp;
+			timing.pauseStartTime = shared.pauseStartTime;
+			timing.pauseTime = shared.pauseTime;
+			timing.paused = shared.paused;
+		} while ((sequence & 1) || Common::atomicLoad(&shared.sequence) != sequence);
+	}
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return Timestamp(0, _sampleRate);
+	// The callback did not pick up the channel yet
+	if (timing.handle != handle._val || timing.mixerTimeStamp == 0)
+		return ts;
+
+	uint32 delta = 0;
+	if (timing.paused)
+		delta = timing.pauseStartTime - timing.mixerTimeStamp;
+	else
+		delta = g_system->getMillis() - timing.mixerTimeStamp - timing.pauseTime;
+
+	// Convert the number of samples into a time duration.
+
+	ts = ts.addFrames(timing.samplesConsumed);
+	ts = ts.addMsecs(delta);
+
+	// In theory it would seem like a good idea to limit the approximation
+	// so that it never exceeds the theoretical upper bound set by
+	// _samplesDecoded. Meanwhile, back in the real world, doing so makes
+	// the Broken Sword cutscenes noticeably jerkier. I guess the mixer
+	// isn't invoked at the regular intervals that I first imagined.
 
-	return _channels[index]->getElapsedTime();
+	return ts;
 }
 
 void MixerImpl::pauseAll(bool paused) {
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0) {
-			_channels[i]->pause(paused);
-		}
+		if (isChannelActive(i))
+			pushCommand(kCommandPause, i, paused);
 	}
 }
 
 void MixerImpl::pauseID(int id, bool paused) {
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && _channels[i]->getId() == id) {
-			_channels[i]->pause(paused);
+		if (isChannelActive(i) && _channelStates[i].id == id) {
+			pushCommand(kCommandPause, i, paused);
 			return;
 		}
 	}
@@ -418,39 +683,38 @@ void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
 	Common::StackLock lock(_mutex);
 
 	// Simply ignore (un)pause requests for sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findChannel(handle);
+	if (index == -1)
 		return;
 
-	_channels[index]->pause(paused);
+	pushCommand(kCommandPause, index, paused);
 }
 
 bool MixerImpl::isSoundIDActive(int id) {
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getId() == id)
+		if (isChannelActive(i) && _channelStates[i].id == id)
 			return true;
 	return false;
 }
 
 int MixerImpl::getSoundID(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
-	const int index = handle._val % NUM_CHANNELS;
-	if (_channels[index] && _channels[index]->getHandle()._val == handle._val)
-		return _channels[index]->getId();
+	const int index = findChannel(handle);
+	if (index != -1)
+		return _channelStates[index].id;
 	return 0;
 }
 
 bool MixerImpl::isSoundHandleActive(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
-	const int index = handle._val % NUM_CHANNELS;
-	return _channels[index] && _channels[index]->getHandle()._val == handle._val;
+	return findChannel(handle) != -1;
 }
 
 bool MixerImpl::hasActiveChannelOfType(SoundType type) {
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getType() == type)
+		if (isChannelActive(i) && _channelStates[i].type == type)
 			return true;
 	return false;
 }
@@ -469,11 +733,7 @@ void MixerImpl::setVolumeForSoundType(SoundType type, int volume) {
 
 	Common::StackLock lock(_mutex);
 	_soundTypeSettings[type].volume = volume;
-
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
-	}
+	notifySoundTypeChange(type);
 }
 
 int MixerImpl::getVolumeForSoundType(SoundType type) const {
@@ -490,7 +750,7 @@ int MixerImpl::getVolumeForSoundType(SoundType type) const {
 Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
                  DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent)
     : _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume),
-      _balance(0), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
+      _balance(0), _soundTypeVolume(Mixer::kMaxMixerVolume), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
       _pauseStartTime(0), _pauseTime(0), _converter(0), _volL(0), _volR(0),
       _stream(stream, autofreeStream) {
 	assert(mixer);
@@ -522,6 +782,11 @@ int8 Channel::getBalance() {
 	return _balance;
 }
 
+void Channel::setSoundTypeVolume(int volume) {
+	_soundTypeVolume = volume;
+	updateChannelVolumes();
+}
+
 void Channel::updateChannelVolumes() {
 	// From the channel balance/volume and the global volume, we compute
 	// the effective volume for the left and right channel. Note the
@@ -531,21 +796,17 @@ void Channel::updateChannelVolumes() {
 	// volume is in the range 0 - kMaxMixerVolume.
 	// Hence, the vol_l/vol_r values will be in that range, too
 
-	if (!_mixer->isSoundTypeMuted(_type)) {
-		int vol = _mixer->getVolumeForSoundType(_type) * _volume;
+	int vol = _soundTypeVolume * _volume;
 
-		if (_balance == 0) {
-			_volL = vol / Mixer::kMaxChannelVolume;
-			_volR = vol / Mixer::kMaxChannelVolume;
-		} else if (_balance < 0) {
-			_volL = vol / Mixer::kMaxChannelVolume;
-			_volR = ((127 + _balance) * vol) / (Mixer::kMaxChannelVolume * 127);
-		} else {
-			_volL = ((127 - _balance) * vol) / (Mixer::kMaxChannelVolume * 127);
-			_volR = vol / Mixer::kMaxChannelVolume;
-		}
+	if (_balance == 0) {
+		_volL = vol / Mixer::kMaxChannelVolume;
+		_volR = vol / Mixer::kMaxChannelVolume;
+	} else if (_balance < 0) {
+		_volL = vol / Mixer::kMaxChannelVolume;
+		_volR = ((127 + _balance) * vol) / (Mixer::kMaxChannelVolume * 127);
 	} else {
-		_volL = _volR = 0;
+		_volL = ((127 - _balance) * vol) / (Mixer::kMaxChannelVolume * 127);
+		_volR = vol / Mixer::kMaxChannelVolume;
 	}
 }
 
@@ -567,32 +828,13 @@ void Channel::pause(bool paused) {
 	}
 }
 
-Timestamp Channel::getElapsedTime() {
-	const uint32 rate = _mixer->getOutputRate();
-	uint32 delta = 0;
-
-	Audio::Timestamp ts(0, rate);
-
-	if (_mixerTimeStamp == 0)
-		return ts;
-
-	if (isPaused())
-		delta = _pauseStartTime - _mixerTimeStamp;
-	else
-		delta = g_system->getMillis() - _mixerTimeStamp - _pauseTime;
-
-	// Convert the number of samples into a time duration.
-
-	ts = ts.addFrames(_samplesConsumed);
-	ts = ts.addMsecs(delta);
-
-	// In theory it would seem like a good idea to limit the approximation
-	// so that it never exceeds the theoretical upper bound set by
-	// _samplesDecoded. Meanwhile, back in the real world, doing so makes
-	// the Broken Sword cutscenes noticeably jerkier. I guess the mixer
-	// isn't invoked at the regular intervals that I first imagined.
-
-	return ts;
+void Channel::getTiming(MixerImpl::ChannelTiming &timing) const {
+	timing.handle = _handle._val;
+	timing.samplesConsumed = _samplesConsumed;
+	timing.mixerTimeStamp = _mixerTimeStamp;
+	timing.pauseStartTime = _pauseStartTime;
+	timing.pauseTime = _pauseTime;
+	timing.paused = isPaused();
 }
 
 int Channel::mix(int16 *data, uint len) {
@@ -24,8 +24,10 @@
 #define AUDIO_MIXER_INTERN_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
 #include "common/mutex.h"
 #include "audio/mixer.h"
+#include "audio/timestamp.h"
 
 namespace Audio {
 
@@ -46,14 +48,23 @@ namespace Audio {
  * (partial) alternative implementations of the mixer, e.g. to make
  * better use of native sound mixing support on low-end devices.
  *
+ * The mixer callback never waits for the other mixer methods: they keep
+ * their own view of the channels (guarded by _mutex, which the callback
+ * does not take) and hand every change to the callback through a
+ * single-producer/single-consumer command queue, which it drains at the
+ * start of each buffer. Only the callback touches the Channel objects once
+ * they are queued for playing.
+ *
  * @see OSystem::getMixer()
  */
 class MixerImpl : public Mixer {
 private:
 	enum {
-		NUM_CHANNELS = 16
+		NUM_CHANNELS = 16,
+		COMMAND_QUEUE_SIZE = 256
 	};
 
+	/** Serializes the callers of the mixer methods, but not the callback. */
 	Common::Mutex _mutex;
 
 	const uint _sampleRate;
@@ -68,8 +79,84 @@ private:
 	};
 
 	SoundTypeSettings _soundTypeSettings[4];
+
+	/** The view the mixer methods have of a channel. */
+	struct ChannelState {
+		ChannelState() : active(false), handle(0xFFFFFFFF), id(-1), type(kPlainSoundType), permanent(false), volume(kMaxChannelVolume), balance(0) {}
+
+		bool active;
+		uint32 handle;
+		int id;
+		SoundType type;
+		bool permanent;
+		byte volume;
+		int8 balance;
+	};
+
+	ChannelState _channelStates[NUM_CHANNELS];
+
+	/**
+	 * The handle of the last channel in each slot which the callback found
+	 * to have finished playing on its own.
+	 */
+	volatile int32 _finishedHandles[NUM_CHANNELS];
+
+	enum CommandType {
+		kCommandPlay,
+		kCommandStop,
+		kCommandPause,
+		kCommandVolume,
+		kCommandBalance,
+		kCommandSoundTypeVolume
+	};
+
+	struct Command {
+		CommandType type;
+		int index;
+		uint32 handle;
+		int value;
+		Channel *channel;
+	};
+
+	Command _commands[COMMAND_QUEUE_SIZE];
+	volatile int32 _commandHead;	///< next entry to write, only written by the mixer methods
+	volatile int32 _commandTail;	///< next entry to read, only written by the consumer
+
+	/**
+	 * Odd while the command queue and the channels are being accessed by
+	 * their consumer: usually the mixer callback, or a mixer method which
+	 * found the queue full while the callback was not running.
+	 */
+	volatile int32 _consumerEpoch;
+
+public:
+	/**
+	 * The playing position of a channel, published by the consumer for
+	 * getElapsedTime(). The sequence counter is odd while it is updated.
+	 */
+	struct ChannelTiming {
+		volatile int32 sequence;
+		uint32 handle;
+		uint32 samplesConsumed;
+		uint32 mixerTimeStamp;
+		uint32 pauseStartTime;
+		uint32 pauseTime;
+		bool paused;
+	};
+
+private:
+	ChannelTiming _channelTimings[NUM_CHANNELS];
+
+	/** Only accessed by the consumer. */
 	Channel *_channels[NUM_CHANNELS];
 
+	/**
+	 * Channels stopped while mixing, which may still be on the stack.
+	 * They are deleted once all channels are mixed. Only accessed by the
+	 * consumer.
+	 */
+	Common::Array<Channel *> _stoppedChannels;
+	bool _mixing;
 
 public:
 
@@ -121,11 +208,38 @@ public:
 protected:
 	void insertChannel(SoundHandle *handle, Channel *chan);
 
+private:
+	// The following methods must be called with _mutex held.
+	bool isChannelActive(int index) const;
+	int findChannel(SoundHandle handle) const;
+	int getSoundTypeVolume(SoundType type) const;
+	void pushCommand(CommandType type, int index, int value = 0, Channel *channel = 0);
+	void stopChannel(int index);
+	void notifySoundTypeChange(SoundType type);
+
+	/**
+	 * Wait until the consumer has processed the commands queued so far.
+	 * Must be called without _mutex held, as the consumer may be waiting
+	 * for it, and returns at once when called by the consumer itself.
+	 */
+	void waitForConsumer();
+
+	/** Whether this thread is running the consumer right now. */
+	bool isConsumer() const;
+
+	// The following methods are only used by the consumer.
+	bool beginConsuming();
+	void endConsuming();
+	void processCommands();
+	void publishTiming(int index);
+
 public:
 	/**
 	 * The mixer callback function, to be called at regular intervals by
 	 * the backend (e.g. from an audio mixing thread). All the actual mixing
-	 * work is done from here.
+	 * work is done from here. It never blocks; in the rare case that a mixer
+	 * method is draining a full command queue at the same time, the buffer
+	 * is filled with silence instead.
 	 *
 	 * @param samples Sample buffer, in which stereo 16-bit samples will be stored.
 	 * @param len Length of the provided buffer to fill (in bytes, should be divisible by 4).
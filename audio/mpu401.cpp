@@ -20,6 +20,7 @@
  */
 
 #include "audio/mpu401.h"
+#include "common/config-manager.h"
 #include "common/system.h"
 #include "common/timer.h"
 #include "common/util.h"	// for ARRAYSIZE
@@ -145,7 +146,14 @@ void MidiDriver_MPU401::setTimerCallback(void *timer_param, Common::TimerManager
 		if (_timer_proc)
 			g_system->getTimerManager()->removeTimerProc(_timer_proc);
 		_timer_proc = timer_proc;
-		if (timer_proc)
+		if (!timer_proc)
+			return;
+
+		// A thread of its own keeps the MIDI timing steady while handler()
+		// is busy, but is only used when the user asks for it.
+		if (ConfMan.getBool("midi_timer_thread"))
+			g_system->getTimerManager()->installDedicatedTimerProc(timer_proc, 10000, timer_param, "MPU401");
+		else
 			g_system->getTimerManager()->installTimerProc(timer_proc, 10000, timer_param, "MPU401");
 	}
 }
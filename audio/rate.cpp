@@ -30,6 +30,7 @@
 
 #include "audio/audiostream.h"
 #include "audio/rate.h"
+#include "audio/rate_mix.h"
 #include "audio/mixer.h"
 #include "common/frac.h"
 #include "common/textconsole.h"
@@ -67,6 +68,12 @@ protected:
 	/** fractional position increment in the output stream */
 	long opos_inc;
 
+	/** resampled sample pairs, waiting to be mixed into the output */
+	st_sample_t mixBuf[INTERMEDIATE_BUFFER_SIZE];
+	MixProc mix;
+
+	st_size_t fill(AudioStream &input, st_sample_t *obuf, st_size_t osamp);
+
 public:
 	SimpleRateConverter(st_rate_t inrate, st_rate_t outrate);
 	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
@@ -95,14 +102,17 @@ SimpleRateConverter<stereo, reverseStereo>::SimpleRateConverter(st_rate_t inrate
 	opos_inc = inrate / outrate;
 
 	inLen = 0;
+
+	mix = getMixProc(true, reverseStereo);
 }
 
 /*
- * Processed signed long samples from ibuf to obuf.
- * Return number of sample pairs processed.
+ * Resample up to osamp sample pairs from the input into obuf.
+ * Return number of sample pairs written, which is less than osamp
+ * only when the input ran dry.
  */
 template<bool stereo, bool reverseStereo>
-int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+st_size_t SimpleRateConverter<stereo, reverseStereo>::fill(AudioStream &input, st_sample_t *obuf, st_size_t osamp) {
 	st_sample_t *ostart, *oend;
 
 	ostart = obuf;
@@ -133,15 +143,31 @@ int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 		// Increment output position
 		opos += opos_inc;
 
-		// output left channel
-		clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+		*obuf++ = out0;
+		*obuf++ = out1;
+	}
+	return osamp;
+}
+
+/*
+ * Processed signed long samples from ibuf to obuf.
+ * Return number of sample pairs processed.
+ */
+template<bool stereo, bool reverseStereo>
+int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	st_size_t done = 0;
+
+	while (done < osamp) {
+		const st_size_t chunk = MIN<st_size_t>(osamp - done, ARRAYSIZE(mixBuf) / 2);
+		const st_size_t len = fill(input, mixBuf, chunk);
 
-		// output right channel
-		clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+		mix(mixBuf, obuf + done * 2, len, vol_l, vol_r);
+		done += len;
 
-		obuf += 2;
+		if (len < chunk)
+			break;
 	}
-	return (obuf - ostart) / 2;
+	return done;
 }
 
 /**
@@ -173,6 +199,12 @@ protected:
 	/** current sample(s) in the input stream (left/right channel) */
 	st_sample_t icur0, icur1;
 
+	/** interpolated sample pairs, waiting to be mixed into the output */
+	st_sample_t mixBuf[INTERMEDIATE_BUFFER_SIZE];
+	MixProc mix;
+
+	st_size_t fill(AudioStream &input, st_sample_t *obuf, st_size_t osamp);
+
 public:
 	LinearRateConverter(st_rate_t inrate, st_rate_t outrate);
 	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
@@ -204,14 +236,17 @@ LinearRateConverter<stereo, reverseStereo>::LinearRateConverter(st_rate_t inrate
 	icur0 = icur1 = 0;
 
 	inLen = 0;
+
+	mix = getMixProc(true, reverseStereo);
 }
 
 /*
- * Processed signed long samples from ibuf to obuf.
- * Return number of sample pairs processed.
+ * Interpolate up to osamp sample pairs from the input into obuf.
+ * Return number of sample pairs written, which is less than osamp
+ * only when the input ran dry.
  */
 template<bool stereo, bool reverseStereo>
-int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+st_size_t LinearRateConverter<stereo, reverseStereo>::fill(AudioStream &input, st_sample_t *obuf, st_size_t osamp) {
 	st_sample_t *ostart, *oend;
 
 	ostart = obuf;
@@ -248,19 +283,35 @@ int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 						  (st_sample_t)(ilast1 + (((icur1 - ilast1) * opos + FRAC_HALF) >> FRAC_BITS)) :
 						  out0);
 
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
-
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
-
-			obuf += 2;
+			*obuf++ = out0;
+			*obuf++ = out1;
 
 			// Increment output position
 			opos += opos_inc;
 		}
 	}
-	return (obuf - ostart) / 2;
+	return osamp;
+}
+
+/*
+ * Processed signed long samples from ibuf to obuf.
+ * Return number of sample pairs processed.
+ */
+template<bool stereo, bool reverseStereo>
+int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	st_size_t done = 0;
+
+	while (done < osamp) {
+		const st_size_t chunk = MIN<st_size_t>(osamp - done, ARRAYSIZE(mixBuf) / 2);
+		const st_size_t len = fill(input, mixBuf, chunk);
+
+		mix(mixBuf, obuf + done * 2, len, vol_l, vol_r);
+		done += len;
+
+		if (len < chunk)
+			break;
+	}
+	return done;
 }
 
 
@@ -274,8 +325,9 @@ template<bool stereo, bool reverseStereo>
 class CopyRateConverter : public RateConverter {
 	st_sample_t *_buffer;
 	st_size_t _bufferSize;
+	MixProc _mix;
 public:
-	CopyRateConverter() : _buffer(0), _bufferSize(0) {}
+	CopyRateConverter() : _buffer(0), _bufferSize(0), _mix(getMixProc(stereo, reverseStereo)) {}
 	~CopyRateConverter() {
 		free(_buffer);
 	}
@@ -283,11 +335,8 @@ public:
 	virtual int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
 		assert(input.isStereo() == stereo);
 
-		st_sample_t *ptr;
 		st_size_t len;
 
-		st_sample_t *ostart = obuf;
-
 		if (stereo)
 			osamp *= 2;
 
@@ -305,21 +354,10 @@ public:
 		len = input.readBuffer(_buffer, osamp);
 
 		// Mix the data into the output buffer
-		ptr = _buffer;
-		for (; len > 0; len -= (stereo ? 2 : 1)) {
-			st_sample_t out0, out1;
-			out0 = *ptr++;
-			out1 = (stereo ? *ptr++ : out0);
-
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
-
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
-
-			obuf += 2;
-		}
-		return (obuf - ostart) / 2;
+		if (stereo)
+			len /= 2;
+		_mix(_buffer, obuf, len, vol_l, vol_r);
+		return len;
 	}
 
 	virtual int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
@@ -0,0 +1,304 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "audio/rate_mix.h"
+#include "audio/mixer.h"
+
+// The vector kernels implement the signed sample format only; the runtime
+// CPU check needs GCC 4.9 (or clang) to use target attributes on x86.
+#ifndef OUTPUT_UNSIGNED_AUDIO
+#if defined(__i386__) || defined(__x86_64__)
+#if defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+#define MIX_X86
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define MIX_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+namespace Audio {
+
+/**
+ * Reference implementation, also used for the tail of the buffers the
+ * vector kernels cannot process in full blocks.
+ */
+template<bool stereo, bool reverseStereo>
+static void mixScalar(const st_sample_t *in, st_sample_t *out, st_size_t len, st_volume_t vol_l, st_volume_t vol_r) {
+	for (; len > 0; len--) {
+		st_sample_t out0, out1;
+		out0 = *in++;
+		out1 = (stereo ? *in++ : out0);
+
+		// output left channel
+		clampedAdd(out[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+
+		// output right channel
+		clampedAdd(out[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+
+		out += 2;
+	}
+}
+
+static const MixProcs s_scalarProcs = {
+	&mixScalar<false, false>,
+	&mixScalar<true, false>,
+	&mixScalar<true, true>
+};
+
+#ifdef MIX_X86
+
+// All vector kernels share the same scheme: widen the 16x16 bit products to
+// 32 bits, bias negative products by 255 so the arithmetic shift by 8
+// rounds towards zero like the division in clampedAdd() does, narrow back
+// with signed saturation (the scaled value always fits for volumes up to
+// kMaxMixerVolume) and finally add to the output with saturation. Larger
+// volumes could overflow the products and are left to the scalar code.
+
+#define MIX_TARGET_SSE2 __attribute__((target("sse2")))
+#define MIX_TARGET_AVX2 __attribute__((target("avx2")))
+
+MIX_TARGET_SSE2 static inline __m128i scaleSSE2(__m128i s, __m128i vol) {
+	const __m128i lo = _mm_mullo_epi16(s, vol);
+	const __m128i hi = _mm_mulhi_epi16(s, vol);
+	__m128i p0 = _mm_unpacklo_epi16(lo, hi);
+	__m128i p1 = _mm_unpackhi_epi16(lo, hi);
+	const __m128i bias = _mm_set1_epi32(255);
+	p0 = _mm_srai_epi32(_mm_add_epi32(p0, _mm_and_si128(_mm_srai_epi32(p0, 31), bias)), 8);
+	p1 = _mm_srai_epi32(_mm_add_epi32(p1, _mm_and_si128(_mm_srai_epi32(p1, 31), bias)), 8);
+	return _mm_packs_epi32(p0, p1);
+}
+
+MIX_TARGET_SSE2 static inline void addSSE2(st_sample_t *out, __m128i s, __m128i vol) {
+	const __m128i o = _mm_loadu_si128((const __m128i *)out);
+	_mm_storeu_si128((__m128i *)out, _mm_adds_epi16(o, scaleSSE2(s, vol)));
+}
+
+template<bool stereo, bool reverseStereo>
+MIX_TARGET_SSE2 static void mixSSE2(const st_sample_t *in, st_sample_t *out, st_size_t len, st_volume_t vol_l, st_volume_t vol_r) {
+	if (vol_l > Audio::Mixer::kMaxMixerVolume || vol_r > Audio::Mixer::kMaxMixerVolume) {
+		mixScalar<stereo, reverseStereo>(in, out, len, vol_l, vol_r);
+		return;
+	}
+
+	// Swapping the input channels turns the reversed case into the plain
+	// one, provided the volumes are swapped as well.
+	const int16 v0 = reverseStereo ? vol_r : vol_l;
+	const int16 v1 = reverseStereo ? vol_l : vol_r;
+	const __m128i vol = _mm_set_epi16(v1, v0, v1, v0, v1, v0, v1, v0);
+
+	if (stereo) {
+		for (; len >= 4; len -= 4) {
+			__m128i s = _mm_loadu_si128((const __m128i *)in);
+			if (reverseStereo) {
+				s = _mm_shufflelo_epi16(s, 0xB1);
+				s = _mm_shufflehi_epi16(s, 0xB1);
+			}
+			addSSE2(out, s, vol);
+			in += 8;
+			out += 8;
+		}
+	} else {
+		for (; len >= 8; len -= 8) {
+			const __m128i s = _mm_loadu_si128((const __m128i *)in);
+			addSSE2(out, _mm_unpacklo_epi16(s, s), vol);
+			addSSE2(out + 8, _mm_unpackhi_epi16(s, s), vol);
+			in += 8;
+			out += 16;
+		}
+	}
+
+	mixScalar<stereo, reverseStereo>(in, out, len, vol_l, vol_r);
+}
+
+static const MixProcs s_sse2Procs = {
+	&mixSSE2<false, false>,
+	&mixSSE2<true, false>,
+	&mixSSE2<true, true>
+};
+
+MIX_TARGET_AVX2 static inline void addAVX2(st_sample_t *out, __m256i s, __m256i vol) {
+	// The unpack and pack instructions work within 128 bit lanes, so the
+	// sample order is preserved.
+	const __m256i lo = _mm256_mullo_epi16(s, vol);
+	const __m256i hi = _mm256_mulhi_epi16(s, vol);
+	__m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+	__m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+	const __m256i bias = _mm256_set1_epi32(255);
+	p0 = _mm256_srai_epi32(_mm256_add_epi32(p0, _mm256_and_si256(_mm256_srai_epi32(p0, 31), bias)), 8);
+	p1 = _mm256_srai_epi32(_mm256_add_epi32(p1, _mm256_and_si256(_mm256_srai_epi32(p1, 31), bias)), 8);
+
+	const __m256i o = _mm256_loadu_si256((const __m256i *)out);
+	_mm256_storeu_si256((__m256i *)out, _mm256_adds_epi16(o, _mm256_packs_epi32(p0, p1)));
+}
+
+template<bool stereo, bool reverseStereo>
+MIX_TARGET_AVX2 static void mixAVX2(const st_sample_t *in, st_sample_t *out, st_size_t len, st_volume_t vol_l, st_volume_t vol_r) {
+	if (vol_l > Audio::Mixer::kMaxMixerVolume || vol_r > Audio::Mixer::kMaxMixerVolume) {
+		mixScalar<stereo, reverseStereo>(in, out, len, vol_l, vol_r);
+		return;
+	}
+
+	const int16 v0 = reverseStereo ? vol_r : vol_l;
+	const int16 v1 = reverseStereo ? vol_l : vol_r;
+	const __m256i vol = _mm256_set_epi16(v1, v0, v1, v0, v1, v0, v1, v0, v1, v0, v1, v0, v1, v0, v1, v0);
+
+	if (stereo) {
+		for (; len >= 8; len -= 8) {
+			__m256i s = _mm256_loadu_si256((const __m256i *)in);
+			if (reverseStereo) {
+				s = _mm256_shufflelo_epi16(s, 0xB1);
+				s = _mm256_shufflehi_epi16(s, 0xB1);
+			}
+			addAVX2(out, s, vol);
+			in += 16;
+			out += 16;
+		}
+	} else {
+		for (; len >= 8; len -= 8) {
+			const __m128i s = _mm_loadu_si128((const __m128i *)in);
+			const __m256i d = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_unpacklo_epi16(s, s)), _mm_unpackhi_epi16(s, s), 1);
+			addAVX2(out, d, vol);
+			in += 8;
+			out += 16;
+		}
+	}
+
+	mixScalar<stereo, reverseStereo>(in, out, len, vol_l, vol_r);
+}
+
+static const MixProcs s_avx2Procs = {
+	&mixAVX2<false, false>,
+	&mixAVX2<true, false>,
+	&mixAVX2<true, true>
+};
+
+static bool hasCPUFeature(MixImplementation impl) {
+	__builtin_cpu_init();
+	if (impl == kMixSSE2)
+		return __builtin_cpu_supports("sse2");
+	else
+		return __builtin_cpu_supports("avx2");
+}
+
+#endif // MIX_X86
+
+#ifdef MIX_NEON
+
+// See the x86 kernels above for a description of the arithmetic.
+
+static inline void addNEON(st_sample_t *out, int16x8_t s, int16x8_t vol) {
+	int32x4_t p0 = vmull_s16(vget_low_s16(s), vget_low_s16(vol));
+	int32x4_t p1 = vmull_s16(vget_high_s16(s), vget_high_s16(vol));
+	p0 = vaddq_s32(p0, vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(p0, 31)), 24)));
+	p1 = vaddq_s32(p1, vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(p1, 31)), 24)));
+	const int16x8_t scaled = vcombine_s16(vqmovn_s32(vshrq_n_s32(p0, 8)), vqmovn_s32(vshrq_n_s32(p1, 8)));
+	vst1q_s16(out, vqaddq_s16(vld1q_s16(out), scaled));
+}
+
+template<bool stereo, bool reverseStereo>
+static void mixNEON(const st_sample_t *in, st_sample_t *out, st_size_t len, st_volume_t vol_l, st_volume_t vol_r) {
+	if (vol_l > Audio::Mixer::kMaxMixerVolume || vol_r > Audio::Mixer::kMaxMixerVolume) {
+		mixScalar<stereo, reverseStereo>(in, out, len, vol_l, vol_r);
+		return;
+	}
+
+	const int16 v0 = reverseStereo ? vol_r : vol_l;
+	const int16 v1 = reverseStereo ? vol_l : vol_r;
+	const int16 volumes[8] = { v0, v1, v0, v1, v0, v1, v0, v1 };
+	const int16x8_t vol = vld1q_s16(volumes);
+
+	if (stereo) {
+		for (; len >= 4; len -= 4) {
+			int16x8_t s = vld1q_s16(in);
+			if (reverseStereo)
+				s = vrev32q_s16(s);
+			addNEON(out, s, vol);
+			in += 8;
+			out += 8;
+		}
+	} else {
+		for (; len >= 8; len -= 8) {
+			const int16x8_t s = vld1q_s16(in);
+			const int16x8x2_t d = vzipq_s16(s, s);
+			addNEON(out, d.val[0], vol);
+			addNEON(out + 8, d.val[1], vol);
+			in += 8;
+			out += 16;
+		}
+	}
+
+	mixScalar<stereo, reverseStereo>(in, out, len, vol_l, vol_r);
+}
+
+static const MixProcs s_neonProcs = {
+	&mixNEON<false, false>,
+	&mixNEON<true, false>,
+	&mixNEON<true, true>
+};
+
+#endif // MIX_NEON
+
+const MixProcs *getMixProcs(MixImplementation impl) {
+	switch (impl) {
+	case kMixScalar:
+		return &s_scalarProcs;
+#ifdef MIX_X86
+	case kMixSSE2:
+		return hasCPUFeature(kMixSSE2) ? &s_sse2Procs : 0;
+	case kMixAVX2:
+		return hasCPUFeature(kMixAVX2) ? &s_avx2Procs : 0;
+#endif
+#ifdef MIX_NEON
+	case kMixNEON:
+		return &s_neonProcs;
+#endif
+	case kMixAuto: {
+		const MixProcs *procs = 0;
+		for (int i = kMixAuto - 1; i >= kMixScalar && !procs; i--)
+			procs = getMixProcs((MixImplementation)i);
+		return procs;
+	}
+	default:
+		return 0;
+	}
+}
+
+static const MixProcs *s_selectedProcs = 0;
+
+const MixProcs &getMixProcs() {
+	if (!s_selectedProcs)
+		s_selectedProcs = getMixProcs(kMixAuto);
+	return *s_selectedProcs;
+}
+
+bool selectMixImplementation(MixImplementation impl) {
+	const MixProcs *procs = getMixProcs(impl);
+	if (!procs)
+		return false;
+
+	s_selectedProcs = procs;
+	return true;
+}
+
+} // End of namespace Audio
@@ -0,0 +1,88 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef AUDIO_RATE_MIX_H
+#define AUDIO_RATE_MIX_H
+
+#include "audio/rate.h"
+
+namespace Audio {
+
+/**
+ * Mix 'len' sample frames from 'in' into the interleaved stereo buffer
+ * 'out': every input sample is scaled by the channel volume (divided by
+ * Mixer::kMaxMixerVolume, rounding towards zero) and added to the output
+ * with saturation, exactly like clampedAdd() does.
+ *
+ * Depending on the variant, 'in' holds mono samples (which are sent to
+ * both output channels), interleaved stereo samples, or interleaved stereo
+ * samples whose channels are swapped on output.
+ */
+typedef void (*MixProc)(const st_sample_t *in, st_sample_t *out, st_size_t len, st_volume_t vol_l, st_volume_t vol_r);
+
+struct MixProcs {
+	MixProc mono;
+	MixProc stereo;
+	MixProc stereoReverse;
+};
+
+enum MixImplementation {
+	kMixScalar = 0,
+	kMixSSE2,
+	kMixAVX2,
+	kMixNEON,
+	kMixAuto
+};
+
+/**
+ * Return the mix kernels of the given implementation, or 0 if it is not
+ * compiled in or not supported by the CPU we are running on.
+ */
+const MixProcs *getMixProcs(MixImplementation impl);
+
+/**
+ * Return the mix kernels to be used by the rate converters. Unless
+ * overridden by selectMixImplementation(), this is the fastest one
+ * supported by the CPU.
+ */
+const MixProcs &getMixProcs();
+
+/**
+ * Override the automatic choice of the mix kernels. Used by the unit
+ * tests; rate converters pick up the change when they are created.
+ * @return false if the requested implementation is not available
+ */
+bool selectMixImplementation(MixImplementation impl);
+
+/**
+ * Return the mix kernel for the given channel layout from getMixProcs().
+ */
+inline MixProc getMixProc(bool stereo, bool reverseStereo) {
+	const MixProcs &procs = getMixProcs();
+	if (!stereo)
+		return procs.mono;
+	return reverseStereo ? procs.stereoReverse : procs.stereo;
+}
+
+} // End of namespace Audio
+
+#endif
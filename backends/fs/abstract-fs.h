@@ -158,6 +158,16 @@ public:
 	 */
 	virtual bool isWritable() const = 0;
 
+	/**
+	 * Retrieves the size and the time of the last modification of the file
+	 * referred by this node. The time is only meant to be compared against
+	 * an earlier value, to find out whether the file has changed.
+	 *
+	 * @note By default, this method returns false, i.e. no status is available.
+	 *
+	 * @return true if the status could be determined, false otherwise.
+	 */
+	virtual bool getFileStatus(int32 &size, uint32 &modificationTime) const { return false; }
 
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
@@ -27,6 +27,7 @@
 #include "backends/graphics/surfacesdl/surfacesdl-graphics.h"
 #include "backends/events/sdl/sdl-events.h"
 #include "backends/platform/sdl/sdl.h"
+#include "common/benchmark.h"
 #include "common/config-manager.h"
 #include "common/mutex.h"
 #include "common/textconsole.h"
@@ -225,6 +226,8 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 	_paletteDirtyStart(0), _paletteDirtyEnd(0),
 	_screenIsLocked(false),
 	_graphicsMutex(0),
+	_scalerMutex(0), _scalerWorkCond(0), _scalerDoneCond(0), _scalerThreadsShouldQuit(false),
+	_scalerTasksNext(0), _scalerTasksDone(0),
 #ifdef USE_SDL_DEBUG_FOCUSRECT
 	_enableFocusRectDebugCode(false), _enableFocusRect(false), _focusRect(),
 #endif
@@ -278,6 +281,8 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 #else
 	_videoMode.fullscreen = true;
 #endif
+
+	startScalerThreads(ConfMan.getInt("scaler_threads"));
 }
 
 SurfaceSdlGraphicsManager::~SurfaceSdlGraphicsManager() {
@@ -285,6 +290,8 @@ SurfaceSdlGraphicsManager::~SurfaceSdlGraphicsManager() {
 	if (g_system->getEventManager()->getEventDispatcher() != NULL)
 		g_system->getEventManager()->getEventDispatcher()->unregisterObserver(this);
 
+	stopScalerThreads();
+
 	unloadGFXMode();
 	if (_mouseSurface)
 		SDL_FreeSurface(_mouseSurface);
@@ -1043,10 +1050,186 @@ void SurfaceSdlGraphicsManager::updateScreen() {
 	assert(_transactionMode == kTransactionNone);
 
 	Common::StackLock lock(_graphicsMutex);	// Lock the mutex until this function ends
+	Common::BenchmarkScope benchmark(Common::Benchmark::kCategoryScaling);
 
 	internUpdateScreen();
 }
 
+void SurfaceSdlGraphicsManager::startScalerThreads(int count) {
+	count = CLIP<int>(count, 0, MAX_SCALER_THREADS);
+	if (!count)
+		return;
+
+	_scalerMutex = SDL_CreateMutex();
+	_scalerWorkCond = SDL_CreateCond();
+	_scalerDoneCond = SDL_CreateCond();
+	_scalerThreadsShouldQuit = false;
+
+	for (int i = 0; i < count; i++) {
+		SDL_Thread *thread = SDL_CreateThread(scalerThreadEntry, this);
+		if (!thread) {
+			warning("Could not create scaler thread: %s", SDL_GetError());
+			break;
+		}
+		_scalerThreads.push_back(thread);
+	}
+}
+
+void SurfaceSdlGraphicsManager::stopScalerThreads() {
+	if (!_scalerMutex)
+		return;
+
+	SDL_LockMutex(_scalerMutex);
+	_scalerThreadsShouldQuit = true;
+	SDL_CondBroadcast(_scalerWorkCond);
+	SDL_UnlockMutex(_scalerMutex);
+
+	for (uint i = 0; i < _scalerThreads.size(); i++)
+		SDL_WaitThread(_scalerThreads[i], NULL);
+	_scalerThreads.clear();
+
+	SDL_DestroyCond(_scalerDoneCond);
+	SDL_DestroyCond(_scalerWorkCond);
+	SDL_DestroyMutex(_scalerMutex);
+	_scalerDoneCond = _scalerWorkCond = 0;
+	_scalerMutex = 0;
+}
+
+int SDLCALL SurfaceSdlGraphicsManager::scalerThreadEntry(void *arg) {
+	SurfaceSdlGraphicsManager *graphicsManager = (SurfaceSdlGraphicsManager *)arg;
+	graphicsManager->scalerThread();
+	return 0;
+}
+
+void SurfaceSdlGraphicsManager::scalerThread() {
+	SDL_LockMutex(_scalerMutex);
+	while (true) {
+		// Wait till there is a task left in the current batch
+		while (!_scalerThreadsShouldQuit && _scalerTasksNext >= _scalerTasks.size())
+			SDL_CondWait(_scalerWorkCond, _scalerMutex);
+
+		if (_scalerThreadsShouldQuit)
+			break;
+
+		const ScalerTask task = _scalerTasks[_scalerTasksNext++];
+		SDL_UnlockMutex(_scalerMutex);
+
+		runScalerTask(task);
+
+		SDL_LockMutex(_scalerMutex);
+		if (++_scalerTasksDone == _scalerTasks.size())
+			SDL_CondSignal(_scalerDoneCond);
+	}
+	SDL_UnlockMutex(_scalerMutex);
+}
+
+void SurfaceSdlGraphicsManager::runScalerTask(const ScalerTask &task) {
+	if (task.proc)
+		task.proc(task.src, task.srcPitch, task.dst, task.dstPitch, task.width, task.height);
+#ifdef USE_SCALERS
+	else
+		stretch200To240(task.dst, task.dstPitch, task.width, task.height, task.x, task.y, task.origY);
+#endif
+}
+
+void SurfaceSdlGraphicsManager::runScalerTasks() {
+	SDL_LockMutex(_scalerMutex);
+	SDL_CondBroadcast(_scalerWorkCond);
+
+	// Lend a hand instead of idling until the workers are done
+	while (_scalerTasksNext < _scalerTasks.size()) {
+		const ScalerTask task = _scalerTasks[_scalerTasksNext++];
+		SDL_UnlockMutex(_scalerMutex);
+
+		runScalerTask(task);
+
+		SDL_LockMutex(_scalerMutex);
+		_scalerTasksDone++;
+	}
+
+	while (_scalerTasksDone < _scalerTasks.size())
+		SDL_CondWait(_scalerDoneCond, _scalerMutex);
+
+	_scalerTasks.clear();
+	_scalerTasksNext = 0;
+	_scalerTasksDone = 0;
+	SDL_UnlockMutex(_scalerMutex);
+}
+
+void SurfaceSdlGraphicsManager::scaleRect(ScalerProc *proc, const uint8 *src, uint32 srcPitch, uint8 *dst, uint32 dstPitch, int width, int height) {
+	int bands = MIN<int>(_scalerThreads.size() + 1, height / MIN_SCALER_BAND_HEIGHT);
+#if defined(USE_HQ_SCALERS) && defined(USE_NASM)
+	// The assembly HQ2x and HQ3x keep their state in global variables
+	if (proc == HQ2x || proc == HQ3x)
+		bands = 1;
+#endif
+	if (bands <= 1) {
+		proc(src, srcPitch, dst, dstPitch, width, height);
+		return;
+	}
+
+	// The scalers read one source row above and below the rows they scale.
+	// The source is not written to while scaling, so the bands may share
+	// these border rows, and each band writes only its own output rows.
+	// Bands start on even rows, so DotMatrix keeps its pattern.
+	const int scale = _videoMode.scaleFactor;
+	SDL_LockMutex(_scalerMutex);
+	for (int i = 0; i < bands; i++) {
+		const int top = (height * i / bands) & ~1;
+		const int bottom = (i == bands - 1) ? height : (height * (i + 1) / bands) & ~1;
+
+		ScalerTask task;
+		task.proc = proc;
+		task.src = src + top * srcPitch;
+		task.srcPitch = srcPitch;
+		task.dst = dst + top * scale * dstPitch;
+		task.dstPitch = dstPitch;
+		task.width = width;
+		task.height = bottom - top;
+		task.x = task.y = task.origY = 0;
+		_scalerTasks.push_back(task);
+	}
+	SDL_UnlockMutex(_scalerMutex);
+
+	runScalerTasks();
+}
+
+#ifdef USE_SCALERS
+int SurfaceSdlGraphicsManager::stretchRect(uint8 *buf, uint32 pitch, int width, int height, int srcX, int srcY, int origSrcY) {
+	// Each strip is stretched in place, in columns no other strip touches.
+	// Strip widths are kept a multiple of 8 pixels for the vectorized
+	// interpolation.
+	const int strips = MIN<int>(_scalerThreads.size() + 1, width / MIN_SCALER_STRIP_WIDTH);
+	if (strips <= 1)
+		return stretch200To240(buf, pitch, width, height, srcX, srcY, origSrcY);
+
+	SDL_LockMutex(_scalerMutex);
+	for (int i = 0; i < strips; i++) {
+		const int left = (width * i / strips) & ~7;
+		const int right = (i == strips - 1) ? width : (width * (i + 1) / strips) & ~7;
+
+		ScalerTask task;
+		task.proc = 0;
+		task.src = 0;
+		task.srcPitch = 0;
+		task.dst = buf;
+		task.dstPitch = pitch;
+		task.x = srcX + left;
+		task.y = srcY;
+		task.width = right - left;
+		task.height = height;
+		task.origY = origSrcY;
+		_scalerTasks.push_back(task);
+	}
+	SDL_UnlockMutex(_scalerMutex);
+
+	runScalerTasks();
+
+	// The same height stretch200To240() returns
+	return 1 + real2Aspect(origSrcY + height - 1) - srcY;
+}
+#endif
+
 void SurfaceSdlGraphicsManager::internUpdateScreen() {
 	sSDL_Surface *srcSurf, *origSurf;
 	int height, width;
@@ -1181,7 +1364,7 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 				assert(scalerProc != NULL);
 				//scalerProc((byte *)srcSurf->pixels + (r->x * 2 + 2) + (r->y + 1) * srcPitch, srcPitch,
 				//	(byte *)_hwscreen->pixels + rx1 * 2 + dst_y * dstPitch, dstPitch, r->w, dst_h);
-				scalerProc((byte *)srcSurf->pixels + (r->x * 2 + 2) + (r->y + 1) * srcPitch, srcPitch,
+				scaleRect(scalerProc, (byte *)srcSurf->pixels + (r->x * 2 + 2) + (r->y + 1) * srcPitch, srcPitch,
 					(byte *)_hwscreen->pixels + rx1 * 4 + dst_y * dstPitch, dstPitch, r->w, dst_h);
 			}
 
@@ -1192,7 +1375,7 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 
 #ifdef USE_SCALERS
 			if (_videoMode.aspectRatioCorrection && orig_dst_y < height && !_overlayVisible)
-				r->h = stretch200To240((uint8 *) _hwscreen->pixels, dstPitch, r->w, r->h, r->x, r->y, orig_dst_y * scale1);
+				r->h = stretchRect((uint8 *) _hwscreen->pixels, dstPitch, r->w, r->h, r->x, r->y, orig_dst_y * scale1);
 #endif
 		}
 //		SDL_UnlockSurface(srcSurf);
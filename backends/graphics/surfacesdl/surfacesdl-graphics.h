@@ -27,6 +27,7 @@
 #include "backends/graphics/sdl/sdl-graphics.h"
 #include "graphics/pixelformat.h"
 #include "graphics/scaler.h"
+#include "common/array.h"
 #include "common/events.h"
 #include "common/system.h"
 
@@ -262,6 +263,58 @@ protected:
 	int _scalerType;
 	int _transactionMode;
 
+	enum {
+		MAX_SCALER_THREADS = 8,
+		MIN_SCALER_BAND_HEIGHT = 16,
+		MIN_SCALER_STRIP_WIDTH = 64
+	};
+
+	/**
+	 * A piece of work for the scaler threads: either a band of rows of a
+	 * dirty rect to be run through proc, or, if proc is NULL, a strip of
+	 * columns of a scaled rect to be stretched by stretch200To240().
+	 */
+	struct ScalerTask {
+		ScalerProc *proc;
+		const uint8 *src;
+		uint32 srcPitch;
+		uint8 *dst;
+		uint32 dstPitch;
+		int x, y, width, height, origY;
+	};
+
+	/** Worker threads sharing the scaling with the main thread, see "scaler_threads" */
+	Common::Array<SDL_Thread *> _scalerThreads;
+	SDL_mutex *_scalerMutex;
+	SDL_cond *_scalerWorkCond;
+	SDL_cond *_scalerDoneCond;
+	bool _scalerThreadsShouldQuit;
+
+	/** Tasks of the current batch; the next one to take and the number finished */
+	Common::Array<ScalerTask> _scalerTasks;
+	uint _scalerTasksNext, _scalerTasksDone;
+
+	void startScalerThreads(int count);
+	void stopScalerThreads();
+
+	/**
+	 * Run all queued scaler tasks on the worker threads and the calling
+	 * thread, and return when all of them are done.
+	 */
+	void runScalerTasks();
+
+	/** Run proc on a rect, split into bands of rows if worker threads are available */
+	void scaleRect(ScalerProc *proc, const uint8 *src, uint32 srcPitch, uint8 *dst, uint32 dstPitch, int width, int height);
+
+#ifdef USE_SCALERS
+	/** Stretch a scaled rect, split into strips of columns if worker threads are available */
+	int stretchRect(uint8 *buf, uint32 pitch, int width, int height, int srcX, int srcY, int origSrcY);
+#endif
+
+	static void runScalerTask(const ScalerTask &task);
+	void scalerThread();
+	static int SDLCALL scalerThreadEntry(void *arg);
+
 	bool _screenIsLocked;
 	Graphics::Surface _framebuffer;
 
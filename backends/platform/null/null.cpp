@@ -20,13 +20,34 @@
  *
  */
 
+#define FORBIDDEN_SYMBOL_EXCEPTION_FILE
+#define FORBIDDEN_SYMBOL_EXCEPTION_fputs
+#define FORBIDDEN_SYMBOL_EXCEPTION_fflush
+#define FORBIDDEN_SYMBOL_EXCEPTION_stdout
+#define FORBIDDEN_SYMBOL_EXCEPTION_stderr
+#define FORBIDDEN_SYMBOL_EXCEPTION_time_h
+#define FORBIDDEN_SYMBOL_EXCEPTION_unistd_h
+
 #include "backends/modular-backend.h"
 #include "base/main.h"
 
 #if defined(USE_NULL_DRIVER)
+
+#if defined(POSIX)
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+#include "backends/mutex/null/null-mutex.h"
 #include "backends/saves/default/default-saves.h"
 #include "backends/timer/default/default-timer.h"
+#include "backends/events/default/default-events.h"
+#include "backends/graphics/null/null-graphics.h"
 #include "audio/mixer_intern.h"
+#include "common/benchmark.h"
+#include "common/config-manager.h"
+#include "common/EventRecorder.h"
+#include "common/file.h"
 #include "common/scummsys.h"
 
 /*
@@ -40,22 +61,52 @@
 	#include "backends/fs/windows/windows-fs-factory.h"
 #endif
 
-class OSystem_NULL : public ModularBackend {
+class OSystem_NULL : public ModularBackend, Common::EventSource {
 public:
 	OSystem_NULL();
 	virtual ~OSystem_NULL();
 
 	virtual void initBackend();
 
+	virtual Common::EventSource *getDefaultEventSource() { return this; }
+
 	virtual bool pollEvent(Common::Event &event);
 
+	virtual void engineInit();
+	virtual void engineDone();
+
+	virtual void updateScreen();
+
 	virtual uint32 getMillis();
 	virtual void delayMillis(uint msecs);
 	virtual void getTimeAndDate(TimeDate &t) const {}
 
 	virtual void logMessage(LogMessageType::Type type, const char *message);
+
+private:
+	void mixBenchmarkAudio();
+
+#if defined(POSIX)
+	timeval _startTime;
+#endif
+	uint32 _lastMillis;
+	uint32 _lastMixMillis;
 };
 
+#if defined(POSIX)
+static uint32 getRealMicros() {
+	static timeval startTime = { 0, 0 };
+
+	timeval currentTime;
+	gettimeofday(&currentTime, 0);
+	if (!startTime.tv_sec && !startTime.tv_usec)
+		startTime = currentTime;
+
+	return (uint32)((currentTime.tv_sec - startTime.tv_sec) * 1000000 +
+	                (currentTime.tv_usec - startTime.tv_usec));
+}
+#endif
+
 OSystem_NULL::OSystem_NULL() {
 	#if defined(__amigaos4__)
 		_fsFactory = new AmigaOSFilesystemFactory();
@@ -66,6 +117,12 @@ OSystem_NULL::OSystem_NULL() {
 	#else
 		#error Unknown and unsupported FS backend
 	#endif
+
+#if defined(POSIX)
+	gettimeofday(&_startTime, 0);
+#endif
+	_lastMillis = 0;
+	_lastMixMillis = 0;
 }
 
 OSystem_NULL::~OSystem_NULL() {
@@ -79,11 +136,12 @@ void OSystem_NULL::initBackend() {
 	_graphicsManager = new NullGraphicsManager();
 	_mixer = new Audio::MixerImpl(this, 22050);
 
-	((Audio::MixerImpl *)_mixer)->setReady(false);
-
 	// Note that both the mixer and the timer manager are useless
 	// this way; they need to be hooked into the system somehow to
 	// be functional. Of course, can't do that in a NULL backend :).
+	// The exception is the benchmark mode, which mixes the audio
+	// synchronously on every screen update so its cost gets measured.
+	((Audio::MixerImpl *)_mixer)->setReady(ConfMan.hasKey("benchmark"));
 
 	ModularBackend::initBackend();
 }
@@ -92,11 +150,79 @@ bool OSystem_NULL::pollEvent(Common::Event &event) {
 	return false;
 }
 
+void OSystem_NULL::engineInit() {
+#if defined(POSIX)
+	if (ConfMan.hasKey("benchmark")) {
+		_lastMixMillis = _lastMillis;
+		g_benchmark.start(&getRealMicros);
+	}
+#endif
+}
+
+void OSystem_NULL::engineDone() {
+	if (!g_benchmark.isActive())
+		return;
+
+	g_benchmark.stop();
+	logMessage(LogMessageType::kInfo, g_benchmark.getReport().c_str());
+
+	if (ConfMan.hasKey("benchmark_output")) {
+		Common::DumpFile output;
+		if (output.open(ConfMan.get("benchmark_output"))) {
+			g_benchmark.writeFrames(output);
+			output.finalize();
+		} else {
+			warning("Could not open benchmark output file '%s'", ConfMan.get("benchmark_output").c_str());
+		}
+	}
+}
+
+void OSystem_NULL::updateScreen() {
+	ModularBackend::updateScreen();
+
+	if (g_benchmark.isActive()) {
+		mixBenchmarkAudio();
+		g_benchmark.endFrame();
+	}
+}
+
+void OSystem_NULL::mixBenchmarkAudio() {
+	// Mix as much audio as the game time which passed since the last
+	// frame would have consumed. We go by the last time handed out to
+	// the engine, as asking for the time again would advance the
+	// recorded timeline.
+	static int16 buffer[2 * 4096];
+
+	uint32 samples = (_lastMillis - _lastMixMillis) * _mixer->getOutputRate() / 1000;
+	_lastMixMillis = _lastMillis;
+
+	while (samples) {
+		const uint32 len = MIN<uint32>(samples, ARRAYSIZE(buffer) / 2);
+		((Audio::MixerImpl *)_mixer)->mixCallback((byte *)buffer, len * 4);
+		samples -= len;
+	}
+}
+
 uint32 OSystem_NULL::getMillis() {
-	return 0;
+	uint32 millis = 0;
+#if defined(POSIX)
+	// A real clock allows measuring engine frame rates without a display
+	timeval currentTime;
+	gettimeofday(&currentTime, 0);
+	millis = (uint32)(((currentTime.tv_sec - _startTime.tv_sec) * 1000) +
+	                  ((currentTime.tv_usec - _startTime.tv_usec) / 1000));
+#endif
+	g_eventRec.processMillis(millis);
+	_lastMillis = millis;
+	return millis;
 }
 
 void OSystem_NULL::delayMillis(uint msecs) {
+	if (g_eventRec.processDelayMillis(msecs))
+		return;
+#if defined(POSIX)
+	usleep(msecs * 1000);
+#endif
 }
 
 void OSystem_NULL::logMessage(LogMessageType::Type type, const char *message) {
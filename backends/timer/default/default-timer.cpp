@@ -33,48 +33,85 @@ struct TimerSlot {
 	uint32 nextFireTime;	// in milliseconds
 	uint32 nextFireTimeMicro;	// microseconds part of nextFire
 
-	TimerSlot *next;
+	Common::TimerManager::TimerStats stats;
 };
 
-void insertPrioQueue(TimerSlot *head, TimerSlot *newSlot) {
-	// The head points to a fake anchor TimerSlot; this common
-	// trick allows us to get rid of many special cases.
-
-	const uint32 nextFireTime = newSlot->nextFireTime;
-	TimerSlot *slot = head;
-	newSlot->next = 0;
-
-	// Insert the new slot into the sorted list of already scheduled
-	// timers in such a way that the list stays sorted...
-	while (true) {
-		assert(slot);
-		if (slot->next == 0 || nextFireTime < slot->next->nextFireTime) {
-			newSlot->next = slot->next;
-			slot->next = newSlot;
-			return;
-		}
-		slot = slot->next;
-	}
+/** Whether slot a is due before slot b. The times may wrap around. */
+static bool firesBefore(const TimerSlot *a, const TimerSlot *b) {
+	const int32 diff = (int32)(a->nextFireTime - b->nextFireTime);
+	return diff < 0 || (diff == 0 && a->nextFireTimeMicro < b->nextFireTimeMicro);
 }
 
+static bool isDue(const TimerSlot *slot, uint32 curTime) {
+	return (int32)(curTime - slot->nextFireTime) > 0;
+}
 
-DefaultTimerManager::DefaultTimerManager() :
-	_head(0) {
 
-	_head = new TimerSlot();
-	memset(_head, 0, sizeof(TimerSlot));
+DefaultTimerManager::DefaultTimerManager() {
 }
 
 DefaultTimerManager::~DefaultTimerManager() {
 	Common::StackLock lock(_mutex);
 
-	TimerSlot *slot = _head;
-	while (slot) {
-		TimerSlot *next = slot->next;
-		delete slot;
-		slot = next;
+	// Dedicated timers are stopped by the subclass which started them
+	for (uint i = 0; i < _heap.size(); i++)
+		delete _heap[i];
+	for (uint i = 0; i < _dedicated.size(); i++)
+		delete _dedicated[i];
+	_heap.clear();
+	_dedicated.clear();
+}
+
+void DefaultTimerManager::siftUp(uint index) {
+	TimerSlot *slot = _heap[index];
+
+	while (index > 0) {
+		const uint parent = (index - 1) / 2;
+		if (!firesBefore(slot, _heap[parent]))
+			break;
+		_heap[index] = _heap[parent];
+		index = parent;
+	}
+	_heap[index] = slot;
+}
+
+void DefaultTimerManager::siftDown(uint index) {
+	TimerSlot *slot = _heap[index];
+	const uint size = _heap.size();
+
+	while (true) {
+		uint child = 2 * index + 1;
+		if (child >= size)
+			break;
+		if (child + 1 < size && firesBefore(_heap[child + 1], _heap[child]))
+			child++;
+		if (!firesBefore(_heap[child], slot))
+			break;
+		_heap[index] = _heap[child];
+		index = child;
+	}
+	_heap[index] = slot;
+}
+
+void DefaultTimerManager::fire(TimerSlot *slot, uint32 curTime) {
+	const uint32 lateness = curTime - slot->nextFireTime;
+
+	// Update the fire time. It is advanced from the previous deadline, not
+	// from the current time, so that late invocations do not add up.
+	assert(slot->interval > 0);
+	slot->nextFireTime += (slot->interval / 1000);
+	slot->nextFireTimeMicro += (slot->interval % 1000);
+	if (slot->nextFireTimeMicro >= 1000) {
+		slot->nextFireTime += slot->nextFireTimeMicro / 1000;
+		slot->nextFireTimeMicro %= 1000;
 	}
-	_head = 0;
+
+	slot->stats.calls++;
+	slot->stats.maxLateness = MAX(slot->stats.maxLateness, lateness);
+	// The next invocation is due already, so this one is more than one
+	// interval late.
+	if (isDue(slot, curTime))
+		slot->stats.overruns++;
 }
 
 void DefaultTimerManager::handler() {
@@ -83,34 +120,39 @@ void DefaultTimerManager::handler() {
 	const uint32 curTime = g_system->getMillis();
 
 	// Repeat as long as there is a TimerSlot that is scheduled to fire.
-	TimerSlot *slot = _head->next;
-	while (slot && slot->nextFireTime < curTime) {
-		// Remove the slot from the priority queue
-		_head->next = slot->next;
-
-		// Update the fire time and reinsert the TimerSlot into the priority
-		// queue.
-		assert(slot->interval > 0);
-		slot->nextFireTime += (slot->interval / 1000);
-		slot->nextFireTimeMicro += (slot->interval % 1000);
-		if (slot->nextFireTimeMicro > 1000) {
-			slot->nextFireTime += slot->nextFireTimeMicro / 1000;
-			slot->nextFireTimeMicro %= 1000;
-		}
-		insertPrioQueue(_head, slot);
+	while (!_heap.empty() && isDue(_heap[0], curTime)) {
+		TimerSlot *slot = _heap[0];
+
+		// Move the slot to its new place in the priority queue
+		fire(slot, curTime);
+		siftDown(0);
 
-		// Invoke the timer callback
+		// Invoke the timer callback. It might install or remove timers,
+		// so the slot must not be used afterwards.
 		assert(slot->callback);
 		slot->callback(slot->refCon);
+	}
+}
 
-		// Look at the next scheduled timer
-		slot = _head->next;
+uint32 DefaultTimerManager::runDedicatedTimer(TimerSlot *slot) {
+	{
+		Common::StackLock lock(_mutex);
+
+		const uint32 curTime = g_system->getMillis();
+		if (!isDue(slot, curTime))
+			return slot->nextFireTime - curTime + 1;
+
+		fire(slot, curTime);
 	}
+
+	// Dedicated timers run without holding the mutex, in parallel with
+	// the other timers.
+	slot->callback(slot->refCon);
+	return 0;
 }
 
-bool DefaultTimerManager::installTimerProc(TimerProc callback, int32 interval, void *refCon, const Common::String &id) {
+TimerSlot *DefaultTimerManager::createSlot(TimerProc callback, int32 interval, void *refCon, const Common::String &id) {
 	assert(interval > 0);
-	Common::StackLock lock(_mutex);
 
 	if (_callbacks.contains(id)) {
 		if (_callbacks[id] != callback) {
@@ -133,25 +175,82 @@ bool DefaultTimerManager::installTimerProc(TimerProc callback, int32 interval, v
 	slot->interval = interval;
 	slot->nextFireTime = g_system->getMillis() + interval / 1000;
 	slot->nextFireTimeMicro = interval % 1000;
-	slot->next = 0;
+	memset(&slot->stats, 0, sizeof(slot->stats));
 
-	insertPrioQueue(_head, slot);
+	return slot;
+}
+
+bool DefaultTimerManager::installTimerProc(TimerProc callback, int32 interval, void *refCon, const Common::String &id) {
+	Common::StackLock lock(_mutex);
+
+	_heap.push_back(createSlot(callback, interval, refCon, id));
+	siftUp(_heap.size() - 1);
 
 	return true;
 }
 
-void DefaultTimerManager::removeTimerProc(TimerProc callback) {
+bool DefaultTimerManager::installDedicatedTimerProc(TimerProc callback, int32 interval, void *refCon, const Common::String &id) {
 	Common::StackLock lock(_mutex);
 
-	TimerSlot *slot = _head;
+	TimerSlot *slot = createSlot(callback, interval, refCon, id);
 
-	while (slot->next) {
-		if (slot->next->callback == callback) {
-			TimerSlot *next = slot->next->next;
-			delete slot->next;
-			slot->next = next;
+	if (startTimerThread(slot)) {
+		_dedicated.push_back(slot);
+	} else {
+		_heap.push_back(slot);
+		siftUp(_heap.size() - 1);
+	}
+
+	return true;
+}
+
+bool DefaultTimerManager::getTimerStats(TimerProc callback, TimerStats &stats) {
+	Common::StackLock lock(_mutex);
+
+	for (uint i = 0; i < _heap.size(); i++) {
+		if (_heap[i]->callback == callback) {
+			stats = _heap[i]->stats;
+			return true;
+		}
+	}
+
+	for (uint i = 0; i < _dedicated.size(); i++) {
+		if (_dedicated[i]->callback == callback) {
+			stats = _dedicated[i]->stats;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void DefaultTimerManager::removeTimerProc(TimerProc callback) {
+	Common::Array<TimerSlot *> stopped;
+
+	_mutex.lock();
+
+	for (uint i = 0; i < _heap.size();) {
+		if (_heap[i]->callback == callback) {
+			delete _heap[i];
+
+			// Fill the gap with the last slot and restore the heap order
+			_heap[i] = _heap.back();
+			_heap.pop_back();
+			if (i < _heap.size()) {
+				siftDown(i);
+				siftUp(i);
+			}
 		} else {
-			slot = slot->next;
+			i++;
+		}
+	}
+
+	for (uint i = 0; i < _dedicated.size();) {
+		if (_dedicated[i]->callback == callback) {
+			stopped.push_back(_dedicated[i]);
+			_dedicated.remove_at(i);
+		} else {
+			i++;
 		}
 	}
 
@@ -171,4 +270,11 @@ void DefaultTimerManager::removeTimerProc(TimerProc callback) {
 		if (i->_value == callback)
 			_callbacks.erase(i);
 	}
+	_mutex.unlock();
+
+	// The threads of dedicated timers need the mutex to finish
+	for (uint i = 0; i < stopped.size(); i++) {
+		stopTimerThread(stopped[i]);
+		delete stopped[i];
+	}
 }
@@ -23,30 +23,70 @@
 #define BACKENDS_TIMER_DEFAULT_H
 
 #include "common/str.h"
+#include "common/array.h"
 #include "common/hash-str.h"
 #include "common/timer.h"
 #include "common/mutex.h"
 
 struct TimerSlot;
 
+/**
+ * Timer manager which keeps the installed timers in a binary heap ordered
+ * by their next deadline. Deadlines are absolute, so the timers do not
+ * drift no matter how late handler() is called.
+ *
+ * Timers installed with installDedicatedTimerProc() run in a thread of
+ * their own if the backend implements startTimerThread(); all the others
+ * are run from handler().
+ */
 class DefaultTimerManager : public Common::TimerManager {
 private:
 	typedef Common::HashMap<Common::String, TimerProc, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> TimerSlotMap;
 
 	Common::Mutex _mutex;
-	TimerSlot *_head;
+	Common::Array<TimerSlot *> _heap;
+	Common::Array<TimerSlot *> _dedicated;
 	TimerSlotMap _callbacks;
 
+	TimerSlot *createSlot(TimerProc proc, int32 interval, void *refCon, const Common::String &id);
+	void siftUp(uint index);
+	void siftDown(uint index);
+	void fire(TimerSlot *slot, uint32 curTime);
+
 public:
 	DefaultTimerManager();
 	virtual ~DefaultTimerManager();
 	virtual bool installTimerProc(TimerProc proc, int32 interval, void *refCon, const Common::String &id);
+	virtual bool installDedicatedTimerProc(TimerProc proc, int32 interval, void *refCon, const Common::String &id);
 	virtual void removeTimerProc(TimerProc proc);
+	virtual bool getTimerStats(TimerProc proc, TimerStats &stats);
 
 	/**
 	 * Timer callback, to be invoked at regular time intervals by the backend.
 	 */
 	void handler();
+
+protected:
+	/**
+	 * Start a thread which repeatedly calls runDedicatedTimer() for the
+	 * given slot, until stopTimerThread() is called for it.
+	 *
+	 * @return true if the thread was started, false if the backend cannot
+	 *         do this, in which case the timer is run from handler().
+	 */
+	virtual bool startTimerThread(TimerSlot *slot) { return false; }
+
+	/**
+	 * Stop a thread started by startTimerThread() and wait for it to finish.
+	 */
+	virtual void stopTimerThread(TimerSlot *slot) {}
+
+	/**
+	 * Invoke the timer of the given slot if it is due.
+	 *
+	 * @return the number of milliseconds until the timer is due again
+	 */
+	uint32 runDedicatedTimer(TimerSlot *slot);
 };
 
 #endif
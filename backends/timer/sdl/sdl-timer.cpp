@@ -27,6 +27,7 @@
 
 #include "backends/timer/sdl/sdl-timer.h"
 
+#include "common/atomic.h"
 #include "common/textconsole.h"
 
 static Uint32 timer_handler(Uint32 interval, void *param) {
@@ -47,6 +48,65 @@ SdlTimerManager::SdlTimerManager() {
 SdlTimerManager::~SdlTimerManager() {
 	// Removes the timer callback
 	SDL_RemoveTimer(_timerID);
+
+	// Stop the dedicated timers, before DefaultTimerManager frees their slots
+	while (!_threads.empty())
+		stopTimerThread(_threads.back()->slot);
+}
+
+bool SdlTimerManager::startTimerThread(TimerSlot *slot) {
+	TimerThread *timerThread = new TimerThread;
+	timerThread->manager = this;
+	timerThread->slot = slot;
+	timerThread->quit = 0;
+	timerThread->thread = SDL_CreateThread(&SdlTimerManager::timerThread, timerThread);
+
+	if (!timerThread->thread) {
+		warning("Could not create timer thread: %s", SDL_GetError());
+		delete timerThread;
+		return false;
+	}
+
+	Common::StackLock lock(_threadsMutex);
+	_threads.push_back(timerThread);
+	return true;
+}
+
+void SdlTimerManager::stopTimerThread(TimerSlot *slot) {
+	TimerThread *timerThread = 0;
+
+	{
+		Common::StackLock lock(_threadsMutex);
+		for (uint i = 0; i < _threads.size(); i++) {
+			if (_threads[i]->slot == slot) {
+				timerThread = _threads[i];
+				_threads.remove_at(i);
+				break;
+			}
+		}
+	}
+
+	if (!timerThread)
+		return;
+
+	Common::atomicStore(&timerThread->quit, 1);
+	SDL_WaitThread(timerThread->thread, NULL);
+	delete timerThread;
+}
+
+int SDLCALL SdlTimerManager::timerThread(void *arg) {
+	TimerThread *timerThread = (TimerThread *)arg;
+
+	while (!Common::atomicLoad(&timerThread->quit)) {
+		const uint32 delay = timerThread->manager->runDedicatedTimer(timerThread->slot);
+
+		// Do not sleep for too long at once, to notice quickly when we are
+		// supposed to stop.
+		if (delay)
+			SDL_Delay(MIN<uint32>(delay, 10));
+	}
+
+	return 0;
 }
 
 #endif
@@ -29,7 +29,7 @@
 
 /**
  * SDL timer manager. Setups the timer callback for
- * DefaultTimerManager.
+ * DefaultTimerManager, and runs dedicated timers in SDL threads.
  */
 class SdlTimerManager : public DefaultTimerManager {
 public:
@@ -37,7 +37,23 @@ public:
 	virtual ~SdlTimerManager();
 
 protected:
+	virtual bool startTimerThread(TimerSlot *slot);
+	virtual void stopTimerThread(TimerSlot *slot);
+
 	SDL_TimerID _timerID;
+
+private:
+	struct TimerThread {
+		SdlTimerManager *manager;
+		TimerSlot *slot;
+		SDL_Thread *thread;
+		volatile int32 quit;
+	};
+
+	static int SDLCALL timerThread(void *arg);
+
+	Common::Mutex _threadsMutex;
+	Common::Array<TimerThread *> _threads;
 };
 
 
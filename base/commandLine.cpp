@@ -99,6 +99,10 @@ static const char HELP_STRING[] =
 	"                           (separated by commas)\n"
 	"  -u, --dump-scripts       Enable script dumping if a directory called 'dumps'\n"
 	"                           exists in the current directory\n"
+	"  --benchmark=FILE         Replay the event recording FILE (from the save path)\n"
+	"                           as fast as possible and report per-frame timings\n"
+	"                           (null backend only)\n"
+	"  --benchmark-output=FILE  Write the per-frame benchmark timings to FILE as CSV\n"
 	"\n"
 	"  --cdrom=NUM              CD drive to play CD audio from (default: 0 = first\n"
 	"                           drive)\n"
@@ -172,6 +176,7 @@ void registerDefaults() {
 	ConfMan.registerDefault("gfx_mode", "normal");
 	ConfMan.registerDefault("render_mode", "default");
 	ConfMan.registerDefault("desired_screen_aspect_ratio", "auto");
+	ConfMan.registerDefault("scaler_threads", 0);
 
 	// Sound & Music
 	ConfMan.registerDefault("music_volume", 192);
@@ -187,6 +192,7 @@ void registerDefaults() {
 	ConfMan.registerDefault("native_mt32", false);
 	ConfMan.registerDefault("enable_gs", false);
 	ConfMan.registerDefault("midi_gain", 100);
+	ConfMan.registerDefault("midi_timer_thread", false);
 
 	ConfMan.registerDefault("music_driver", "auto");
 	ConfMan.registerDefault("mt32_device", "null");
@@ -581,6 +587,15 @@ Common::String parseCommandLine(Common::StringMap &settings, int argc, const cha
 			DO_LONG_OPTION("record-time-file-name")
 			END_OPTION
 
+			DO_LONG_OPTION("benchmark")
+				// A benchmark is a playback of an event recording
+				settings["record-mode"] = "playback";
+				settings["record-file-name"] = option;
+			END_OPTION
+
+			DO_LONG_OPTION("benchmark-output")
+			END_OPTION
+
 #ifdef IPHONE
 			// This is automatically set when launched from the Springboard.
 			DO_LONG_OPTION_OPT("launchedFromSB", 0)
@@ -36,6 +36,7 @@
 // FIXME: Avoid using printf
 #define FORBIDDEN_SYMBOL_EXCEPTION_printf
 
+#include "engines/advancedDetector.h"
 #include "engines/engine.h"
 #include "engines/metaengine.h"
 #include "base/commandLine.h"
@@ -48,6 +49,7 @@
 #include "common/debug-channels.h" /* for debug manager */
 #include "common/events.h"
 #include "common/EventRecorder.h"
+#include "common/framescheduler.h"
 #include "common/fs.h"
 #include "common/system.h"
 #include "common/textconsole.h"
@@ -129,6 +131,96 @@ static const EnginePlugin *detectPlugin() {
 	return plugin;
 }
 
+#ifdef EMSCRIPTEN
+#include "emscripten/emscripten.h"
+#endif
+
+/** Interval, in milliseconds, at which frame loop statistics are logged. */
+static const uint32 kFrameStatsInterval = 10000;
+
+static void logFrameStats(Common::FrameScheduler &scheduler, uint32 now) {
+	const Common::FrameScheduler::Stats &stats = scheduler.getStats();
+	const uint32 fps = scheduler.getFramesPerSecond100(now);
+
+	debug(1, "Frame loop: %d.%02d frames/s, %d wake-ups/s, %d late frames (avg %d ms, max %d ms), %d%% busy",
+		fps / 100, fps % 100, scheduler.getWakeUpsPerSecond(now),
+		stats.lateFrames, stats.lateFrames ? stats.totalLateness / stats.lateFrames : 0, stats.maxLateness,
+		stats.elapsed ? stats.busyTime * 100 / stats.elapsed : 0);
+
+	scheduler.resetStats(now);
+}
+
+/**
+ * Handle one wake-up of the frame loop of an engine supporting
+ * Engine::kSupportsFrameLoop: run a frame if one is due and schedule
+ * the next one.
+ * @return false if the engine wants to quit, true otherwise
+ */
+static bool stepFrameLoop(Engine *engine, Common::FrameScheduler &scheduler, OSystem &system) {
+	uint32 now = system.getMillis();
+
+	scheduler.wakeUp();
+	if (!scheduler.isDue(now))
+		return true;
+
+	scheduler.beginFrame(now);
+	const int32 delay = engine->runFrame();
+	if (delay < 0)
+		return false;
+
+	now = system.getMillis();
+	scheduler.endFrame(now, delay);
+
+	if (scheduler.getStats().elapsed >= kFrameStatsInterval)
+		logFrameStats(scheduler, now);
+
+	return true;
+}
+
+#ifdef EMSCRIPTEN
+static Engine *s_frameLoopEngine = 0;
+static Common::FrameScheduler *s_frameScheduler = 0;
+
+static void frameLoopCallback(void *) {
+	if (!stepFrameLoop(s_frameLoopEngine, *s_frameScheduler, *g_system))
+		return;
+
+	// Re-arm exactly once per wake-up, for the remaining time until the
+	// next frame is due, instead of polling the clock.
+	emscripten_async_call(frameLoopCallback, 0, s_frameScheduler->getDelay(g_system->getMillis()));
+}
+
+/**
+ * Hand the engine's main loop over to the browser. This returns right
+ * away; frames are run from timer callbacks afterwards.
+ */
+static void startFrameLoop(Engine *engine, OSystem &system) {
+	s_frameLoopEngine = engine;
+	if (!s_frameScheduler)
+		s_frameScheduler = new Common::FrameScheduler();
+	s_frameScheduler->reset(system.getMillis());
+
+	emscripten_async_call(frameLoopCallback, 0, 0);
+}
+#else
+/**
+ * Drive the engine's main loop until it wants to quit, sleeping until
+ * each frame's deadline in between.
+ */
+static void runFrameLoop(Engine *engine, OSystem &system) {
+	Common::FrameScheduler scheduler;
+	scheduler.reset(system.getMillis());
+
+	while (stepFrameLoop(engine, scheduler, system)) {
+		const uint32 delay = scheduler.getDelay(system.getMillis());
+		if (delay)
+			system.delayMillis(delay);
+	}
+
+	logFrameStats(scheduler, system.getMillis());
+}
+#endif
+
 // TODO: specify the possible return values here
 static Common::Error runGame(const EnginePlugin *plugin, OSystem &system, const Common::String &edebuglevels) {
 	// Determine the game data path, for validation and error messages
@@ -229,7 +321,19 @@ static Common::Error runGame(const EnginePlugin *plugin, OSystem &system, const
 
 	// Run the engine
 	Common::Error result = engine->run();
-	return result;
+
+	// Engines with a cooperative main loop only set up the game in run(),
+	// the loop itself is driven from here.
+	if (result.getCode() == Common::kNoError && engine->hasFeature(Engine::kSupportsFrameLoop)) {
+#ifdef EMSCRIPTEN
+		// The browser owns the main loop, so the engine has to stay alive
+		// after we return.
+		startFrameLoop(engine, system);
+		return result;
+#else
+		runFrameLoop(engine, system);
+#endif
+	}
 
 	// Inform backend that the engine finished
 	system.engineDone();
@@ -328,20 +432,6 @@ static void setupKeymapper(OSystem &system) {
 
 }
 
-#ifdef EMSCRIPTEN
-#include "emscripten/emscripten.h"
-#endif
-
-typedef void (*FuncPtr)();
-FuncPtr mainLoopUpdateFunc = 0;
-void emscriptenUpdate(void *)
-{
-	if (mainLoopUpdateFunc)
-		mainLoopUpdateFunc();
-//	warning("Update at %f", (float)emscripten_get_now());
-//        emscripten_async_call(emscriptenUpdate, 0, 1);
-}
-
 #ifdef EMSCRIPTEN
 bool directoryExists(const char *path)
 {
@@ -353,21 +443,11 @@ bool directoryExists(const char *path)
 }
 #endif
 
-void mainLoop()
-{
-	printf("Entering main loop!");
-//#ifndef EMSCRIPTEN
-//	while(mainLoopUpdateFunc)
-//#endif
-//		emscriptenUpdate(0);
-//	emscripten_set_main_loop(mainLoopUpdateFunc, 1, 0);
-	emscripten_async_call(emscriptenUpdate, 0, 1);
-}
-
 extern "C" int scummvm_main(int argc, const char * const argv[]) {
 	Common::String specialDebug;
 	Common::String command;
 
+#ifdef EMSCRIPTEN
 	argc = 3;
 	const char * args[3] = { "scummvm", "", "" };
 	if (directoryExists("/dott")) { args[1] = "-p/dott"; args[2] = "tentacle"; }
@@ -380,6 +460,7 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 	if (directoryExists("/maniac")) { args[1] = "-p/maniac"; args[2] = "maniac"; }
 
 	argv = args;
+#endif
 	// Verify that the backend has been initialized (i.e. g_system has been set).
 	assert(g_system);
 	OSystem &system = *g_system;
@@ -504,8 +585,10 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 
 			// Try to run the game
 			Common::Error result = runGame(plugin, system, specialDebug);
-			mainLoop();
+#ifdef EMSCRIPTEN
+			// The game keeps running from browser callbacks, see runGame()
 			return 0;
+#endif
 
 			// Flush Event recorder file. The recorder does not get reinitialized for next game
 			// which is intentional. Only single game per session is allowed.
@@ -552,6 +635,7 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 		setupGraphics(system);
 		launcherDialog();
 	}
+	ADDetectionCache::destroy();
 	PluginManager::instance().unloadAllPlugins();
 	PluginManager::destroy();
 	GUI::GuiManager::destroy();
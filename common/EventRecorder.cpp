@@ -129,6 +129,9 @@ EventRecorder::EventRecorder() {
 	_lastMillis = 0;
 	_lastEventMillis = 0;
 
+	_benchmark = false;
+	_benchmarkQuitSent = false;
+
 	_recordMode = kPassthrough;
 }
 
@@ -196,6 +199,15 @@ void EventRecorder::init() {
 		}
 	}
 
+	if (ConfMan.hasKey("benchmark")) {
+		if (_recordMode != kRecorderPlayback)
+			error("Cannot open benchmark recording %s", _recordFileName.c_str());
+
+		_benchmark = true;
+		_benchmarkQuitSent = false;
+		debug(3, "EventRecorder: benchmark");
+	}
+
 	if (_recordMode == kRecorderPlayback) {
 		sign = _playbackFile->readUint32LE();
 		if (sign != RECORD_SIGNATURE) {
@@ -325,7 +337,9 @@ void EventRecorder::processMillis(uint32 &millis) {
 		if (_recordTimeCount > _playbackTimeCount) {
 			d = readTime(_playbackTimeFile);
 
-			while ((_lastMillis + d > millis) && (_lastMillis + d - millis > 50)) {
+			// In benchmark mode the recorded timeline is all that counts,
+			// so never wait for the real clock to catch up.
+			while (!_benchmark && (_lastMillis + d > millis) && (_lastMillis + d - millis > 50)) {
 				_recordMode = kPassthrough;
 				g_system->delayMillis(50);
 				millis = g_system->getMillis();
@@ -343,6 +357,9 @@ void EventRecorder::processMillis(uint32 &millis) {
 
 bool EventRecorder::processDelayMillis(uint &msecs) {
 	if (_recordMode == kRecorderPlayback) {
+		if (_benchmark)
+			return true;
+
 		_recordMode = kPassthrough;
 
 		uint32 millis = g_system->getMillis();
@@ -392,6 +409,14 @@ bool EventRecorder::pollEvent(Event &ev) {
 	StackLock lock(_recorderMutex);
 	++_eventCount;
 
+	// End the benchmark once its recording has been replayed completely
+	if (_benchmark && !_benchmarkQuitSent && !_hasPlaybackEvent &&
+		_playbackCount >= _recordCount && _playbackTimeCount >= _recordTimeCount) {
+		ev.type = EVENT_QUIT;
+		_benchmarkQuitSent = true;
+		return true;
+	}
+
 	if (!_hasPlaybackEvent) {
 		if (_recordCount > _playbackCount) {
 			readRecord(_playbackFile, const_cast<uint32&>(_playbackDiff), _playbackEvent, millis);
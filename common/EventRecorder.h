@@ -59,6 +59,14 @@ public:
 	/** TODO: Add documentation, this is only used by the backend */
 	bool processDelayMillis(uint &msecs);
 
+	/**
+	 * Return whether a recording is being replayed in benchmark mode, i.e.
+	 * as fast as possible: the recorded timeline is used as a virtual
+	 * clock, all delays are skipped and the game is quit once the
+	 * recording is exhausted.
+	 */
+	bool isBenchmarking() const { return _benchmark; }
+
 private:
 	bool notifyEvent(const Event &ev);
 	bool notifyPoll();
@@ -94,6 +102,9 @@ private:
 	volatile uint32 _eventCount;
 	volatile uint32 _lastEventCount;
 
+	bool _benchmark;
+	bool _benchmarkQuitSent;
+
 	enum RecordMode {
 		kPassthrough = 0,
 		kRecorderRecord = 1,
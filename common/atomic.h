@@ -0,0 +1,115 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_ATOMIC_H
+#define COMMON_ATOMIC_H
+
+#include "common/scummsys.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Common {
+
+/**
+ * @file
+ * Minimal set of atomic operations on 32 bit integers, for the few places
+ * which exchange data between threads without taking a Mutex. All of them
+ * act as full memory barriers.
+ *
+ * Compilers without atomic builtins fall back to plain volatile accesses,
+ * which is only safe on the single core targets they are used for.
+ */
+
+#if defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 1)))
+
+inline void memoryBarrier() {
+	__sync_synchronize();
+}
+
+inline bool atomicCompareAndSwap(volatile int32 *ptr, int32 oldValue, int32 newValue) {
+	return __sync_bool_compare_and_swap(ptr, oldValue, newValue);
+}
+
+inline int32 atomicAdd(volatile int32 *ptr, int32 value) {
+	return __sync_add_and_fetch(ptr, value);
+}
+
+#elif defined(_MSC_VER)
+
+inline void memoryBarrier() {
+	// Interlocked operations imply a full barrier
+	long dummy = 0;
+	_InterlockedExchange(&dummy, 1);
+}
+
+inline bool atomicCompareAndSwap(volatile int32 *ptr, int32 oldValue, int32 newValue) {
+	return _InterlockedCompareExchange((volatile long *)ptr, newValue, oldValue) == oldValue;
+}
+
+inline int32 atomicAdd(volatile int32 *ptr, int32 value) {
+	return _InterlockedExchangeAdd((volatile long *)ptr, value) + value;
+}
+
+#else
+
+inline void memoryBarrier() {
+}
+
+inline bool atomicCompareAndSwap(volatile int32 *ptr, int32 oldValue, int32 newValue) {
+	if (*ptr != oldValue)
+		return false;
+	*ptr = newValue;
+	return true;
+}
+
+inline int32 atomicAdd(volatile int32 *ptr, int32 value) {
+	return *ptr += value;
+}
+
+#endif
+
+/**
+ * Read a value written by another thread. Nothing after the load is
+ * reordered before it.
+ */
+inline int32 atomicLoad(const volatile int32 *ptr) {
+	memoryBarrier();
+	const int32 value = *ptr;
+	memoryBarrier();
+	return value;
+}
+
+/**
+ * Publish a value to other threads. Nothing before the store is reordered
+ * after it.
+ */
+inline void atomicStore(volatile int32 *ptr, int32 value) {
+	memoryBarrier();
+	*ptr = value;
+	memoryBarrier();
+}
+
+} // End of namespace Common
+
+#endif
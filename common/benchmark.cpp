@@ -0,0 +1,179 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/benchmark.h"
+
+#include "common/algorithm.h"
+#include "common/stream.h"
+
+namespace Common {
+
+DECLARE_SINGLETON(Benchmark);
+
+static const char *const s_categoryNames[Benchmark::kCategoryCount] = {
+	"script/VM",
+	"rendering",
+	"scaling",
+	"audio mixing"
+};
+
+uint32 Benchmark::Frame::getTotal() const {
+	uint32 total = 0;
+	for (int i = 0; i < kCategoryCount; i++)
+		total += time[i];
+	return total;
+}
+
+Benchmark::Benchmark() : _clock(0), _current(kCategoryScript), _lastSwitch(0) {
+	memset(&_frame, 0, sizeof(_frame));
+}
+
+void Benchmark::start(ClockProc clock) {
+	_clock = clock;
+	_current = kCategoryScript;
+	_lastSwitch = _clock();
+	memset(&_frame, 0, sizeof(_frame));
+	_frames.clear();
+}
+
+void Benchmark::stop() {
+	if (!_clock)
+		return;
+
+	flush();
+	_clock = 0;
+}
+
+void Benchmark::flush() {
+	const uint32 now = _clock();
+	_frame.time[_current] += now - _lastSwitch;
+	_lastSwitch = now;
+}
+
+Benchmark::Category Benchmark::enter(Category category) {
+	const Category previous = _current;
+	if (_clock && category != _current) {
+		flush();
+		_current = category;
+	}
+	return previous;
+}
+
+void Benchmark::endFrame() {
+	if (!_clock)
+		return;
+
+	flush();
+	_frames.push_back(_frame);
+	memset(&_frame, 0, sizeof(_frame));
+}
+
+const char *Benchmark::getCategoryName(Category category) {
+	return s_categoryNames[category];
+}
+
+namespace {
+
+struct FrameStats {
+	double sum;
+	uint32 p95;
+	uint32 max;
+};
+
+FrameStats computeStats(Array<uint32> &values) {
+	FrameStats stats;
+	stats.sum = 0;
+	stats.p95 = 0;
+	stats.max = 0;
+
+	if (values.empty())
+		return stats;
+
+	for (uint i = 0; i < values.size(); i++)
+		stats.sum += values[i];
+
+	Common::sort(values.begin(), values.end());
+	stats.p95 = values[(values.size() - 1) * 95 / 100];
+	stats.max = values.back();
+
+	return stats;
+}
+
+String formatMillis(uint32 micros) {
+	return String::format("%u.%03u", micros / 1000, micros % 1000);
+}
+
+} // End of anonymous namespace
+
+String Benchmark::getReport() const {
+	const uint count = _frames.size();
+	String report = String::format("Benchmark: %u frames\n", count);
+	if (!count)
+		return report;
+
+	report += String::format("%-14s %10s %10s %10s %6s\n", "", "avg ms", "p95 ms", "max ms", "share");
+
+	Array<uint32> values;
+	values.resize(count);
+
+	for (uint i = 0; i < count; i++)
+		values[i] = _frames[i].getTotal();
+	const FrameStats total = computeStats(values);
+
+	for (int category = 0; category <= kCategoryCount; category++) {
+		FrameStats stats;
+		if (category == kCategoryCount) {
+			stats = total;
+		} else {
+			for (uint i = 0; i < count; i++)
+				values[i] = _frames[i].time[category];
+			stats = computeStats(values);
+		}
+
+		report += String::format("%-14s %10s %10s %10s %5u%%\n",
+			category == kCategoryCount ? "total" : s_categoryNames[category],
+			formatMillis((uint32)(stats.sum / count)).c_str(),
+			formatMillis(stats.p95).c_str(),
+			formatMillis(stats.max).c_str(),
+			total.sum > 0 ? (uint)(stats.sum * 100 / total.sum) : 0);
+	}
+
+	return report;
+}
+
+void Benchmark::writeFrames(WriteStream &stream) const {
+	String line = "frame";
+	for (int category = 0; category < kCategoryCount; category++)
+		line += String::format(",%s", s_categoryNames[category]);
+	line += ",total\n";
+	stream.writeString(line);
+
+	for (uint i = 0; i < _frames.size(); i++) {
+		line = String::format("%u", i);
+		for (int category = 0; category < kCategoryCount; category++)
+			line += String::format(",%u", _frames[i].time[category]);
+		line += String::format(",%u\n", _frames[i].getTotal());
+		stream.writeString(line);
+	}
+}
+
+} // End of namespace Common
@@ -0,0 +1,145 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_BENCHMARK_H
+#define COMMON_BENCHMARK_H
+
+#include "common/scummsys.h"
+#include "common/array.h"
+#include "common/singleton.h"
+#include "common/str.h"
+
+#define g_benchmark (Common::Benchmark::instance())
+
+namespace Common {
+
+class WriteStream;
+
+/**
+ * Per-frame timing collector used by the --benchmark mode.
+ *
+ * Time is attributed exclusively to one category at a time: code paths
+ * which are interesting on their own (rendering, scaling, audio mixing)
+ * wrap themselves in a BenchmarkScope, and everything else is accounted
+ * as script/VM time. Nested scopes pause the enclosing one, so the
+ * categories of a frame always add up to its total duration.
+ *
+ * A frame ends whenever the backend presents the screen. The collector
+ * is inactive (and all scopes are no-ops) until a backend starts it with
+ * a real-time clock, which must keep running regardless of any virtual
+ * time the engine sees.
+ */
+class Benchmark : public Singleton<Benchmark> {
+	friend class Singleton<SingletonBaseType>;
+	Benchmark();
+
+public:
+	enum Category {
+		kCategoryScript = 0,	///< game logic and script VM, i.e. anything not covered below
+		kCategoryRendering,		///< engine side drawing and compositing
+		kCategoryScaling,		///< backend scalers and screen conversion
+		kCategoryAudio,			///< audio mixing and sample rate conversion
+		kCategoryCount
+	};
+
+	/** Returns a monotonic real-time clock value, in microseconds. */
+	typedef uint32 (*ClockProc)();
+
+	/** The time spent in each category during one frame, in microseconds. */
+	struct Frame {
+		uint32 time[kCategoryCount];
+
+		uint32 getTotal() const;
+	};
+
+	/**
+	 * Start collecting, discarding any previously collected frames.
+	 */
+	void start(ClockProc clock);
+
+	/**
+	 * Stop collecting. The frames collected so far remain available.
+	 */
+	void stop();
+
+	bool isActive() const { return _clock != 0; }
+
+	/**
+	 * Attribute time to the given category from now on.
+	 * @return the category which was active before
+	 */
+	Category enter(Category category);
+
+	/**
+	 * Close the current frame and start a new one.
+	 */
+	void endFrame();
+
+	const Array<Frame> &getFrames() const { return _frames; }
+
+	/**
+	 * Return a human readable summary (average, 95th percentile and
+	 * maximum per category) of the collected frames.
+	 */
+	String getReport() const;
+
+	/**
+	 * Write all collected frames as CSV, one line per frame.
+	 */
+	void writeFrames(WriteStream &stream) const;
+
+	static const char *getCategoryName(Category category);
+
+private:
+	void flush();
+
+	ClockProc _clock;
+	Category _current;
+	uint32 _lastSwitch;
+	Frame _frame;
+	Array<Frame> _frames;
+};
+
+/**
+ * Attributes the time spent until the end of the enclosing C++ scope to a
+ * benchmark category.
+ */
+class BenchmarkScope {
+public:
+	BenchmarkScope(Benchmark::Category category) : _active(g_benchmark.isActive()), _previous(Benchmark::kCategoryScript) {
+		if (_active)
+			_previous = g_benchmark.enter(category);
+	}
+
+	~BenchmarkScope() {
+		if (_active)
+			g_benchmark.enter(_previous);
+	}
+
+private:
+	bool _active;
+	Benchmark::Category _previous;
+};
+
+} // End of namespace Common
+
+#endif
@@ -28,6 +28,8 @@
 #include "common/scummsys.h"
 #include "common/textconsole.h"
 #include "common/stream.h"
+#include "common/types.h"
+#include "common/util.h"
 
 namespace Common {
 
@@ -67,6 +69,9 @@ public:
 	/** Add a bit to the value x, making it an n+1-bit value. */
 	virtual void addBit(uint32 &x, uint32 n) = 0;
 
+	/** Are the bits of each value read from the MSB to the LSB? */
+	virtual bool isMSBFirst() const = 0;
+
 protected:
 	BitStream() {
 	}
@@ -75,103 +80,163 @@ protected:
 /**
  * A template implementing a bit stream for different data memory layouts.
  *
- * Such a bit stream reads valueBits-wide values from the data stream and
- * gives access to their bits, one at a time.
+ * Such a bit stream reads valueBits-wide values from the data and gives
+ * access to their bits.
  *
  * For example, a bit stream with the layout parameters 32, true, false
  * for valueBits, isLE and isMSB2LSB, reads 32bit little-endian values
- * from the data stream and hands out the bits in the order of LSB to MSB.
+ * from the data and hands out the bits in the order of LSB to MSB.
+ *
+ * The data is either read from a stream, one value at a time when its bits
+ * are needed, or straight from a buffer in memory. The bits are kept in a
+ * 64 bit cache, so that getBits(), peekBits() and skip() take the bits of
+ * several values at once.
  */
 template<int valueBits, bool isLE, bool isMSB2LSB>
 class BitStreamImpl : public BitStream {
 private:
-	SeekableReadStream *_stream; ///< The input stream.
-	bool _disposeAfterUse;       ///< Should we delete the stream on destruction?
+	SeekableReadStream *_stream; ///< The input stream, if not reading from memory.
+	bool _disposeAfterUse;       ///< Should we delete the stream, or free the memory, on destruction?
+
+	const byte *_data; ///< The input data, if not reading from a stream.
+	const byte *_ptr;  ///< The next value in the input data.
 
-	uint32 _value;   ///< Current value.
-	uint8  _inValue; ///< Position within the current value.
+	uint32 _size; ///< The size of the data in bits, in whole values.
+	uint32 _pos;  ///< The position in bits.
+
+	/**
+	 * The bits read ahead. For MSB2LSB streams, the next bit is the MSB,
+	 * otherwise the LSB. The other bits are 0.
+	 */
+	uint64 _cache;
+	uint8 _cacheBits; ///< Number of bits in the cache.
 
 	/** Read a data value. */
 	inline uint32 readData() {
-		if (isLE) {
-			if (valueBits ==  8)
-				return _stream->readByte();
-			if (valueBits == 16)
-				return _stream->readUint16LE();
-			if (valueBits == 32)
-				return _stream->readUint32LE();
-		} else {
-			if (valueBits ==  8)
-				return _stream->readByte();
-			if (valueBits == 16)
-				return _stream->readUint16BE();
-			if (valueBits == 32)
-				return _stream->readUint32BE();
+		if (_data) {
+			uint32 v;
+			if (valueBits == 8)
+				v = *_ptr;
+			else if (valueBits == 16)
+				v = isLE ? READ_LE_UINT16(_ptr) : READ_BE_UINT16(_ptr);
+			else
+				v = isLE ? READ_LE_UINT32(_ptr) : READ_BE_UINT32(_ptr);
+
+			_ptr += valueBits / 8;
+			return v;
 		}
 
-		assert(false);
-		return 0;
+		uint32 v;
+		if (valueBits == 8)
+			v = _stream->readByte();
+		else if (valueBits == 16)
+			v = isLE ? _stream->readUint16LE() : _stream->readUint16BE();
+		else
+			v = isLE ? _stream->readUint32LE() : _stream->readUint32BE();
+
+		if (_stream->err() || _stream->eos())
+			error("BitStreamImpl::readData(): Read error");
+
+		return v;
 	}
 
-	/** Read the next data value. */
-	inline void readValue() {
-		if ((size() - pos()) < valueBits)
-			error("BitStreamImpl::readValue(): End of bit stream reached");
+	/**
+	 * Fill the cache with at least n bits, unless the data ends first. From
+	 * memory, as many values as fit are read, from a stream only the ones
+	 * needed.
+	 */
+	inline void refill(uint8 n) {
+		uint32 end = _pos + _cacheBits;
 
-		_value = readData();
-		if (_stream->err() || _stream->eos())
-			error("BitStreamImpl::readValue(): Read error");
+		while ((_cacheBits < n || (_data && _cacheBits <= 64 - valueBits)) && (_size - end) >= valueBits) {
+			const uint64 v = readData();
 
-		// If we're reading the bits MSB first, we need to shift the value to that position
-		if (isMSB2LSB)
-			_value <<= 32 - valueBits;
+			if (isMSB2LSB)
+				_cache |= v << (64 - valueBits - _cacheBits);
+			else
+				_cache |= v << _cacheBits;
+
+			_cacheBits += valueBits;
+			end += valueBits;
 		}
+	}
+
+	/** Drop n bits, all in the cache, from it. */
+	inline void dropBits(uint8 n) {
+		if (n == 64)
+			_cache = 0;
+		else if (isMSB2LSB)
+			_cache <<= n;
+		else
+			_cache >>= n;
+
+		_cacheBits -= n;
+		_pos += n;
+	}
+
+	/** Take n bits, all in the cache, from it. */
+	inline uint32 takeBits(uint8 n) {
+		const uint32 v = peekCache(n);
+		dropBits(n);
+		return v;
+	}
+
+	/** Return the first n bits of the cache, 0 for the ones past its end. */
+	inline uint32 peekCache(uint8 n) const {
+		if (n == 0)
+			return 0;
+
+		if (isMSB2LSB)
+			return (uint32)(_cache >> (64 - n));
+		else
+			return (uint32)(_cache & ((((uint64)1) << n) - 1));
+	}
+
+	void init(uint32 byteSize) {
+		if ((valueBits != 8) && (valueBits != 16) && (valueBits != 32))
+			error("BitStreamImpl: Invalid memory layout %d, %d, %d", valueBits, isLE, isMSB2LSB);
+
+		_size = (byteSize & ~((uint32) ((valueBits >> 3) - 1))) * 8;
+		_pos = _stream ? (_stream->pos() * 8) : 0;
+		_cache = 0;
+		_cacheBits = 0;
+	}
 
 public:
 	/** Create a bit stream using this input data stream and optionally delete it on destruction. */
 	BitStreamImpl(SeekableReadStream *stream, bool disposeAfterUse = false) :
-		_stream(stream), _disposeAfterUse(disposeAfterUse), _value(0), _inValue(0) {
+		_stream(stream), _disposeAfterUse(disposeAfterUse), _data(0), _ptr(0) {
 
-		if ((valueBits != 8) && (valueBits != 16) && (valueBits != 32))
-			error("BitStreamImpl: Invalid memory layout %d, %d, %d", valueBits, isLE, isMSB2LSB);
+		init(_stream->size());
 	}
 
 	/** Create a bit stream using this input data stream. */
 	BitStreamImpl(SeekableReadStream &stream) :
-		_stream(&stream), _disposeAfterUse(false), _value(0), _inValue(0) {
+		_stream(&stream), _disposeAfterUse(false), _data(0), _ptr(0) {
 
-		if ((valueBits != 8) && (valueBits != 16) && (valueBits != 32))
-			error("BitStreamImpl: Invalid memory layout %d, %d, %d", valueBits, isLE, isMSB2LSB);
+		init(_stream->size());
+	}
+
+	/**
+	 * Create a bit stream reading straight from memory, which is much faster
+	 * than through a stream, and optionally free() the memory on destruction.
+	 */
+	BitStreamImpl(const byte *data, uint32 size, DisposeAfterUse::Flag disposeAfterUse = DisposeAfterUse::NO) :
+		_stream(0), _disposeAfterUse(disposeAfterUse == DisposeAfterUse::YES), _data(data), _ptr(data) {
+
+		init(size);
 	}
 
 	~BitStreamImpl() {
-		if (_disposeAfterUse)
+		if (_disposeAfterUse) {
 			delete _stream;
+			free(const_cast<byte *>(_data));
+		}
 	}
 
 	/** Read a bit from the bit stream. */
 	uint32 getBit() {
-		// Check if we need the next value
-		if (_inValue == 0)
-			readValue();
-
-		// Get the current bit
-		int b = 0;
-		if (isMSB2LSB)
-			b = ((_value & 0x80000000) == 0) ? 0 : 1;
-		else
-			b = ((_value & 1) == 0) ? 0 : 1;
-
-		// Shift to the next bit
-		if (isMSB2LSB)
-			_value <<= 1;
-		else
-			_value >>= 1;
-
-		// Increase the position within the current value
-		_inValue = (_inValue + 1) % valueBits;
-
-		return b;
+		return getBits(1);
 	}
 
 	/**
@@ -185,60 +250,38 @@ public:
 	 * If the bitstream is LSB2MSB, the 4-bit value would be 0011.
 	 */
 	uint32 getBits(uint8 n) {
-		if (n == 0)
-			return 0;
-
 		if (n > 32)
 			error("BitStreamImpl::getBits(): Too many bits requested to be read");
 
-		// Read the number of bits
-		uint32 v = 0;
+		if (_cacheBits < n) {
+			refill(n);
 
-		if (isMSB2LSB) {
-			while (n-- > 0)
-				v = (v << 1) | getBit();
-		} else {
-			for (uint32 i = 0; i < n; i++)
-				v = (v >> 1) | (((uint32) getBit()) << 31);
-
-			v >>= (32 - n);
+			if (_cacheBits < n)
+				error("BitStreamImpl::getBits(): End of bit stream reached");
 		}
 
-		return v;
+		return takeBits(n);
 	}
 
 	/** Read a bit from the bit stream, without changing the stream's position. */
 	uint32 peekBit() {
-		uint32 value   = _value;
-		uint8  inValue = _inValue;
-		uint32 curPos  = _stream->pos();
-
-		uint32 v = getBit();
-
-		_stream->seek(curPos);
-		_inValue = inValue;
-		_value   = value;
-
-		return v;
+		return peekBits(1);
 	}
 
 	/**
 	 * Read a multi-bit value from the bit stream, without changing the stream's position.
 	 *
-	 * The bit order is the same as in getBits().
+	 * The bit order is the same as in getBits(). Bits past the end of the
+	 * stream read as 0.
 	 */
 	uint32 peekBits(uint8 n) {
-		uint32 value   = _value;
-		uint8  inValue = _inValue;
-		uint32 curPos  = _stream->pos();
-
-		uint32 v = getBits(n);
+		if (n > 32)
+			error("BitStreamImpl::peekBits(): Too many bits requested to be read");
 
-		_stream->seek(curPos);
-		_inValue = inValue;
-		_value   = value;
+		if (_cacheBits < n)
+			refill(n);
 
-		return v;
+		return peekCache(n);
 	}
 
 	/**
@@ -262,36 +305,63 @@ public:
 			x = (x & ~(1 << n)) | (getBit() << n);
 	}
 
+	/** Are the bits of each value read from the MSB to the LSB? */
+	bool isMSBFirst() const {
+		return isMSB2LSB;
+	}
+
 	/** Rewind the bit stream back to the start. */
 	void rewind() {
-		_stream->seek(0);
+		if (_stream)
+			_stream->seek(0);
 
-		_value   = 0;
-		_inValue = 0;
+		_ptr = _data;
+		_pos = 0;
+		_cache = 0;
+		_cacheBits = 0;
 	}
 
 	/** Skip the specified amount of bits. */
 	void skip(uint32 n) {
-		while (n-- > 0)
-			getBit();
+		if (n <= _cacheBits) {
+			dropBits(n);
+			return;
+		}
+
+		if (n > _size - _pos)
+			error("BitStreamImpl::skip(): End of bit stream reached");
+
+		n -= _cacheBits;
+		dropBits(_cacheBits);
+
+		// Skip the whole values without reading them
+		const uint32 values = n / valueBits;
+		if (_data)
+			_ptr += values * (valueBits / 8);
+		else
+			_stream->skip(values * (valueBits / 8));
+
+		_pos += values * valueBits;
+		n -= values * valueBits;
+
+		if (n > 0) {
+			refill(n);
+			dropBits(n);
+		}
 	}
 
 	/** Return the stream position in bits. */
 	uint32 pos() const {
-		if (_stream->pos() == 0)
-			return 0;
-
-		uint32 p = (_inValue == 0) ? _stream->pos() : ((_stream->pos() - 1) & ~((uint32) ((valueBits >> 3) - 1)));
-		return p * 8 + _inValue;
+		return _pos;
 	}
 
 	/** Return the stream size in bits. */
 	uint32 size() const {
-		return (_stream->size() & ~((uint32) ((valueBits >> 3) - 1))) * 8;
+		return _size;
 	}
 
 	bool eos() const {
-		return _stream->eos() || (pos() >= size());
+		return _pos >= _size;
 	}
 };
 
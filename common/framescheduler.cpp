@@ -0,0 +1,102 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/framescheduler.h"
+
+namespace Common {
+
+FrameScheduler::FrameScheduler() {
+	reset(0);
+}
+
+void FrameScheduler::reset(uint32 now) {
+	_deadline = now;
+	_frameStart = now;
+	resetStats(now);
+}
+
+bool FrameScheduler::isDue(uint32 now) const {
+	// Compare through a signed difference so that wrap-around of the
+	// millisecond counter is handled.
+	return (int32)(now - _deadline) >= 0;
+}
+
+uint32 FrameScheduler::getDelay(uint32 now) const {
+	int32 delay = (int32)(_deadline - now);
+	return delay > 0 ? (uint32)delay : 0;
+}
+
+void FrameScheduler::beginFrame(uint32 now) {
+	int32 lateness = (int32)(now - _deadline);
+	if (lateness > 0) {
+		_stats.lateFrames++;
+		_stats.totalLateness += lateness;
+		if ((uint32)lateness > _stats.maxLateness)
+			_stats.maxLateness = lateness;
+	}
+
+	_frameStart = now;
+	_stats.elapsed = now - _statsStart;
+}
+
+void FrameScheduler::endFrame(uint32 now, uint32 delay) {
+	// Schedule relative to the previous deadline rather than to the
+	// actual start of the frame, so that late wake-ups do not accumulate.
+	// If we fell behind too far (e.g. the process was suspended), resync
+	// to the actual frame start instead.
+	uint32 base = _deadline;
+	if ((int32)(_frameStart - _deadline) > (int32)kMaxCatchUp || (int32)(_frameStart - _deadline) < 0)
+		base = _frameStart;
+
+	_deadline = base + delay;
+
+	_stats.frames++;
+	_stats.busyTime += now - _frameStart;
+	_stats.elapsed = now - _statsStart;
+}
+
+void FrameScheduler::resetStats(uint32 now) {
+	_statsStart = now;
+	_stats.frames = 0;
+	_stats.wakeUps = 0;
+	_stats.lateFrames = 0;
+	_stats.totalLateness = 0;
+	_stats.maxLateness = 0;
+	_stats.busyTime = 0;
+	_stats.elapsed = 0;
+}
+
+uint32 FrameScheduler::getFramesPerSecond100(uint32 now) const {
+	uint32 elapsed = now - _statsStart;
+	if (!elapsed)
+		return 0;
+	return (uint32)(_stats.frames * 100000.0 / elapsed);
+}
+
+uint32 FrameScheduler::getWakeUpsPerSecond(uint32 now) const {
+	uint32 elapsed = now - _statsStart;
+	if (!elapsed)
+		return 0;
+	return (uint32)(_stats.wakeUps * 1000.0 / elapsed);
+}
+
+} // End of namespace Common
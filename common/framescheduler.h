@@ -0,0 +1,131 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_FRAMESCHEDULER_H
+#define COMMON_FRAMESCHEDULER_H
+
+#include "common/scummsys.h"
+
+namespace Common {
+
+/**
+ * Deadline bookkeeping for a cooperatively driven engine main loop.
+ *
+ * The scheduler does not sleep or read the clock itself: the caller passes
+ * in the current time (usually OSystem::getMillis()) and is told how long
+ * it may sleep before the next frame is due. This lets a backend hand the
+ * delay to whatever primitive it has (a blocking delayMillis(), a browser
+ * timeout, ...), and lets tests drive it with a virtual clock.
+ *
+ * The engine reports after each frame how many milliseconds should pass
+ * until the next one. The resulting deadline is absolute, so wake-ups
+ * which come in a little late do not push all following frames back.
+ */
+class FrameScheduler {
+public:
+	/** Frame loop statistics since the last call to resetStats(). */
+	struct Stats {
+		uint32 frames;       ///< number of frames run
+		uint32 wakeUps;      ///< number of times the loop was resumed
+		uint32 lateFrames;   ///< frames started after their deadline
+		uint32 totalLateness; ///< sum of the lateness of all late frames, in ms
+		uint32 maxLateness;  ///< worst lateness of a single frame, in ms
+		uint32 busyTime;     ///< time spent inside frames, in ms
+		uint32 elapsed;      ///< time covered by these statistics, in ms
+	};
+
+	/**
+	 * Late frames are not made up for: if the loop falls behind by more
+	 * than this many milliseconds, the deadline is reset to the current
+	 * time instead of running a burst of frames to catch up.
+	 */
+	static const uint32 kMaxCatchUp = 100;
+
+	FrameScheduler();
+
+	/**
+	 * Restart the schedule, making the first frame due immediately.
+	 */
+	void reset(uint32 now);
+
+	/**
+	 * Return whether the next frame is due at the given time.
+	 */
+	bool isDue(uint32 now) const;
+
+	/**
+	 * Return the number of milliseconds the caller may sleep before the
+	 * next frame is due, or 0 if it is due already.
+	 */
+	uint32 getDelay(uint32 now) const;
+
+	/**
+	 * Register a wake-up of the loop, i.e. one invocation of the backend
+	 * callback or one return from a sleep.
+	 */
+	void wakeUp() { _stats.wakeUps++; }
+
+	/**
+	 * Mark the start of a frame.
+	 */
+	void beginFrame(uint32 now);
+
+	/**
+	 * Mark the end of a frame.
+	 * @param now	the current time
+	 * @param delay	number of milliseconds, counted from the start of the
+	 *              frame, until the next frame is due
+	 */
+	void endFrame(uint32 now, uint32 delay);
+
+	/** Return the absolute time at which the next frame is due. */
+	uint32 getDeadline() const { return _deadline; }
+
+	const Stats &getStats() const { return _stats; }
+
+	/**
+	 * Clear the statistics, starting a new measurement interval.
+	 */
+	void resetStats(uint32 now);
+
+	/**
+	 * Return the number of frames per second, multiplied by 100, over
+	 * the current measurement interval.
+	 */
+	uint32 getFramesPerSecond100(uint32 now) const;
+
+	/**
+	 * Return the number of wake-ups per second over the current
+	 * measurement interval.
+	 */
+	uint32 getWakeUpsPerSecond(uint32 now) const;
+
+private:
+	uint32 _deadline;
+	uint32 _frameStart;
+	uint32 _statsStart;
+	Stats _stats;
+};
+
+} // End of namespace Common
+
+#endif
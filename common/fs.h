@@ -205,6 +205,16 @@ public:
 	 */
 	bool isWritable() const;
 
+	/**
+	 * Retrieves the size and the time of the last modification of the file
+	 * referred by this node, without opening it. The time is only meant to
+	 * be compared against an earlier value, to find out whether the file
+	 * has changed. Not all file system backends support this.
+	 *
+	 * @return true if the status could be determined, false otherwise.
+	 */
+	bool getFileStatus(int32 &size, uint32 &modificationTime) const;
+
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
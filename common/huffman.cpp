@@ -29,9 +29,16 @@
 
 namespace Common {
 
-Huffman::Symbol::Symbol(uint32 c, uint32 s) : code(c), symbol(s) {
+Huffman::Symbol::Symbol(uint32 c, uint32 s, uint8 l) : code(c), symbol(s), length(l) {
 }
 
+/** Reverse the order of the lowest n bits of x. */
+static inline uint32 reverseBits(uint32 x, uint8 n) {
+	uint32 y = 0;
+	for (uint8 i = 0; i < n; i++, x >>= 1)
+		y = (y << 1) | (x & 1);
+	return y;
+}
 
 Huffman::Huffman(uint8 maxLength, uint32 codeCount, const uint32 *codes, const uint8 *lengths, const uint32 *symbols) {
 	assert(codeCount > 0);
@@ -39,9 +46,12 @@ Huffman::Huffman(uint8 maxLength, uint32 codeCount, const uint32 *codes, const u
 	assert(codes);
 	assert(lengths);
 
+	_maxLength = 0;
+	for (uint32 i = 0; i < codeCount; i++)
+		_maxLength = MAX(_maxLength, lengths[i]);
+
 	if (maxLength == 0)
-		for (uint32 i = 0; i < codeCount; i++)
-			maxLength = MAX(maxLength, lengths[i]);
+		maxLength = _maxLength;
 
 	assert(maxLength <= 32);
 
@@ -53,7 +63,7 @@ Huffman::Huffman(uint8 maxLength, uint32 codeCount, const uint32 *codes, const u
 		uint32 symbol = symbols ? symbols[i] : i;
 
 		// Put the code and symbol into the correct list
-		_codes[lengths[i] - 1].push_back(Symbol(codes[i], symbol));
+		_codes[lengths[i] - 1].push_back(Symbol(codes[i], symbol, lengths[i]));
 
 		// And put the pointer to the symbol/code struct into the symbol list.
 		_symbols[i] = &_codes[lengths[i] - 1].back();
@@ -64,19 +74,113 @@ Huffman::~Huffman() {
 }
 
 void Huffman::setSymbols(const uint32 *symbols) {
+	// The tables point to the symbols, so they stay valid
 	for (uint32 i = 0; i < _symbols.size(); i++)
 		_symbols[i]->symbol = symbols ? *symbols++ : i;
 }
 
+void Huffman::buildTable(Table &table, bool msb2lsb) const {
+	// All codes, shortest first, so that a code prefixed by a shorter one
+	// decodes to the shorter one, as when reading a bit at a time
+	SymbolList codes;
+	for (uint32 i = 0; i < _codes.size(); i++)
+		for (CodeList::const_iterator cCode = _codes[i].begin(); cCode != _codes[i].end(); ++cCode)
+			codes.push_back(const_cast<Symbol *>(&*cCode));
+
+	const uint8 width = MIN<uint8>(_maxLength, kTableBits);
+
+	table.resize(1 << width);
+	buildSubTable(table, msb2lsb, 0, width, 0, codes);
+}
+
+void Huffman::buildSubTable(Table &table, bool msb2lsb, uint32 offset, uint8 width, uint8 consumed, const SymbolList &codes) const {
+	// The tables are indexed by the bits in the order they are read, which
+	// for streams read LSB to MSB is the reverse of the order of the codes
+	Array<uint8> longest;
+	longest.resize(1 << width);
+
+	for (uint32 i = 0; i < codes.size(); i++) {
+		const Symbol *s = codes[i];
+		const uint8 length = s->length - consumed;
+
+		uint32 code = msb2lsb ? s->code : reverseBits(s->code, s->length);
+		if (length < 32)
+			code &= (1U << length) - 1;
+
+		if (length > width) {
+			const uint32 prefix = code >> (length - width);
+			longest[prefix] = MAX<uint8>(longest[prefix], length - width);
+			continue;
+		}
+
+		// Every index starting with the code decodes to it
+		const uint32 first = code << (width - length);
+		for (uint32 j = 0; j < (1U << (width - length)); j++) {
+			TableEntry &entry = table[offset + (msb2lsb ? first + j : reverseBits(first + j, width))];
+			if (!entry.symbol) {
+				entry.symbol = s;
+				entry.length = length;
+			}
+		}
+	}
+
+	for (uint32 prefix = 0; prefix < longest.size(); prefix++) {
+		if (!longest[prefix])
+			continue;
+
+		const uint32 index = offset + (msb2lsb ? prefix : reverseBits(prefix, width));
+		if (table[index].symbol)
+			continue;
+
+		SymbolList subCodes;
+		for (uint32 i = 0; i < codes.size(); i++) {
+			const Symbol *s = codes[i];
+			const uint8 length = s->length - consumed;
+			if (length <= width)
+				continue;
+
+			const uint32 code = msb2lsb ? s->code : reverseBits(s->code, s->length);
+			if (((code >> (length - width)) & ((1U << width) - 1)) == prefix)
+				subCodes.push_back(codes[i]);
+		}
+
+		const uint8 subWidth = MIN<uint8>(longest[prefix], kTableBits);
+		const uint32 subOffset = table.size();
+
+		table.resize(subOffset + (1 << subWidth));
+		table[index].next = subOffset;
+		table[index].length = subWidth;
+
+		buildSubTable(table, msb2lsb, subOffset, subWidth, consumed + width, subCodes);
+	}
+}
+
 uint32 Huffman::getSymbol(BitStream &bits) const {
-	uint32 code = 0;
+	const bool msb2lsb = bits.isMSBFirst();
 
-	for (uint32 i = 0; i < _codes.size(); i++) {
-		bits.addBit(code, i);
+	Table &table = _tables[msb2lsb ? 1 : 0];
+	if (table.empty())
+		buildTable(table, msb2lsb);
 
-		for (CodeList::const_iterator cCode = _codes[i].begin(); cCode != _codes[i].end(); ++cCode)
-			if (code == cCode->code)
-				return cCode->symbol;
+	uint32 offset = 0;
+	uint8 width = MIN<uint8>(_maxLength, kTableBits);
+
+	for (;;) {
+		const TableEntry &entry = table[offset + bits.peekBits(width)];
+
+		// Near the end of the stream, the bits peeked past it are 0, so
+		// this still finds the code, if it is complete
+		if (entry.symbol) {
+			bits.skip(entry.length);
+			return entry.symbol->symbol;
+		}
+
+		if (!entry.length)
+			break;
+
+		bits.skip(width);
+		offset = entry.next;
+		width = entry.length;
 	}
 
 	error("Unknown Huffman code");
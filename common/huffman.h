@@ -36,6 +36,11 @@ class BitStream;
 /**
  * Huffman bitstream decoding
  *
+ * Symbols are decoded through lookup tables indexed by the next bits of the
+ * stream: a primary table for the first kTableBits bits, which resolves all
+ * the short codes at once, and secondary tables for the longer ones. The
+ * tables are built on first use, for the bit order of the stream decoded.
+ *
  * Used in engines:
  *  - scumm
  */
@@ -59,13 +64,32 @@ public:
 	uint32 getSymbol(BitStream &bits) const;
 
 private:
+	enum {
+		kTableBits = 9 ///< Width of the primary, and the maximal width of the secondary tables
+	};
+
 	struct Symbol {
 		uint32 code;
 		uint32 symbol;
+		uint8 length;
+
+		Symbol(uint32 c, uint32 s, uint8 l);
+	};
 
-		Symbol(uint32 c, uint32 s);
+	/**
+	 * An entry of a lookup table. Either a symbol, with the number of bits
+	 * its code takes from this table's index, or a link to the table
+	 * resolving the longer codes starting with this index, or neither
+	 * for an invalid code.
+	 */
+	struct TableEntry {
+		const Symbol *symbol;
+		uint32 next;   ///< Offset of the secondary table
+		uint8 length;  ///< Length of the code, or width of the secondary table's index
 	};
 
+	typedef Array<TableEntry> Table;
+
 	typedef List<Symbol> CodeList;
 	typedef Array<CodeList> CodeLists;
 	typedef Array<Symbol *> SymbolList;
@@ -75,6 +99,14 @@ private:
 
 	/** Sorted list of pointers to the symbols. */
 	SymbolList _symbols;
+
+	uint8 _maxLength;
+
+	/** The lookup tables for streams read LSB to MSB and MSB to LSB, all in one array each. */
+	mutable Table _tables[2];
+
+	void buildTable(Table &table, bool msb2lsb) const;
+	void buildSubTable(Table &table, bool msb2lsb, uint32 offset, uint8 width, uint8 consumed, const SymbolList &codes) const;
 };
 
 } // End of namespace Common
@@ -2,6 +2,7 @@ MODULE := common
 
 MODULE_OBJS := \
 	archive.o \
+	benchmark.o \
 	config-file.o \
 	config-manager.o \
 	coroutines.o \
@@ -12,6 +13,7 @@ MODULE_OBJS := \
 	EventMapper.o \
 	EventRecorder.o \
 	file.o \
+	framescheduler.o \
 	fs.o \
 	gui_options.o \
 	hashmap.o \
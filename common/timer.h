@@ -49,11 +49,42 @@ public:
 	 */
 	virtual bool installTimerProc(TimerProc proc, int32 interval, void *refCon, const Common::String &id) = 0;
 
+	/**
+	 * Install a new timer callback which may take a long time to run, e.g.
+	 * because it feeds a MIDI device. Where the backend supports it, such a
+	 * callback is run in a thread of its own, so it does not delay the other
+	 * timers. Otherwise this is the same as installTimerProc().
+	 *
+	 * @note Removing such a callback from within the callback itself is not
+	 *       supported.
+	 * @see installTimerProc
+	 */
+	virtual bool installDedicatedTimerProc(TimerProc proc, int32 interval, void *refCon, const Common::String &id) {
+		return installTimerProc(proc, interval, refCon, id);
+	}
+
 	/**
 	 * Remove the given timer callback. It will not be invoked anymore,
 	 * and no instance of this callback will be running anymore.
 	 */
 	virtual void removeTimerProc(TimerProc proc) = 0;
+
+	/**
+	 * Statistics about the invocations of a timer callback.
+	 */
+	struct TimerStats {
+		uint32 calls;		///< number of invocations so far
+		uint32 overruns;	///< number of invocations which were more than one interval late
+		uint32 maxLateness;	///< largest delay of an invocation after its deadline, in milliseconds
+	};
+
+	/**
+	 * Retrieve the statistics of the given timer callback.
+	 *
+	 * @return true if the timer is installed and the timer manager keeps
+	 *         statistics, false otherwise
+	 */
+	virtual bool getTimerStats(TimerProc proc, TimerStats &stats) { return false; }
 };
 
 } // End of namespace Common
@@ -105,6 +105,9 @@ typedef struct {
 #include "common/fs.h"
 #include "common/unzip.h"
 #include "common/memstream.h"
+#include "common/ptr.h"
+#include "common/substream.h"
+#include "common/textconsole.h"
 
 #include "common/hashmap.h"
 #include "common/hash-str.h"
@@ -379,6 +382,7 @@ typedef Common::HashMap<Common::String, cached_file_in_zip, Common::IgnoreCase_H
 */
 typedef struct {
 	Common::SeekableReadStream *_stream;				/* io structore of the zipfile */
+	Common::SharedPtr<Common::SeekableReadStream> _sharedStream;	/* owns _stream, shared with the member streams */
 	unz_global_info gi;				/* public global information */
 	uLong byte_before_the_zipfile;	/* byte before the zipfile, (>0 for sfx)*/
 	uLong num_file;					/* number of the current file in the zipfile*/
@@ -541,6 +545,7 @@ unzFile unzOpen(Common::SeekableReadStream *stream) {
 	int err=UNZ_OK;
 
 	us->_stream = stream;
+	us->_sharedStream = Common::SharedPtr<Common::SeekableReadStream>(stream);
 
 	central_pos = unzlocal_SearchCentralDir(*us->_stream);
 	if (central_pos==0)
@@ -592,7 +597,6 @@ unzFile unzOpen(Common::SeekableReadStream *stream) {
 		err=UNZ_BADZIPFILE;
 
 	if (err != UNZ_OK) {
-		delete us->_stream;
 		delete us;
 		return NULL;
 	}
@@ -641,7 +645,7 @@ int unzClose(unzFile file) {
 	if (s->pfile_in_zip_read != NULL)
 		unzCloseCurrentFile(file);
 
-	delete s->_stream;
+	// The stream is freed once the last member stream using it is gone
 	delete s;
 	return UNZ_OK;
 }
@@ -1450,6 +1454,255 @@ public:
 };
 */
 
+namespace {
+
+/**
+ * Verifies the CRC of a member while it is read from start to end. Reads
+ * after seeking elsewhere are not checked.
+ */
+class ZipCrcChecker {
+public:
+	ZipCrcChecker(uint32 expected, uint32 size) : _expected(expected), _size(size), _crc(0), _pos(0) {}
+
+	/** @return false if this completed the member and the CRC did not match */
+	bool update(uint32 pos, const void *data, uint32 dataSize) {
+#ifdef USE_ZLIB
+		if (pos != _pos || !dataSize)
+			return true;
+
+		_crc = crc32(_crc, (const Bytef *)data, dataSize);
+		_pos += dataSize;
+		return _pos != _size || _crc == _expected;
+#else
+		return true;
+#endif
+	}
+
+private:
+	const uint32 _expected;
+	const uint32 _size;
+	uLong _crc;
+	uint32 _pos;
+};
+
+/**
+ * A stored (uncompressed) member, read directly from the archive.
+ */
+class ZipStoredReadStream : public SafeSeekableSubReadStream {
+public:
+	ZipStoredReadStream(const SharedPtr<SeekableReadStream> &archive, uint32 begin, uint32 size, uint32 crc)
+		: SafeSeekableSubReadStream(archive.get(), begin, begin + size), _archive(archive), _crc(crc, size), _err(false) {
+	}
+
+	bool err() const { return _err || SafeSeekableSubReadStream::err(); }
+	void clearErr() {
+		_err = false;
+		SafeSeekableSubReadStream::clearErr();
+	}
+
+	uint32 read(void *dataPtr, uint32 dataSize) {
+		const uint32 pos = this->pos();
+		dataSize = SafeSeekableSubReadStream::read(dataPtr, dataSize);
+		if (!_crc.update(pos, dataPtr, dataSize)) {
+			warning("ZipStoredReadStream: CRC mismatch");
+			_err = true;
+		}
+		return dataSize;
+	}
+
+private:
+	SharedPtr<SeekableReadStream> _archive;
+	ZipCrcChecker _crc;
+	bool _err;
+};
+
+#ifdef USE_ZLIB
+
+/**
+ * A deflated member, inflated on demand while it is read.
+ *
+ * Seeking forward just inflates and drops the data in between. To keep
+ * seeking backward affordable, the inflater state is saved every
+ * CHECKPOINT_INTERVAL bytes of output the first time the stream gets
+ * there, so it never has to restart further back than that.
+ */
+class ZipInflateReadStream : public SeekableReadStream {
+	enum {
+		BUFSIZE = 16384,
+		CHECKPOINT_INTERVAL = 256 * 1024
+	};
+
+	struct Checkpoint {
+		uint32 outPos;
+		uint32 inPos;
+		z_stream state;
+	};
+
+	SharedPtr<SeekableReadStream> _archive;
+	const uint32 _begin;
+	const uint32 _compressedSize;
+	const uint32 _size;
+
+	byte _buf[BUFSIZE];
+	z_stream _stream;
+	uint32 _inPos;	///< compressed bytes passed to zlib, including the ones still in _buf
+	uint32 _pos;
+	bool _eos;
+	bool _err;
+
+	Array<Checkpoint *> _checkpoints;
+	ZipCrcChecker _crc;
+
+public:
+	ZipInflateReadStream(const SharedPtr<SeekableReadStream> &archive, uint32 begin, uint32 compressedSize, uint32 size, uint32 crc)
+		: _archive(archive), _begin(begin), _compressedSize(compressedSize), _size(size),
+		  _stream(), _inPos(0), _pos(0), _eos(false), _err(false), _crc(crc, size) {
+		// No zlib header in zip members
+		_err = inflateInit2(&_stream, -MAX_WBITS) != Z_OK;
+		_stream.next_in = _buf;
+		_stream.avail_in = 0;
+	}
+
+	~ZipInflateReadStream() {
+		inflateEnd(&_stream);
+		for (uint i = 0; i < _checkpoints.size(); i++) {
+			inflateEnd(&_checkpoints[i]->state);
+			delete _checkpoints[i];
+		}
+	}
+
+	bool err() const { return _err; }
+	void clearErr() {
+		// only reset _eos; I/O and data errors are not recoverable
+		_eos = false;
+	}
+	bool eos() const { return _eos; }
+	int32 pos() const { return _pos; }
+	int32 size() const { return _size; }
+
+	uint32 read(void *dataPtr, uint32 dataSize) {
+		if (dataSize > _size - _pos) {
+			dataSize = _size - _pos;
+			_eos = true;
+		}
+		if (_err || !dataSize)
+			return 0;
+
+		_stream.next_out = (Bytef *)dataPtr;
+		_stream.avail_out = dataSize;
+
+		while (_stream.avail_out) {
+			if (!_stream.avail_in && _inPos < _compressedSize) {
+				const uint32 len = MIN<uint32>(BUFSIZE, _compressedSize - _inPos);
+				_archive->seek(_begin + _inPos, SEEK_SET);
+				if (_archive->read(_buf, len) != len) {
+					_err = true;
+					break;
+				}
+				_inPos += len;
+				_stream.next_in = _buf;
+				_stream.avail_in = len;
+			}
+
+			const uInt availOut = _stream.avail_out;
+			const int zlibErr = inflate(&_stream, Z_NO_FLUSH);
+
+			// Reaching the end before the expected size, errors, and running
+			// out of input all mean the member is corrupt.
+			if ((zlibErr == Z_STREAM_END && _stream.avail_out) ||
+			    (zlibErr != Z_OK && zlibErr != Z_STREAM_END && zlibErr != Z_BUF_ERROR) ||
+			    (zlibErr == Z_BUF_ERROR && _stream.avail_out == availOut && !_stream.avail_in)) {
+				warning("ZipInflateReadStream: Corrupt data");
+				_err = true;
+				break;
+			}
+		}
+
+		const uint32 actual = dataSize - _stream.avail_out;
+		if (!_crc.update(_pos, dataPtr, actual)) {
+			warning("ZipInflateReadStream: CRC mismatch");
+			_err = true;
+		}
+		_pos += actual;
+
+		if (!_err)
+			saveCheckpoint();
+
+		return actual;
+	}
+
+	bool seek(int32 offset, int whence = SEEK_SET) {
+		int32 newPos = offset;
+		if (whence == SEEK_CUR)
+			newPos += _pos;
+		else if (whence == SEEK_END)
+			newPos += _size;
+
+		if (newPos < 0 || (uint32)newPos > _size || _err)
+			return false;
+
+		// Restart from the closest checkpoint if it saves work
+		const Checkpoint *checkpoint = 0;
+		for (uint i = 0; i < _checkpoints.size() && _checkpoints[i]->outPos <= (uint32)newPos; i++)
+			checkpoint = _checkpoints[i];
+
+		if ((uint32)newPos < _pos || (checkpoint && checkpoint->outPos > _pos)) {
+			if (!restore(checkpoint))
+				return false;
+		}
+
+		byte tmpBuf[1024];
+		while (!_err && _pos < (uint32)newPos)
+			read(tmpBuf, MIN<uint32>(sizeof(tmpBuf), newPos - _pos));
+
+		_eos = false;
+		return !_err;
+	}
+
+private:
+	void saveCheckpoint() {
+		const uint32 last = _checkpoints.empty() ? 0 : _checkpoints.back()->outPos;
+		if (_pos < last + CHECKPOINT_INTERVAL || _pos == _size)
+			return;
+
+		Checkpoint *checkpoint = new Checkpoint();
+		if (inflateCopy(&checkpoint->state, &_stream) != Z_OK) {
+			delete checkpoint;
+			return;
+		}
+
+		// The input zlib already consumed is part of its state
+		checkpoint->outPos = _pos;
+		checkpoint->inPos = _inPos - _stream.avail_in;
+		_checkpoints.push_back(checkpoint);
+	}
+
+	bool restore(const Checkpoint *checkpoint) {
+		int zlibErr;
+		if (checkpoint) {
+			inflateEnd(&_stream);
+			zlibErr = inflateCopy(&_stream, const_cast<z_stream *>(&checkpoint->state));
+			_pos = checkpoint->outPos;
+			_inPos = checkpoint->inPos;
+		} else {
+			zlibErr = inflateReset(&_stream);
+			_pos = 0;
+			_inPos = 0;
+		}
+
+		_stream.next_in = _buf;
+		_stream.avail_in = 0;
+
+		if (zlibErr != Z_OK)
+			_err = true;
+		return !_err;
+	}
+};
+
+#endif
+
+} // End of anonymous namespace
+
 ZipArchive::ZipArchive(unzFile zipFile) : _zipFile(zipFile) {
 	assert(_zipFile);
 }
@@ -1486,32 +1739,27 @@ SeekableReadStream *ZipArchive::createReadStreamForMember(const String &name) co
 	if (unzLocateFile(_zipFile, name.c_str(), 2) != UNZ_OK)
 		return 0;
 
-	unz_file_info fileInfo;
+	// Let unzip validate the member and find its data, but read the data
+	// ourselves so that only the requested parts are loaded and inflated.
 	if (unzOpenCurrentFile(_zipFile) != UNZ_OK)
 		return 0;
 
-	if (unzGetCurrentFileInfo(_zipFile, &fileInfo, NULL, 0, NULL, 0, NULL, 0) != UNZ_OK)
-		return 0;
-
-	byte *buffer = (byte *)malloc(fileInfo.uncompressed_size);
-	assert(buffer);
-
-	if (unzReadCurrentFile(_zipFile, buffer, fileInfo.uncompressed_size) != (int)fileInfo.uncompressed_size) {
-		free(buffer);
-		return 0;
-	}
+	const unz_s *const archive = (const unz_s *)_zipFile;
+	const file_in_zip_read_info_s *const member = archive->pfile_in_zip_read;
+	const unz_file_info &info = archive->cur_file_info;
+	const uint32 begin = member->pos_in_zipfile + member->byte_before_the_zipfile;
 
-	if (unzCloseCurrentFile(_zipFile) != UNZ_OK) {
-		free(buffer);
+	if (unzCloseCurrentFile(_zipFile) != UNZ_OK)
 		return 0;
-	}
 
-	return new MemoryReadStream(buffer, fileInfo.uncompressed_size, DisposeAfterUse::YES);
+	if (info.compression_method == 0)
+		return new ZipStoredReadStream(archive->_sharedStream, begin, info.uncompressed_size, info.crc);
 
-	// FIXME: instead of reading all into a memory stream, we could
-	// instead create a new ZipStream class. But then we have to be
-	// careful to handle the case where the client code opens multiple
-	// files in the archive and tries to use them independently.
+#ifdef USE_ZLIB
+	return new ZipInflateReadStream(archive->_sharedStream, begin, info.compressed_size, info.uncompressed_size, info.crc);
+#else
+	return 0;
+#endif
 }
 
 Archive *makeZipArchive(const String &name) {
@@ -0,0 +1,671 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/*
+ * Bink microbenchmark: decodes synthetic Bink videos with Video::BinkDecoder
+ * and prints the frames decoded per second in the fastest of repeated
+ * passes, including the conversion to RGB. The videos use every 8x8 block
+ * type, with random DCT coefficients, residues and motion vectors. The
+ * checksum of the decoded frames allows checking that optimizations of the
+ * decoder do not change its output.
+ *
+ * Usage: binkbench [seconds per video]
+ */
+
+// This is a standalone program, which may use the standard library freely
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "common/array.h"
+#include "common/endian.h"
+#include "common/math.h"
+#include "common/memstream.h"
+#include "common/system.h"
+
+#include "graphics/surface.h"
+
+#include "video/bink_decoder.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+enum {
+	kFrameCount = 30
+};
+
+/**
+ * Just enough of an OSystem for the decoder: a clock, and mutexes which
+ * do nothing, as the benchmark runs in a single thread.
+ */
+class BenchSystem : public OSystem {
+public:
+	virtual uint32 getMillis() { return (uint32)((uint64)clock() * 1000 / CLOCKS_PER_SEC); }
+	virtual void delayMillis(uint msecs) {}
+
+	virtual MutexRef createMutex() { return 0; }
+	virtual void lockMutex(MutexRef mutex) {}
+	virtual void unlockMutex(MutexRef mutex) {}
+	virtual void deleteMutex(MutexRef mutex) {}
+
+	virtual const GraphicsMode *getSupportedGraphicsModes() const { return 0; }
+	virtual int getDefaultGraphicsMode() const { return 0; }
+	virtual bool setGraphicsMode(int mode) { return false; }
+	virtual int getGraphicsMode() const { return 0; }
+	virtual Graphics::PixelFormat getScreenFormat() const { return Graphics::PixelFormat::createFormatCLUT8(); }
+	virtual Common::List<Graphics::PixelFormat> getSupportedFormats() const { return Common::List<Graphics::PixelFormat>(); }
+	virtual void initSize(uint width, uint height, const Graphics::PixelFormat *format) {}
+	virtual int16 getHeight() { return 0; }
+	virtual int16 getWidth() { return 0; }
+	virtual PaletteManager *getPaletteManager() { return 0; }
+	virtual void copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) {}
+	virtual Graphics::Surface *lockScreen() { return 0; }
+	virtual void unlockScreen() {}
+	virtual void fillScreen(uint32 col) {}
+	virtual void updateScreen() {}
+	virtual void setShakePos(int shakeOffset) {}
+	virtual void showOverlay() {}
+	virtual void hideOverlay() {}
+	virtual Graphics::PixelFormat getOverlayFormat() const { return Graphics::PixelFormat::createFormatCLUT8(); }
+	virtual void clearOverlay() {}
+	virtual void grabOverlay(void *buf, int pitch) {}
+	virtual void copyRectToOverlay(const void *buf, int pitch, int x, int y, int w, int h) {}
+	virtual int16 getOverlayHeight() { return 0; }
+	virtual int16 getOverlayWidth() { return 0; }
+	virtual bool showMouse(bool visible) { return false; }
+	virtual void warpMouse(int x, int y) {}
+	virtual void setMouseCursor(const void *buf, uint w, uint h, int hotspotX, int hotspotY, uint32 keycolor, bool dontScale, const Graphics::PixelFormat *format) {}
+	virtual void getTimeAndDate(TimeDate &t) const {}
+	virtual Audio::Mixer *getMixer() { return 0; }
+	virtual void quit() {}
+	virtual void displayMessageOnOSD(const char *msg) {}
+	virtual void logMessage(LogMessageType::Type type, const char *message) {}
+};
+
+/** Writes bits the way BitStream32LELSB reads them. */
+class BitWriter {
+public:
+	BitWriter() : _cache(0), _cacheBits(0) {}
+
+	void put(uint32 value, int n) {
+		if (n < 32)
+			value &= (1 << n) - 1;
+
+		_cache |= (uint64)value << _cacheBits;
+		_cacheBits += n;
+
+		while (_cacheBits >= 32) {
+			for (int i = 0; i < 4; i++)
+				_data.push_back((_cache >> (8 * i)) & 0xFF);
+
+			_cache >>= 32;
+			_cacheBits -= 32;
+		}
+	}
+
+	/** Pad to a whole 32 bit value. */
+	void align() {
+		if (_cacheBits)
+			put(0, 32 - _cacheBits);
+	}
+
+	const Common::Array<byte> &getData() const { return _data; }
+
+private:
+	Common::Array<byte> _data;
+	uint64 _cache;
+	int _cacheBits;
+};
+
+/**
+ * Writes the frames of a Bink video. Every bundle uses the first Huffman
+ * tree, which codes the symbols as plain nibbles. The coefficients and
+ * residues are written by following the decoder, and making random choices
+ * wherever it reads a bit.
+ */
+class SyntheticBink {
+public:
+	SyntheticBink(uint32 width, uint32 height) : _width(width), _height(height), _seed(1) {}
+
+	/** Write a whole video, with the first frame a key frame. */
+	void write(Common::Array<byte> &data);
+
+private:
+	// The same as in the decoder
+	enum Source {
+		kSourceBlockTypes = 0,
+		kSourceSubBlockTypes,
+		kSourceColors,
+		kSourcePattern,
+		kSourceXOff,
+		kSourceYOff,
+		kSourceIntraDC,
+		kSourceInterDC,
+		kSourceRun,
+
+		kSourceMAX
+	};
+
+	enum BlockType {
+		kBlockSkip = 0,
+		kBlockScaled,
+		kBlockMotion,
+		kBlockRun,
+		kBlockResidue,
+		kBlockIntra,
+		kBlockFill,
+		kBlockInter,
+		kBlockPattern,
+		kBlockRaw
+	};
+
+	uint32 _width;
+	uint32 _height;
+	uint32 _seed;
+
+	int _countLengths[kSourceMAX];
+	bool _active[kSourceMAX];
+
+	uint32 random(uint32 n) {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 8) % n;
+	}
+
+	void writeFrame(BitWriter &bits, bool keyFrame);
+	void writePlane(BitWriter &bits, bool isChroma, bool keyFrame);
+	bool writeCount(BitWriter &bits, Source source, uint32 count);
+	void writeCoeff(BitWriter &bits, int magnitudeBits);
+	void writeDCTCoeffs(BitWriter &bits);
+	void writeResidue(BitWriter &bits, int masksCount);
+};
+
+void SyntheticBink::write(Common::Array<byte> &data) {
+	Common::Array<byte> frames[kFrameCount];
+	uint32 largestFrame = 0;
+
+	for (uint32 i = 0; i < kFrameCount; i++) {
+		BitWriter bits;
+		writeFrame(bits, i == 0);
+		frames[i] = bits.getData();
+		largestFrame = MAX<uint32>(largestFrame, frames[i].size());
+	}
+
+	const uint32 headerSize = 44 + 4 * kFrameCount;
+	uint32 fileSize = headerSize;
+	for (uint32 i = 0; i < kFrameCount; i++)
+		fileSize += frames[i].size();
+
+	data.resize(fileSize);
+	byte *ptr = data.begin();
+
+	WRITE_BE_UINT32(ptr, MKTAG('B', 'I', 'K', 'i')); ptr += 4;
+	WRITE_LE_UINT32(ptr, fileSize - 8); ptr += 4;
+	WRITE_LE_UINT32(ptr, kFrameCount); ptr += 4;
+	WRITE_LE_UINT32(ptr, largestFrame); ptr += 4;
+	WRITE_LE_UINT32(ptr, 0); ptr += 4;
+	WRITE_LE_UINT32(ptr, _width); ptr += 4;
+	WRITE_LE_UINT32(ptr, _height); ptr += 4;
+	WRITE_LE_UINT32(ptr, 30); ptr += 4; // Frame rate
+	WRITE_LE_UINT32(ptr, 1); ptr += 4;
+	WRITE_LE_UINT32(ptr, 0); ptr += 4; // Video flags
+	WRITE_LE_UINT32(ptr, 0); ptr += 4; // Audio tracks
+
+	uint32 offset = headerSize;
+	for (uint32 i = 0; i < kFrameCount; i++) {
+		WRITE_LE_UINT32(ptr, offset | (i == 0 ? 1 : 0)); ptr += 4;
+		offset += frames[i].size();
+	}
+
+	for (uint32 i = 0; i < kFrameCount; i++) {
+		memcpy(ptr, frames[i].begin(), frames[i].size());
+		ptr += frames[i].size();
+	}
+}
+
+void SyntheticBink::writeFrame(BitWriter &bits, bool keyFrame) {
+	// BIKi starts with the size of the first plane, which is skipped
+	bits.put(0, 32);
+
+	writePlane(bits, false, keyFrame);
+	writePlane(bits, true, keyFrame);
+	writePlane(bits, true, keyFrame);
+}
+
+void SyntheticBink::writePlane(BitWriter &bits, bool isChroma, bool keyFrame) {
+	const uint32 blockWidth  = isChroma ? ((_width  + 15) >> 4) : ((_width  + 7) >> 3);
+	const uint32 blockHeight = isChroma ? ((_height + 15) >> 4) : ((_height + 7) >> 3);
+
+	// As in BinkVideoTrack::initBundles()
+	const int width = MAX<uint32>(isChroma ? (_width >> 1) : _width, 8);
+	const uint32 colorBlocks = isChroma ? ((_width + 15) >> 4) : ((_width + 7) >> 3);
+
+	for (int i = 0; i < kSourceMAX; i++)
+		_countLengths[i] = Common::intLog2((width >> 3) + 511) + 1;
+	_countLengths[kSourceSubBlockTypes] = Common::intLog2(((width + 7) >> 4) + 511) + 1;
+	_countLengths[kSourceColors] = Common::intLog2(colorBlocks * 64 + 511) + 1;
+	_countLengths[kSourcePattern] = Common::intLog2((colorBlocks << 3) + 511) + 1;
+	_countLengths[kSourceRun] = Common::intLog2(colorBlocks * 48 + 511) + 1;
+
+	// The Huffman trees of the bundles, and of the high color nibbles
+	for (int i = 0; i < kSourceMAX; i++) {
+		if (i == kSourceColors)
+			for (int j = 0; j < 16; j++)
+				bits.put(0, 4);
+
+		if (i != kSourceIntraDC && i != kSourceInterDC)
+			bits.put(0, 4);
+
+		_active[i] = true;
+	}
+
+	// Every row uses all of these block types, so that the bundles the plane
+	// uses have values for every row
+	static const BlockType keyTypes[] = { kBlockIntra, kBlockFill, kBlockPattern, kBlockRaw };
+	static const BlockType interTypes[] = { kBlockSkip, kBlockMotion, kBlockInter, kBlockIntra,
+		kBlockFill, kBlockPattern, kBlockRaw, kBlockResidue };
+
+	Common::Array<BlockType> types;
+	Common::Array<byte> colors, patterns;
+	Common::Array<int> xOffs, yOffs;
+
+	for (uint32 y = 0; y < blockHeight; y++) {
+		types.clear();
+		colors.clear();
+		patterns.clear();
+		xOffs.clear();
+		yOffs.clear();
+		uint32 intraCount = 0, interCount = 0;
+
+		for (uint32 x = 0; x < blockWidth; x++) {
+			const BlockType type = keyFrame ? keyTypes[(x + y) % ARRAYSIZE(keyTypes)] : interTypes[(x + y) % ARRAYSIZE(interTypes)];
+			types.push_back(type);
+
+			switch (type) {
+			case kBlockMotion:
+			case kBlockResidue:
+			case kBlockInter:
+				// Stay within the previous frame
+				xOffs.push_back((int)random(x ? 7 : 4) - (x ? 3 : 0));
+				yOffs.push_back((int)random(y ? 7 : 4) - (y ? 3 : 0));
+				if (type == kBlockInter)
+					interCount++;
+				break;
+			case kBlockIntra:
+				intraCount++;
+				break;
+			case kBlockFill:
+				colors.push_back(random(256));
+				break;
+			case kBlockPattern:
+				colors.push_back(random(256));
+				colors.push_back(random(256));
+				for (int i = 0; i < 8; i++)
+					patterns.push_back(random(256));
+				break;
+			case kBlockRaw:
+				for (int i = 0; i < 64; i++)
+					colors.push_back(random(256));
+				break;
+			default:
+				break;
+			}
+		}
+
+		if (writeCount(bits, kSourceBlockTypes, types.size())) {
+			bits.put(0, 1);
+			for (uint32 i = 0; i < types.size(); i++)
+				bits.put(types[i], 4);
+		}
+
+		writeCount(bits, kSourceSubBlockTypes, 0);
+
+		if (writeCount(bits, kSourceColors, colors.size())) {
+			bits.put(0, 1);
+			for (uint32 i = 0; i < colors.size(); i++) {
+				bits.put(colors[i] >> 4, 4);
+				bits.put(colors[i] & 0xF, 4);
+			}
+		}
+
+		if (writeCount(bits, kSourcePattern, patterns.size())) {
+			for (uint32 i = 0; i < patterns.size(); i++) {
+				bits.put(patterns[i] & 0xF, 4);
+				bits.put(patterns[i] >> 4, 4);
+			}
+		}
+
+		for (int i = 0; i < 2; i++) {
+			const Common::Array<int> &offs = i ? yOffs : xOffs;
+			if (writeCount(bits, i ? kSourceYOff : kSourceXOff, offs.size())) {
+				bits.put(0, 1);
+				for (uint32 j = 0; j < offs.size(); j++) {
+					bits.put(ABS(offs[j]), 4);
+					if (offs[j])
+						bits.put(offs[j] < 0, 1);
+				}
+			}
+		}
+
+		// The DC values are all the same within a row
+		if (writeCount(bits, kSourceIntraDC, intraCount)) {
+			bits.put(256 + random(1024), 11);
+			for (uint32 i = 1; i < intraCount; i += 8)
+				bits.put(0, 4);
+		}
+
+		if (writeCount(bits, kSourceInterDC, interCount)) {
+			bits.put(1 + random(64), 10);
+			bits.put(random(2), 1);
+			for (uint32 i = 1; i < interCount; i += 8)
+				bits.put(0, 4);
+		}
+
+		writeCount(bits, kSourceRun, 0);
+
+		// The bits the blocks read themselves
+		for (uint32 x = 0; x < blockWidth; x++) {
+			if (types[x] == kBlockIntra || types[x] == kBlockInter) {
+				writeDCTCoeffs(bits);
+			} else if (types[x] == kBlockResidue) {
+				const int masksCount = 8 + random(32);
+				bits.put(masksCount, 7);
+				writeResidue(bits, masksCount);
+			}
+		}
+	}
+
+	bits.align();
+}
+
+bool SyntheticBink::writeCount(BitWriter &bits, Source source, uint32 count) {
+	// Once a bundle was given no values, the decoder stops reading it
+	if (!_active[source]) {
+		assert(count == 0);
+		return false;
+	}
+
+	bits.put(count, _countLengths[source]);
+	if (count == 0)
+		_active[source] = false;
+
+	return count != 0;
+}
+
+void SyntheticBink::writeCoeff(BitWriter &bits, int magnitudeBits) {
+	if (magnitudeBits)
+		bits.put(random(1 << magnitudeBits), magnitudeBits);
+	bits.put(random(2), 1);
+}
+
+void SyntheticBink::writeDCTCoeffs(BitWriter &bits) {
+	int listStart = 64;
+	int listEnd   = 64;
+
+	int coefList[128];      int modeList[128];
+	coefList[listEnd] = 4;  modeList[listEnd++] = 0;
+	coefList[listEnd] = 24; modeList[listEnd++] = 0;
+	coefList[listEnd] = 44; modeList[listEnd++] = 0;
+	coefList[listEnd] = 1;  modeList[listEnd++] = 3;
+	coefList[listEnd] = 2;  modeList[listEnd++] = 3;
+	coefList[listEnd] = 3;  modeList[listEnd++] = 3;
+
+	const int startBits = 1 + random(4);
+	bits.put(startBits, 4);
+
+	for (int magnitudeBits = startBits - 1; magnitudeBits >= 0; magnitudeBits--) {
+		int listPos = listStart;
+
+		while (listPos < listEnd) {
+			if (!(modeList[listPos] | coefList[listPos])) {
+				listPos++;
+				continue;
+			}
+
+			const bool decode = random(2);
+			bits.put(decode, 1);
+			if (!decode) {
+				listPos++;
+				continue;
+			}
+
+			int ccoef = coefList[listPos];
+			int mode  = modeList[listPos];
+
+			switch (mode) {
+			case 0:
+				coefList[listPos] = ccoef + 4;
+				modeList[listPos] = 1;
+				// fall through
+			case 2:
+				if (mode == 2) {
+					coefList[listPos]   = 0;
+					modeList[listPos++] = 0;
+				}
+				for (int i = 0; i < 4; i++, ccoef++) {
+					const bool later = random(2);
+					bits.put(later, 1);
+					if (later) {
+						coefList[--listStart] = ccoef;
+						modeList[  listStart] = 3;
+					} else {
+						writeCoeff(bits, magnitudeBits);
+					}
+				}
+				break;
+
+			case 1:
+				modeList[listPos] = 2;
+				for (int i = 0; i < 3; i++) {
+					ccoef += 4;
+					coefList[listEnd]   = ccoef;
+					modeList[listEnd++] = 2;
+				}
+				break;
+
+			case 3:
+				writeCoeff(bits, magnitudeBits);
+				coefList[listPos]   = 0;
+				modeList[listPos++] = 0;
+				break;
+			}
+		}
+	}
+
+	// Quantizer
+	bits.put(random(16), 4);
+}
+
+void SyntheticBink::writeResidue(BitWriter &bits, int masksCount) {
+	int nzCoeffCount = 0;
+
+	int listStart = 64;
+	int listEnd   = 64;
+
+	int coefList[128];      int modeList[128];
+	coefList[listEnd] =  4; modeList[listEnd++] = 0;
+	coefList[listEnd] = 24; modeList[listEnd++] = 0;
+	coefList[listEnd] = 44; modeList[listEnd++] = 0;
+	coefList[listEnd] =  0; modeList[listEnd++] = 2;
+
+	const int maskBits = random(4);
+	bits.put(maskBits, 3);
+
+	for (int mask = 1 << maskBits; mask; mask >>= 1) {
+		for (int i = 0; i < nzCoeffCount; i++) {
+			const bool refine = random(2);
+			bits.put(refine, 1);
+			if (refine && --masksCount < 0)
+				return;
+		}
+
+		int listPos = listStart;
+		while (listPos < listEnd) {
+			if (!(coefList[listPos] | modeList[listPos])) {
+				listPos++;
+				continue;
+			}
+
+			const bool decode = random(2);
+			bits.put(decode, 1);
+			if (!decode) {
+				listPos++;
+				continue;
+			}
+
+			int ccoef = coefList[listPos];
+			int mode  = modeList[listPos];
+
+			switch (mode) {
+			case 0:
+				coefList[listPos] = ccoef + 4;
+				modeList[listPos] = 1;
+				// fall through
+			case 2:
+				if (mode == 2) {
+					coefList[listPos]   = 0;
+					modeList[listPos++] = 0;
+				}
+
+				for (int i = 0; i < 4; i++, ccoef++) {
+					const bool later = random(2);
+					bits.put(later, 1);
+					if (later) {
+						coefList[--listStart] = ccoef;
+						modeList[  listStart] = 3;
+					} else {
+						nzCoeffCount++;
+						bits.put(random(2), 1);
+						if (--masksCount < 0)
+							return;
+					}
+				}
+				break;
+
+			case 1:
+				modeList[listPos] = 2;
+				for (int i = 0; i < 3; i++) {
+					ccoef += 4;
+					coefList[listEnd]   = ccoef;
+					modeList[listEnd++] = 2;
+				}
+				break;
+
+			case 3:
+				nzCoeffCount++;
+				bits.put(random(2), 1);
+				coefList[listPos]   = 0;
+				modeList[listPos++] = 0;
+				if (--masksCount < 0)
+					return;
+				break;
+			}
+		}
+	}
+}
+
+static Video::BinkDecoder *load(const Common::Array<byte> &data) {
+	Video::BinkDecoder *decoder = new Video::BinkDecoder();
+	if (!decoder->loadStream(new Common::MemoryReadStream(data.begin(), data.size()))) {
+		fprintf(stderr, "Could not load the synthetic video\n");
+		exit(1);
+	}
+	return decoder;
+}
+
+static uint32 checksum(const Common::Array<byte> &data) {
+	Video::BinkDecoder *decoder = load(data);
+	uint32 sum = 0;
+
+	while (!decoder->endOfVideo()) {
+		const Graphics::Surface *surface = decoder->decodeNextFrame();
+		for (int y = 0; y < surface->h; y++) {
+			const byte *row = (const byte *)surface->getBasePtr(0, y);
+			for (int x = 0; x < surface->w * surface->format.bytesPerPixel; x++)
+				sum = (sum << 1 | sum >> 31) ^ row[x];
+		}
+	}
+
+	delete decoder;
+	return sum;
+}
+
+/**
+ * Decode the video over and over, and return the frame rate of the fastest
+ * pass, which is the least disturbed by whatever else the machine does.
+ */
+static double run(const Common::Array<byte> &data, double seconds) {
+	const clock_t start = clock();
+	clock_t best = 0;
+	clock_t end;
+
+	do {
+		const clock_t passStart = clock();
+		Video::BinkDecoder *decoder = load(data);
+
+		while (!decoder->endOfVideo())
+			decoder->decodeNextFrame();
+
+		delete decoder;
+		end = clock();
+
+		if (!best || end - passStart < best)
+			best = MAX<clock_t>(end - passStart, 1);
+	} while (end - start < seconds * CLOCKS_PER_SEC);
+
+	return kFrameCount / ((double)best / CLOCKS_PER_SEC);
+}
+
+struct VideoSize {
+	uint32 width;
+	uint32 height;
+};
+
+static const VideoSize videoSizes[] = {
+	{ 640, 480 },
+	{ 1280, 720 },
+	{ 0, 0 }
+};
+
+int main(int argc, char *argv[]) {
+	const double seconds = (argc > 1) ? atof(argv[1]) : 1.0;
+
+	BenchSystem *system = new BenchSystem();
+	g_system = system;
+
+	printf("%-12s %10s %10s\n", "Size", "frames/s", "checksum");
+
+	for (const VideoSize *size = videoSizes; size->width; size++) {
+		Common::Array<byte> data;
+		SyntheticBink(size->width, size->height).write(data);
+
+		char name[16];
+		snprintf(name, sizeof(name), "%ux%u", size->width, size->height);
+
+		const uint32 sum = checksum(data);
+		printf("%-12s %10.1f   %08X\n", name, run(data, seconds), sum);
+	}
+
+	g_system = 0;
+	delete system;
+
+	return 0;
+}
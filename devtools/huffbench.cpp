@@ -0,0 +1,274 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/*
+ * Huffman microbenchmark: decodes synthetic bitstreams with Common::Huffman
+ * and with the bit at a time decoder it replaced, and prints the throughput
+ * of both in million symbols per second. The bits are read from a stream,
+ * and for Common::Huffman also straight from memory.
+ *
+ * Usage: huffbench [seconds per test]
+ */
+
+// This is a standalone program, which may use the standard library freely
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "common/bitstream.h"
+#include "common/huffman.h"
+#include "common/list.h"
+#include "common/memstream.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+enum {
+	kMaxSymbols = 256,
+	kSamples = 65536
+};
+
+/** The decoder Common::Huffman used before its lookup tables. */
+class LinearHuffman {
+public:
+	LinearHuffman(uint32 codeCount, const uint32 *codes, const uint8 *lengths) {
+		uint8 maxLength = 0;
+		for (uint32 i = 0; i < codeCount; i++)
+			maxLength = MAX(maxLength, lengths[i]);
+
+		_codes.resize(maxLength);
+		for (uint32 i = 0; i < codeCount; i++)
+			_codes[lengths[i] - 1].push_back(Symbol(codes[i], i));
+	}
+
+	uint32 getSymbol(Common::BitStream &bits) const {
+		uint32 code = 0;
+
+		for (uint32 i = 0; i < _codes.size(); i++) {
+			bits.addBit(code, i);
+
+			for (CodeList::const_iterator cCode = _codes[i].begin(); cCode != _codes[i].end(); ++cCode)
+				if (code == cCode->code)
+					return cCode->symbol;
+		}
+
+		return 0;
+	}
+
+private:
+	struct Symbol {
+		uint32 code;
+		uint32 symbol;
+
+		Symbol(uint32 c, uint32 s) : code(c), symbol(s) {}
+	};
+
+	typedef Common::List<Symbol> CodeList;
+
+	Common::Array<CodeList> _codes;
+};
+
+struct CodeSet {
+	const char *name;
+	uint32 count;
+	double skew; ///< Exponent of the power law the symbol frequencies follow
+};
+
+static const CodeSet codeSets[] = {
+	{ "16 flat", 16, 0.0 },
+	{ "16 bink", 16, 0.7 },
+	{ "16 skewed", 16, 1.5 },
+	{ "256 flat", 256, 0.0 },
+	{ "256 skewed", 256, 1.2 },
+	{ 0, 0, 0.0 }
+};
+
+/** Compute the code lengths of a Huffman code for the frequencies. */
+static void makeLengths(uint32 count, const double *freqs, uint8 *lengths) {
+	double weight[2 * kMaxSymbols];
+	int parent[2 * kMaxSymbols];
+	bool merged[2 * kMaxSymbols];
+
+	for (uint32 i = 0; i < count; i++) {
+		weight[i] = freqs[i];
+		merged[i] = false;
+	}
+
+	uint32 nodes = count;
+	for (uint32 n = 1; n < count; n++) {
+		int a = -1, b = -1;
+		for (uint32 i = 0; i < nodes; i++) {
+			if (merged[i])
+				continue;
+			if (a < 0 || weight[i] < weight[a]) {
+				b = a;
+				a = i;
+			} else if (b < 0 || weight[i] < weight[b]) {
+				b = i;
+			}
+		}
+
+		weight[nodes] = weight[a] + weight[b];
+		merged[nodes] = false;
+		merged[a] = merged[b] = true;
+		parent[a] = parent[b] = nodes;
+		nodes++;
+	}
+
+	for (uint32 i = 0; i < count; i++) {
+		lengths[i] = 0;
+		for (uint32 node = i; node != nodes - 1; node = parent[node])
+			lengths[i]++;
+	}
+}
+
+/** Assign canonical codes to the lengths. */
+static void makeCodes(uint32 count, const uint8 *lengths, uint32 *codes) {
+	uint32 code = 0;
+
+	for (uint8 length = 1; length <= 32; length++) {
+		for (uint32 i = 0; i < count; i++)
+			if (lengths[i] == length)
+				codes[i] = code++;
+		code <<= 1;
+	}
+}
+
+static uint32 reverseBits(uint32 x, uint8 n) {
+	uint32 y = 0;
+	for (uint8 i = 0; i < n; i++, x >>= 1)
+		y = (y << 1) | (x & 1);
+	return y;
+}
+
+/**
+ * Encode random symbols of the frequencies. For the streams read LSB to
+ * MSB, the codes are reversed, so they are read in the same order.
+ */
+static uint32 encode(uint32 count, const double *freqs, const uint32 *codes, const uint8 *lengths, bool msb2lsb, byte *data) {
+	double total = 0.0;
+	for (uint32 i = 0; i < count; i++)
+		total += freqs[i];
+
+	uint32 seed = 1;
+	uint32 bit = 0;
+
+	memset(data, 0, kSamples * 4);
+
+	for (uint32 n = 0; n < kSamples; n++) {
+		seed = seed * 1103515245 + 12345;
+		double r = (seed >> 8) / (double)(1 << 24) * total;
+
+		uint32 symbol = 0;
+		while (symbol < count - 1 && r >= freqs[symbol])
+			r -= freqs[symbol++];
+
+		for (int i = lengths[symbol] - 1; i >= 0; i--, bit++) {
+			if (!((codes[symbol] >> i) & 1))
+				continue;
+			if (msb2lsb)
+				data[bit >> 3] |= 0x80 >> (bit & 7);
+			else
+				data[bit >> 3] |= 1 << (bit & 7);
+		}
+	}
+
+	// The streams read whole 32 bit values
+	return ((bit + 31) / 32) * 4;
+}
+
+template<class Decoder, class Stream>
+static double run(const Decoder &decoder, const byte *data, uint32 size, bool fromMemory, double seconds) {
+	uint32 symbols = 0;
+	uint32 check = 0;
+	const clock_t start = clock();
+	clock_t end;
+
+	do {
+		Common::MemoryReadStream ms(data, size);
+		Stream *bits = fromMemory ? new Stream(data, size) : new Stream(ms);
+
+		for (uint32 n = 0; n < kSamples; n++)
+			check += decoder.getSymbol(*bits);
+
+		delete bits;
+
+		symbols += kSamples;
+		end = clock();
+	} while (end - start < seconds * CLOCKS_PER_SEC);
+
+	// Keep the decoding from being optimized away
+	if (check == 0xFFFFFFFF)
+		printf("\n");
+
+	return symbols / ((double)(end - start) / CLOCKS_PER_SEC) / 1000000.0;
+}
+
+int main(int argc, char *argv[]) {
+	const double seconds = (argc > 1) ? atof(argv[1]) : 1.0;
+
+	byte *data = new byte[kSamples * 4];
+
+	printf("%-12s %-8s %10s %10s %10s\n", "Codes", "Order", "old MSym/s", "new MSym/s", "memory");
+
+	for (const CodeSet *set = codeSets; set->name; set++) {
+		double freqs[kMaxSymbols];
+		uint8 lengths[kMaxSymbols];
+		uint32 codes[kMaxSymbols];
+		uint32 lsbCodes[kMaxSymbols];
+
+		for (uint32 i = 0; i < set->count; i++)
+			freqs[i] = 1.0 / pow(i + 1.0, set->skew);
+
+		makeLengths(set->count, freqs, lengths);
+		makeCodes(set->count, lengths, codes);
+		for (uint32 i = 0; i < set->count; i++)
+			lsbCodes[i] = reverseBits(codes[i], lengths[i]);
+
+		for (int order = 0; order < 2; order++) {
+			const bool msb2lsb = (order == 0);
+			const uint32 *orderCodes = msb2lsb ? codes : lsbCodes;
+			const uint32 size = encode(set->count, freqs, codes, lengths, msb2lsb, data);
+
+			const LinearHuffman linear(set->count, orderCodes, lengths);
+			const Common::Huffman table(0, set->count, orderCodes, lengths);
+
+			double oldRate, newRate, memoryRate;
+			if (msb2lsb) {
+				oldRate = run<LinearHuffman, Common::BitStream32BEMSB>(linear, data, size, false, seconds);
+				newRate = run<Common::Huffman, Common::BitStream32BEMSB>(table, data, size, false, seconds);
+				memoryRate = run<Common::Huffman, Common::BitStream32BEMSB>(table, data, size, true, seconds);
+			} else {
+				oldRate = run<LinearHuffman, Common::BitStream32LELSB>(linear, data, size, false, seconds);
+				newRate = run<Common::Huffman, Common::BitStream32LELSB>(table, data, size, false, seconds);
+				memoryRate = run<Common::Huffman, Common::BitStream32LELSB>(table, data, size, true, seconds);
+			}
+
+			printf("%-12s %-8s %10.2f %10.2f %10.2f\n", set->name, msb2lsb ? "MSB" : "LSB", oldRate, newRate, memoryRate);
+		}
+	}
+
+	delete[] data;
+
+	return 0;
+}
@@ -44,6 +44,35 @@ devtools/make-scumm-fontdata$(EXEEXT): $(srcdir)/devtools/make-scumm-fontdata.c
 	$(QUIET)$(MKDIR) devtools/$(DEPDIR)
 	$(QUIET_LINK)$(LD) $(CFLAGS) -Wall -o $@ $<
 
+#
+# Benchmarks. They run on the target, and link against the libraries of
+# this build.
+#
+# scalerbench times the scalers.
+# huffbench compares Common::Huffman with the bit at a time decoder it
+# replaced.
+# binkbench decodes synthetic videos with the Bink decoder.
+#
+
+BENCHMARKS := scalerbench huffbench binkbench
+
+devtools/scalerbench$(EXEEXT): graphics/libgraphics.a common/libcommon.a
+devtools/huffbench$(EXEEXT): common/libcommon.a
+devtools/binkbench$(EXEEXT): video/libvideo.a audio/libaudio.a graphics/libgraphics.a common/libcommon.a
+
+$(BENCHMARKS:%=devtools/%$(EXEEXT)): devtools/%$(EXEEXT): $(srcdir)/devtools/%.cpp
+	$(QUIET)$(MKDIR) devtools/$(DEPDIR)
+	$(QUIET_LINK)$(CXX) $(CXXFLAGS) $(CPPFLAGS) -o $@ $+ $(LIBS)
+
+$(BENCHMARKS): %: devtools/%$(EXEEXT)
+
+clean-devtools: clean-benchmarks
+
+clean-benchmarks:
+	-$(RM) $(BENCHMARKS:%=devtools/%$(EXEEXT))
+
+.PHONY: $(BENCHMARKS) clean-benchmarks
+
 #
 # Rules to explicitly rebuild the credits / MD5 tables.
 # The rules for the files in the "web" resp. "docs" modules
@@ -0,0 +1,150 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/*
+ * Scaler microbenchmark: runs every ScalerProc on a synthetic 320x200
+ * screen and prints its throughput in source megapixels per second.
+ *
+ * Usage: scalerbench [555|565] [seconds per scaler]
+ */
+
+// This is a standalone program, which may use the standard library freely
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "graphics/scaler.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+struct ScalerEntry {
+	const char *name;
+	ScalerProc *proc;
+	int factor;
+};
+
+static const ScalerEntry scalers[] = {
+	{ "Normal1x", Normal1x, 1 },
+#ifdef USE_SCALERS
+	{ "Normal2x", Normal2x, 2 },
+	{ "Normal3x", Normal3x, 3 },
+	{ "2xSaI", _2xSaI, 2 },
+	{ "Super2xSaI", Super2xSaI, 2 },
+	{ "SuperEagle", SuperEagle, 2 },
+	{ "AdvMame2x", AdvMame2x, 2 },
+	{ "AdvMame3x", AdvMame3x, 3 },
+	{ "TV2x", TV2x, 2 },
+	{ "DotMatrix", DotMatrix, 2 },
+#ifdef USE_HQ_SCALERS
+	{ "HQ2x", HQ2x, 2 },
+	{ "HQ3x", HQ3x, 3 },
+#endif
+#endif
+	{ 0, 0, 0 }
+};
+
+enum {
+	kWidth = 320,
+	kHeight = 200,
+	// The scalers read one pixel (AdvMame and 2xSaI two) beyond each edge
+	kBorder = 4
+};
+
+/**
+ * Fill the screen with something resembling game graphics: flat areas,
+ * gradients and some noise, so the edge detecting scalers take all of
+ * their code paths.
+ */
+static void fillScreen(uint16 *screen, int pitch, int bitFormat) {
+	uint32 seed = 1;
+
+	for (int y = 0; y < kHeight + 2 * kBorder; y++) {
+		for (int x = 0; x < kWidth + 2 * kBorder; x++) {
+			seed = seed * 1103515245 + 12345;
+
+			int r, g, b;
+			if ((x / 40 + y / 25) & 1) {
+				r = x & 0x1F;
+				g = y & 0x1F;
+				b = (x + y) & 0x1F;
+			} else if ((seed >> 28) < 3) {
+				r = (seed >> 8) & 0x1F;
+				g = (seed >> 13) & 0x1F;
+				b = (seed >> 18) & 0x1F;
+			} else {
+				r = 4;
+				g = 12;
+				b = 20;
+			}
+
+			if (bitFormat == 565)
+				screen[y * pitch + x] = (r << 11) | (g << 6) | b;
+			else
+				screen[y * pitch + x] = (r << 10) | (g << 5) | b;
+		}
+	}
+}
+
+int main(int argc, char *argv[]) {
+	const int bitFormat = (argc > 1) ? atoi(argv[1]) : 565;
+	const double seconds = (argc > 2) ? atof(argv[2]) : 1.0;
+
+	if (bitFormat != 555 && bitFormat != 565) {
+		fprintf(stderr, "Usage: %s [555|565] [seconds per scaler]\n", argv[0]);
+		return 1;
+	}
+
+	InitScalers(bitFormat);
+
+	const int srcPitch = kWidth + 2 * kBorder;
+	uint16 *src = new uint16[srcPitch * (kHeight + 2 * kBorder)];
+	fillScreen(src, srcPitch, bitFormat);
+	const uint16 *srcStart = src + kBorder * srcPitch + kBorder;
+
+	const int dstPitch = kWidth * 3;
+	uint16 *dst = new uint16[dstPitch * kHeight * 3];
+
+	printf("%-12s %10s %10s\n", "Scaler", "frames/s", "MPix/s");
+
+	for (const ScalerEntry *scaler = scalers; scaler->name; scaler++) {
+		int frames = 0;
+		const clock_t start = clock();
+		clock_t end;
+
+		do {
+			for (int i = 0; i < 10; i++)
+				scaler->proc((const uint8 *)srcStart, srcPitch * 2, (uint8 *)dst, dstPitch * 2, kWidth, kHeight);
+			frames += 10;
+			end = clock();
+		} while (end - start < seconds * CLOCKS_PER_SEC);
+
+		const double elapsed = (double)(end - start) / CLOCKS_PER_SEC;
+		printf("%-12s %10.1f %10.2f\n", scaler->name, frames / elapsed, frames * (double)kWidth * kHeight / elapsed / 1000000.0);
+	}
+
+	DestroyScalers();
+	delete[] src;
+	delete[] dst;
+
+	return 0;
+}
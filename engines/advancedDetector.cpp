@@ -25,6 +25,7 @@
 #include "common/file.h"
 #include "common/macresman.h"
 #include "common/md5.h"
+#include "common/savefile.h"
 #include "common/config-manager.h"
 #include "common/system.h"
 #include "common/textconsole.h"
@@ -385,14 +386,7 @@ bool AdvancedMetaEngine::getFileProperties(const Common::FSNode &parent, const F
 	if (!allFiles.contains(fname))
 		return false;
 
-	Common::File testFile;
-
-	if (!testFile.open(allFiles[fname]))
-		return false;
-
-	fileProps.size = (int32)testFile.size();
-	fileProps.md5 = Common::computeStreamMD5AsString(testFile, _md5Bytes);
-	return true;
+	return ADCache.getFileProperties(allFiles[fname], _md5Bytes, fileProps);
 }
 
 ADGameDescList AdvancedMetaEngine::detectGame(const Common::FSNode &parent, const FileMap &allFiles, Common::Language language, Common::Platform platform, const Common::String &extra) const {
@@ -606,3 +600,133 @@ AdvancedMetaEngine::AdvancedMetaEngine(const void *descs, uint descItemSize, con
 	_maxScanDepth = 1;
 	_directoryGlobs = NULL;
 }
+
+namespace Common {
+DECLARE_SINGLETON(ADDetectionCache);
+}
+
+static const char *const kDetectionCacheFile = "scummvm-detection.cache";
+static const uint32 kDetectionCacheVersion = 1;
+
+ADDetectionCache::ADDetectionCache() : _loaded(false), _dirty(false) {
+}
+
+ADDetectionCache::~ADDetectionCache() {
+	flush();
+}
+
+bool ADDetectionCache::getFileProperties(const Common::FSNode &node, uint md5Bytes, ADFileProperties &fileProps) {
+	load();
+
+	const Common::String key = Common::String::format("%u:%s", md5Bytes, node.getPath().c_str());
+	int32 size;
+	uint32 modificationTime;
+	const bool cacheable = node.getFileStatus(size, modificationTime);
+
+	if (cacheable) {
+		EntryMap::const_iterator i = _entries.find(key);
+		if (i != _entries.end() && i->_value.size == size && i->_value.modificationTime == modificationTime) {
+			fileProps.size = size;
+			fileProps.md5 = i->_value.md5;
+			return true;
+		}
+	}
+
+	Common::File testFile;
+
+	if (!testFile.open(node))
+		return false;
+
+	fileProps.size = (int32)testFile.size();
+	fileProps.md5 = Common::computeStreamMD5AsString(testFile, md5Bytes);
+
+	if (cacheable) {
+		Entry &entry = _entries[key];
+		entry.size = fileProps.size;
+		entry.modificationTime = modificationTime;
+		entry.md5 = fileProps.md5;
+		_dirty = true;
+	}
+
+	return true;
+}
+
+static Common::String readCacheString(Common::SeekableReadStream &stream) {
+	const uint16 len = stream.readUint16LE();
+	Common::String str;
+	for (uint16 i = 0; i < len && !stream.eos(); i++)
+		str += (char)stream.readByte();
+	return str;
+}
+
+static void writeCacheString(Common::WriteStream &stream, const Common::String &str) {
+	stream.writeUint16LE(str.size());
+	stream.writeString(str);
+}
+
+void ADDetectionCache::load() {
+	if (_loaded)
+		return;
+	_loaded = true;
+
+	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
+	if (!saveFileMan)
+		return;
+
+	Common::InSaveFile *in = saveFileMan->openForLoading(kDetectionCacheFile);
+	if (!in)
+		return;
+
+	if (in->readUint32BE() == MKTAG('A', 'D', 'C', 'C') && in->readUint32LE() == kDetectionCacheVersion) {
+		const uint32 count = in->readUint32LE();
+
+		for (uint32 i = 0; i < count && !in->eos() && !in->err(); i++) {
+			const Common::String key = readCacheString(*in);
+			Entry entry;
+			entry.size = in->readSint32LE();
+			entry.modificationTime = in->readUint32LE();
+			entry.md5 = readCacheString(*in);
+
+			if (!in->eos() && !in->err())
+				_entries[key] = entry;
+		}
+
+		debug(3, "Loaded %d cached file properties for detection", _entries.size());
+	}
+
+	delete in;
+}
+
+void ADDetectionCache::flush() {
+	if (!_dirty)
+		return;
+
+	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
+	if (!saveFileMan)
+		return;
+
+	Common::OutSaveFile *out = saveFileMan->openForSaving(kDetectionCacheFile);
+	if (!out) {
+		warning("Could not write the detection cache");
+		return;
+	}
+
+	out->writeUint32BE(MKTAG('A', 'D', 'C', 'C'));
+	out->writeUint32LE(kDetectionCacheVersion);
+	out->writeUint32LE(_entries.size());
+
+	for (EntryMap::const_iterator i = _entries.begin(); i != _entries.end(); ++i) {
+		writeCacheString(*out, i->_key);
+		out->writeSint32LE(i->_value.size);
+		out->writeUint32LE(i->_value.modificationTime);
+		writeCacheString(*out, i->_value.md5);
+	}
+
+	out->finalize();
+	if (out->err())
+		warning("Could not write the detection cache");
+	else
+		_dirty = false;
+
+	delete out;
+}
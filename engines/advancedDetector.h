@@ -27,12 +27,14 @@
 #include "engines/engine.h"
 
 #include "common/hash-str.h"
+#include "common/singleton.h"
 
 #include "common/gui_options.h" // FIXME: Temporary hack?
 
 namespace Common {
 class Error;
 class FSList;
+class FSNode;
 }
 
 /**
@@ -327,4 +329,54 @@ protected:
 	bool getFileProperties(const Common::FSNode &parent, const FileMap &allFiles, const ADGameDescription &game, const Common::String fname, ADFileProperties &fileProps) const;
 };
 
+/**
+ * Cache of the file properties computed during detection, shared by all
+ * AdvancedMetaEngines. This way every candidate file is only hashed once
+ * per scan, no matter how many engines look at it.
+ *
+ * Entries are keyed by the path of the file and the number of bytes hashed,
+ * and they are only reused as long as the size and the modification time
+ * of the file stay the same. Files whose status the file system backend
+ * cannot tell (see Common::FSNode::getFileStatus) are never cached.
+ *
+ * The cache is kept across launches in a file in the save directory,
+ * which is written when the cache is destroyed.
+ */
+class ADDetectionCache : public Common::Singleton<ADDetectionCache> {
+public:
+	~ADDetectionCache();
+
+	/**
+	 * Get the size and the MD5 of (the first md5Bytes of) the file
+	 * referred by node, computing them only if they are not cached.
+	 *
+	 * @return true on success, false if the file could not be read
+	 */
+	bool getFileProperties(const Common::FSNode &node, uint md5Bytes, ADFileProperties &fileProps);
+
+	/** Write the cache to disk, if it changed since it was last written. */
+	void flush();
+
+private:
+	friend class Common::Singleton<SingletonBaseType>;
+	ADDetectionCache();
+
+	struct Entry {
+		int32 size;
+		uint32 modificationTime;
+		Common::String md5;
+	};
+
+	typedef Common::HashMap<Common::String, Entry> EntryMap;
+
+	void load();
+
+	EntryMap _entries;
+	bool _loaded;
+	bool _dirty;
+};
+
+/** Shortcut for accessing the detection cache. */
+#define ADCache ADDetectionCache::instance()
+
 #endif
@@ -127,7 +127,16 @@ public:
 		 * If this feature is supported, then the corresponding MetaEngine *must*
 		 * support the kSupportsListSaves feature.
 		 */
-		kSupportsSavingDuringRuntime
+		kSupportsSavingDuringRuntime,
+
+		/**
+		 * The engine's main loop is driven from outside: run() only sets up
+		 * the game and returns, after which the caller repeatedly invokes
+		 * runFrame() at the times it requests, until runFrame() asks to stop.
+		 * This allows ports without a blocking main loop (e.g. a web browser)
+		 * to schedule frames without polling.
+		 */
+		kSupportsFrameLoop
 	};
 
 
@@ -147,6 +156,16 @@ public:
 	 */
 	virtual Common::Error run() = 0;
 
+	/**
+	 * Run one iteration of the engine's main loop. Only called for engines
+	 * supporting the kSupportsFrameLoop feature, after run() returned
+	 * successfully.
+	 * @return the number of milliseconds, counted from the start of this
+	 *         frame, until the next frame is due, or -1 if the engine wants
+	 *         to quit.
+	 */
+	virtual int32 runFrame() { return -1; }
+
 	/**
 	 * Prepare an error string, which is printed by the error() function.
 	 */
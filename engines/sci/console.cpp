@@ -125,6 +125,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	DCmd_Register("set_palette",		WRAP_METHOD(Console, cmdSetPalette));
 	DCmd_Register("draw_pic",			WRAP_METHOD(Console, cmdDrawPic));
 	DCmd_Register("draw_cel",			WRAP_METHOD(Console, cmdDrawCel));
+	DCmd_Register("view_cache",			WRAP_METHOD(Console, cmdViewCache));
 	DCmd_Register("undither",           WRAP_METHOD(Console, cmdUndither));
 	DCmd_Register("pic_visualize",		WRAP_METHOD(Console, cmdPicVisualize));
 	DCmd_Register("play_video",         WRAP_METHOD(Console, cmdPlayVideo));
@@ -151,6 +152,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	DCmd_Register("gc_reachable",		WRAP_METHOD(Console, cmdGCShowReachable));
 	DCmd_Register("gc_freeable",		WRAP_METHOD(Console, cmdGCShowFreeable));
 	DCmd_Register("gc_normalize",		WRAP_METHOD(Console, cmdGCNormalize));
+	DCmd_Register("gc_stats",			WRAP_METHOD(Console, cmdGCStats));
 	// Music/SFX
 	DCmd_Register("songlib",			WRAP_METHOD(Console, cmdSongLib));
 	DCmd_Register("songinfo",			WRAP_METHOD(Console, cmdSongInfo));
@@ -206,6 +208,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	DCmd_Register("bpe",				WRAP_METHOD(Console, cmdBreakpointFunction));		// alias
 	// VM
 	DCmd_Register("script_steps",		WRAP_METHOD(Console, cmdScriptSteps));
+	DCmd_Register("selector_cache",		WRAP_METHOD(Console, cmdSelectorCache));
 	DCmd_Register("vm_varlist",			WRAP_METHOD(Console, cmdVMVarlist));
 	DCmd_Register("vmvarlist",			WRAP_METHOD(Console, cmdVMVarlist));				// alias
 	DCmd_Register("vl",					WRAP_METHOD(Console, cmdVMVarlist));				// alias
@@ -366,6 +369,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	DebugPrintf(" set_palette - Sets a palette resource\n");
 	DebugPrintf(" draw_pic - Draws a pic resource\n");
 	DebugPrintf(" draw_cel - Draws a cel from a view resource\n");
+	DebugPrintf(" view_cache - Shows or resets the hit rate and memory use of the view cache\n");
 	DebugPrintf(" pic_visualize - Enables visualization of the drawing process of EGA pictures\n");
 	DebugPrintf(" undither - Enable/disable undithering\n");
 	DebugPrintf(" play_video - Plays a SEQ, AVI, VMD, RBT or DUK video\n");
@@ -387,6 +391,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	DebugPrintf(" gc_reachable - Lists all addresses directly reachable from a given memory object\n");
 	DebugPrintf(" gc_freeable - Lists all addresses freeable in a given segment\n");
 	DebugPrintf(" gc_normalize - Prints the \"normal\" address of a given address\n");
+	DebugPrintf(" gc_stats - Shows or resets the pause times of the garbage collector\n");
 	DebugPrintf("\n");
 	DebugPrintf("Music/SFX:\n");
 	DebugPrintf(" songlib - Shows the song library\n");
@@ -428,6 +433,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	DebugPrintf("\n");
 	DebugPrintf("VM:\n");
 	DebugPrintf(" script_steps - Shows the number of executed SCI operations\n");
+	DebugPrintf(" selector_cache - Shows or resets the hit rates of the selector lookup cache\n");
 	DebugPrintf(" vm_varlist / vmvarlist / vl - Shows the addresses of variables in the VM\n");
 	DebugPrintf(" vm_vars / vmvars / vv - Displays or changes variables in the VM\n");
 	DebugPrintf(" stack - Lists the specified number of stack elements\n");
@@ -1553,6 +1559,36 @@ bool Console::cmdDrawCel(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdViewCache(int argc, const char **argv) {
+	GfxCache *cache = _engine->_gfxCache;
+
+	if (argc > 1) {
+		if (scumm_stricmp(argv[1], "reset")) {
+			DebugPrintf("Shows the hit rate and memory use of the view cache\n");
+			DebugPrintf("Usage: %s [reset]\n", argv[0]);
+			return true;
+		}
+
+		cache->resetViewStats();
+		DebugPrintf("View cache statistics reset\n");
+		return true;
+	}
+
+	const GfxCache::Stats &stats = cache->getViewStats();
+	const uint32 total = stats.hits + stats.misses;
+
+	DebugPrintf("Cached views: %u, using %u of %u KB\n", cache->getViewCacheCount(),
+		cache->getViewCacheSize() / 1024, cache->getViewCacheBudget() / 1024);
+	DebugPrintf("View requests: %u\n", total);
+	if (total) {
+		DebugPrintf("  hits:   %u (%.1f%%)\n", stats.hits, stats.hits * 100.0 / total);
+		DebugPrintf("  misses: %u (%.1f%%)\n", stats.misses, stats.misses * 100.0 / total);
+	}
+	DebugPrintf("Evicted views: %u, %u KB\n", stats.evictedViews, stats.evictedBytes / 1024);
+
+	return true;
+}
+
 bool Console::cmdUndither(int argc, const char **argv) {
 	if (argc != 2) {
 		DebugPrintf("Enable/disable undithering.\n");
@@ -2237,6 +2273,31 @@ bool Console::cmdGCInvoke(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdGCStats(int argc, const char **argv) {
+	GCStats &stats = _engine->_gamestate->gcStats;
+
+	if (argc > 1) {
+		if (scumm_stricmp(argv[1], "reset")) {
+			DebugPrintf("Shows the pause times of the garbage collector\n");
+			DebugPrintf("Usage: %s [reset]\n", argv[0]);
+			return true;
+		}
+
+		stats.reset();
+		DebugPrintf("Garbage collector statistics reset\n");
+		return true;
+	}
+
+	DebugPrintf("Collections: %u, objects freed: %u\n", stats.runs, stats.freed);
+	DebugPrintf("Collections skipped, as nothing was allocated: %u\n", stats.skipped);
+	if (stats.runs) {
+		DebugPrintf("Pause times: last %u ms, longest %u ms, average %.1f ms\n",
+			stats.lastPause, stats.maxPause, (double)stats.totalPause / stats.runs);
+	}
+
+	return true;
+}
+
 bool Console::cmdGCObjects(int argc, const char **argv) {
 	AddrSet *use_map = findAllActiveReferences(_engine->_gamestate);
 
@@ -2710,6 +2771,35 @@ bool Console::cmdScriptSteps(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdSelectorCache(int argc, const char **argv) {
+	SelectorDispatchCache &cache = _engine->_gamestate->_segMan->getSelectorDispatchCache();
+
+	if (argc > 1) {
+		if (scumm_stricmp(argv[1], "reset")) {
+			DebugPrintf("Shows the hit rates of the selector lookup cache\n");
+			DebugPrintf("Usage: %s [reset]\n", argv[0]);
+			return true;
+		}
+
+		cache.resetStats();
+		DebugPrintf("Selector lookup cache statistics reset\n");
+		return true;
+	}
+
+	const SelectorDispatchCache::Stats &stats = cache.getStats();
+	const uint32 total = stats.inlineHits + stats.tableHits + stats.misses;
+
+	DebugPrintf("Selector lookups by send: %u\n", total);
+	if (total) {
+		DebugPrintf("  inline cache hits:   %u (%.1f%%)\n", stats.inlineHits, stats.inlineHits * 100.0 / total);
+		DebugPrintf("  dispatch table hits: %u (%.1f%%)\n", stats.tableHits, stats.tableHits * 100.0 / total);
+		DebugPrintf("  full lookups:        %u (%.1f%%)\n", stats.misses, stats.misses * 100.0 / total);
+	}
+	DebugPrintf("Flushed after script unloads: %u times\n", stats.flushes);
+
+	return true;
+}
+
 bool Console::cmdBacktrace(int argc, const char **argv) {
 	DebugPrintf("Call stack (current base: 0x%x):\n", _engine->_gamestate->executionStackBase);
 	Common::List<ExecStack>::const_iterator iter;
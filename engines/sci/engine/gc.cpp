@@ -22,6 +22,7 @@
 
 #include "sci/engine/gc.h"
 #include "common/array.h"
+#include "common/system.h"
 #include "sci/graphics/ports.h"
 
 namespace Sci {
@@ -163,6 +164,9 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 void run_gc(EngineState *s) {
 	SegManager *segMan = s->_segMan;
 
+	const uint32 startTime = g_system->getMillis();
+	uint32 freed = 0;
+
 	// Some debug stuff
 	debugC(kDebugLevelGC, "[GC] Running...");
 #ifdef GC_DEBUG_CODE
@@ -195,6 +199,7 @@ void run_gc(EngineState *s) {
 				if (!activeRefs->contains(addr)) {
 					// Not found -> we can free it
 					mobj->freeAtAddress(segMan, addr);
+					freed++;
 					debugC(kDebugLevelGC, "[GC] Deallocating %04x:%04x", PRINT_REG(addr));
 #ifdef GC_DEBUG_CODE
 					segcount[type]++;
@@ -206,6 +211,14 @@ void run_gc(EngineState *s) {
 	}
 
 	delete activeRefs;
+	segMan->resetGCCandidates();
+
+	GCStats &stats = s->gcStats;
+	stats.runs++;
+	stats.freed += freed;
+	stats.lastPause = g_system->getMillis() - startTime;
+	stats.maxPause = MAX(stats.maxPause, stats.lastPause);
+	stats.totalPause += stats.lastPause;
 
 #ifdef GC_DEBUG_CODE
 	// Output debug summary of garbage collection
@@ -0,0 +1,135 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef SCI_ENGINE_INSTRUCTION_CACHE_H
+#define SCI_ENGINE_INSTRUCTION_CACHE_H
+
+#include "common/array.h"
+
+namespace Sci {
+
+/**
+ * The instructions of a script which the VM has decoded, so that it doesn't
+ * have to decode them again each time it executes them.
+ *
+ * The index from offsets to instructions takes 2 bytes per byte of code, so
+ * it is only allocated once a script has run kHotReads instructions. Most
+ * scripts only run some initialization code and never get there.
+ *
+ * Kernel functions may write into the script buffer, so each cached
+ * instruction keeps the bytes it was decoded from, and is decoded again if
+ * they changed.
+ */
+class InstructionCache {
+public:
+	/** Decodes an instruction, like readPMachineInstruction() */
+	typedef int (*DecodeProc)(const byte *src, byte &extOpcode, int16 opparams[4]);
+
+	enum {
+		kHotReads = 1000,
+		kMaxLength = 8
+	};
+
+	InstructionCache() : _reads(0) {}
+
+	void clear() {
+		_instructions.clear();
+		_index.clear();
+		_reads = 0;
+	}
+
+	/**
+	 * Reads the instruction at the given offset, like decode does, but
+	 * decodes it only the first time it is read.
+	 * @param code		the script buffer
+	 * @param codeSize	the size of the code in the buffer
+	 * @param offset	offset of the instruction in the buffer
+	 * @param decode	the function decoding instructions
+	 * @param extOpcode	receives the extended opcode
+	 * @param opparams	receives the opcode parameters
+	 * @return			the length of the instruction in bytes
+	 */
+	int read(const byte *code, uint32 codeSize, uint32 offset, DecodeProc decode, byte &extOpcode, int16 opparams[4]) {
+		if (_index.empty()) {
+			if (++_reads < kHotReads)
+				return decode(code + offset, extOpcode, opparams);
+			_index.resize(codeSize);
+		}
+
+		if (offset >= _index.size())
+			return decode(code + offset, extOpcode, opparams);
+
+		const uint16 index = _index[offset];
+		if (index) {
+			const DecodedInstruction &instruction = _instructions[index - 1];
+			if (!memcmp(code + offset, instruction.bytes, instruction.length)) {
+				extOpcode = instruction.bytes[0];
+				memcpy(opparams, instruction.opparams, sizeof(instruction.opparams));
+				return instruction.length;
+			}
+		}
+
+		const int length = decode(code + offset, extOpcode, opparams);
+
+		// op_file instructions include a file name and may be longer than
+		// what is kept, and the index can't hold more than 0xFFFF
+		// instructions. Such instructions are simply decoded each time.
+		if (length > kMaxLength || offset + length > codeSize || (!index && _instructions.size() >= 0xFFFF))
+			return length;
+
+		DecodedInstruction instruction;
+		memcpy(instruction.opparams, opparams, sizeof(instruction.opparams));
+		memcpy(instruction.bytes, code + offset, length);
+		instruction.length = length;
+
+		if (index) {
+			_instructions[index - 1] = instruction;
+		} else {
+			_instructions.push_back(instruction);
+			_index[offset] = _instructions.size();
+		}
+
+		return length;
+	}
+
+private:
+	struct DecodedInstruction {
+		int16 opparams[4];
+		byte bytes[kMaxLength];
+		byte length;
+	};
+
+	Common::Array<DecodedInstruction> _instructions;
+
+	/**
+	 * For each offset into the code, the index of the instruction starting
+	 * there plus one, or 0 if it hasn't been decoded yet.
+	 */
+	Common::Array<uint16> _index;
+
+	/** Instructions read before the index was allocated */
+	uint _reads;
+};
+
+} // End of namespace Sci
+
+#endif // SCI_ENGINE_INSTRUCTION_CACHE_H
@@ -70,6 +70,27 @@ enum {
 	PF_FATAL = -2
 };
 
+// Entries of AvoidPathVisibility::visible
+enum {
+	VIS_UNKNOWN = 0,
+	VIS_VISIBLE = 1,
+	VIS_HIDDEN = 2
+};
+
+// Number of polygon sets to keep the visibility of, and the most vertices
+// a cached set may have
+enum {
+	AVOIDPATH_CACHE_SIZE = 4,
+	AVOIDPATH_CACHE_MAX_VERTICES = 512
+};
+
+// A* state of a vertex
+enum {
+	VERTEX_NEW = 0,
+	VERTEX_OPEN = 1,
+	VERTEX_CLOSED = 2
+};
+
 // Floating point struct
 struct FloatPoint {
 	FloatPoint() : x(0), y(0) {}
@@ -111,23 +132,25 @@ struct Vertex {
 	// Previous vertex in shortest path
 	Vertex *path_prev;
 
+	// Position in PathfindingState::vertex_index
+	int index;
+
+	// A* state, and the order in which vertices were added to the open set
+	int state;
+	uint openOrder;
+
 public:
 	Vertex(const Common::Point &p) : v(p) {
+		costF = HUGE_DISTANCE;
 		costG = HUGE_DISTANCE;
 		path_prev = NULL;
+		index = -1;
+		state = VERTEX_NEW;
+		openOrder = 0;
 	}
 };
 
-class VertexList: public Common::List<Vertex *> {
-public:
-	bool contains(Vertex *v) {
-		for (iterator it = begin(); it != end(); ++it) {
-			if (v == *it)
-				return true;
-		}
-		return false;
-	}
-};
+typedef Common::List<Vertex *> VertexList;
 
 /* Circular list definitions. */
 
@@ -257,6 +280,14 @@ struct PathfindingState {
 	// Screen size
 	int _width, _height;
 
+	// Known visibility between the vertices of the polygon set, which start
+	// at _visibilityStart in vertex_index, or NULL
+	AvoidPathVisibility *_visibility;
+	int _visibilityStart;
+
+	// Set if merging the start or end point split a polygon edge
+	bool _splitEdge;
+
 	PathfindingState(int width, int height) : _width(width), _height(height) {
 		vertex_start = NULL;
 		vertex_end = NULL;
@@ -264,6 +295,9 @@ struct PathfindingState {
 		_prependPoint = NULL;
 		_appendPoint = NULL;
 		vertices = 0;
+		_visibility = NULL;
+		_visibilityStart = 0;
+		_splitEdge = false;
 	}
 
 	~PathfindingState() {
@@ -665,36 +699,58 @@ static int inside(const Common::Point &p, Vertex *vertex) {
  * @param vertex_cur	the vertex
  * @return list of vertices that are visible from vert
  */
+static bool is_visible(PathfindingState *s, Vertex *vertex_cur, Vertex *vertex) {
+	// Make sure we don't intersect a polygon locally at the vertices
+	if ((vertex == vertex_cur) || (inside(vertex->v, vertex_cur)) || (inside(vertex_cur->v, vertex)))
+		return false;
+
+	// Check for intersecting edges
+	for (int j = 0; j < s->vertices; j++) {
+		Vertex *edge = s->vertex_index[j];
+		if (VERTEX_HAS_EDGES(edge)) {
+			if (between(vertex_cur->v, vertex->v, edge->v)) {
+				// If we hit a vertex, make sure we can pass through it without intersecting its polygon
+				if ((inside(vertex_cur->v, edge)) || (inside(vertex->v, edge)))
+					return false;
+
+				// This edge won't properly intersect, so we continue
+				continue;
+			}
+
+			if (intersect_proper(vertex_cur->v, vertex->v, edge->v, CLIST_NEXT(edge)->v))
+				return false;
+		}
+	}
+
+	return true;
+}
+
 static VertexList *visible_vertices(PathfindingState *s, Vertex *vertex_cur) {
 	VertexList *visVerts = new VertexList();
 
+	// The visibility between two vertices of the polygon set is cached, only
+	// the start and end points (if they are not part of the set) need to be
+	// checked each time
+	const int setStart = s->_visibilityStart;
+	const int curIndex = vertex_cur->index - setStart;
+	byte *cached = NULL;
+	if (s->_visibility && curIndex >= 0)
+		cached = &s->_visibility->visible[curIndex * (s->vertices - setStart)];
+
 	for (int i = 0; i < s->vertices; i++) {
 		Vertex *vertex = s->vertex_index[i];
+		bool visible;
 
-		// Make sure we don't intersect a polygon locally at the vertices
-		if ((vertex == vertex_cur) || (inside(vertex->v, vertex_cur)) || (inside(vertex_cur->v, vertex)))
-			continue;
-
-		// Check for intersecting edges
-		int j;
-		for (j = 0; j < s->vertices; j++) {
-			Vertex *edge = s->vertex_index[j];
-			if (VERTEX_HAS_EDGES(edge)) {
-				if (between(vertex_cur->v, vertex->v, edge->v)) {
-					// If we hit a vertex, make sure we can pass through it without intersecting its polygon
-					if ((inside(vertex_cur->v, edge)) || (inside(vertex->v, edge)))
-						break;
-
-					// This edge won't properly intersect, so we continue
-					continue;
-				}
-
-				if (intersect_proper(vertex_cur->v, vertex->v, edge->v, CLIST_NEXT(edge)->v))
-					break;
-			}
+		if (cached && i >= setStart) {
+			byte &known = cached[i - setStart];
+			if (known == VIS_UNKNOWN)
+				known = is_visible(s, vertex_cur, vertex) ? VIS_VISIBLE : VIS_HIDDEN;
+			visible = (known == VIS_VISIBLE);
+		} else {
+			visible = is_visible(s, vertex_cur, vertex);
 		}
 
-		if (j == s->vertices)
+		if (visible)
 			visVerts->push_front(vertex);
 	}
 
@@ -1083,6 +1139,7 @@ static Vertex *merge_point(PathfindingState *s, const Common::Point &v) {
 				if (between(vertex->v, next->v, v)) {
 					// Split edge by adding vertex
 					polygon->vertices.insertAfter(vertex, v_new);
+					s->_splitEdge = true;
 					return v_new;
 				}
 			}
@@ -1185,6 +1242,50 @@ static void change_polygons_opt_0(PathfindingState *s) {
 	}
 }
 
+/**
+ * Attaches the visibility known for a polygon set to the pathfinding state,
+ * from the last sets kAvoidPath was called with
+ * @param s				the game state
+ * @param pf_s			the pathfinding state
+ * @param polygonSet	types, sizes and points of the polygons
+ * @param setVertices	number of vertices in polygonSet
+ */
+static void findVisibility(EngineState *s, PathfindingState *pf_s, const Common::Array<int16> &polygonSet, int setVertices) {
+	if (setVertices > AVOIDPATH_CACHE_MAX_VERTICES)
+		return;
+
+	Common::List<AvoidPathVisibility> &cache = s->_avoidPathCache;
+	Common::List<AvoidPathVisibility>::iterator it = cache.begin();
+	while (it != cache.end() && !(it->polygons == polygonSet))
+		++it;
+
+	if (it == cache.end()) {
+		AvoidPathVisibility visibility;
+		visibility.polygons = polygonSet;
+		visibility.visible.resize(setVertices * setVertices);
+		cache.push_front(visibility);
+		if (cache.size() > AVOIDPATH_CACHE_SIZE)
+			cache.pop_back();
+	} else if (it != cache.begin()) {
+		cache.push_front(*it);
+		cache.erase(it);
+	}
+
+	pf_s->_visibility = &cache.front();
+	pf_s->_visibilityStart = pf_s->vertices - setVertices;
+}
+
+// Entry of the open set of AStar(), which is a binary heap. Entries are
+// never updated: when the cost of a vertex goes down, it is pushed again,
+// and the outdated entry is skipped once it comes out.
+struct OpenSetEntry {
+	uint32 costF;
+	uint openOrder;
+	Vertex *vertex;
+};
+
+typedef Common::Array<OpenSetEntry> OpenSet;
+
 /**
  * Converts the SCI input data for pathfinding
  * Parameters: (EngineState *) s: The game state
@@ -1276,6 +1377,20 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 		}
 	}
 
+	// The polygon set is final now, apart from the start and end points
+	Common::Array<int16> polygonSet;
+	int setVertices = 0;
+	for (PolygonList::iterator it = pf_s->polygons.begin(); it != pf_s->polygons.end(); ++it) {
+		Vertex *vertex;
+		polygonSet.push_back((*it)->type);
+		polygonSet.push_back((*it)->vertices.size());
+		CLIST_FOREACH(vertex, &(*it)->vertices) {
+			polygonSet.push_back(vertex->v.x);
+			polygonSet.push_back(vertex->v.y);
+			setVertices++;
+		}
+	}
+
 	// Merge start and end points into polygon set
 	pf_s->vertex_start = merge_point(pf_s, *new_start);
 	pf_s->vertex_end = merge_point(pf_s, *new_end);
@@ -1293,15 +1408,76 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 		Vertex *vertex;
 
 		CLIST_FOREACH(vertex, &polygon->vertices) {
+			vertex->index = count;
 			pf_s->vertex_index[count++] = vertex;
 		}
 	}
 
 	pf_s->vertices = count;
 
+	// Start and end points which aren't part of the polygon set end up in
+	// single-vertex polygons in front of it, and don't change the visibility
+	// between its vertices. This doesn't hold when they split an edge.
+	if (!pf_s->_splitEdge)
+		findVisibility(s, pf_s, polygonSet, setVertices);
+
 	return pf_s;
 }
 
+/**
+ * Returns true if entry a comes out of the open set before b: the one with
+ * the lower F cost, or else the vertex added to the set last
+ */
+static bool openBefore(const OpenSetEntry &a, const OpenSetEntry &b) {
+	if (a.costF != b.costF)
+		return a.costF < b.costF;
+	return a.openOrder > b.openOrder;
+}
+
+static void openSetPush(OpenSet &heap, Vertex *vertex) {
+	OpenSetEntry entry;
+	entry.costF = vertex->costF;
+	entry.openOrder = vertex->openOrder;
+	entry.vertex = vertex;
+
+	uint index = heap.size();
+	heap.push_back(entry);
+
+	while (index > 0) {
+		const uint parent = (index - 1) / 2;
+		if (!openBefore(entry, heap[parent]))
+			break;
+		heap[index] = heap[parent];
+		index = parent;
+	}
+	heap[index] = entry;
+}
+
+static OpenSetEntry openSetPop(OpenSet &heap) {
+	const OpenSetEntry top = heap[0];
+	const OpenSetEntry last = heap.back();
+	heap.pop_back();
+
+	const uint size = heap.size();
+	uint index = 0;
+	if (size) {
+		for (;;) {
+			uint child = index * 2 + 1;
+			if (child >= size)
+				break;
+			if (child + 1 < size && openBefore(heap[child + 1], heap[child]))
+				child++;
+			if (!openBefore(heap[child], last))
+				break;
+			heap[index] = heap[child];
+			index = child;
+		}
+		heap[index] = last;
+	}
+
+	return top;
+}
+
 /**
  * Computes a shortest path from vertex_start to vertex_end. The caller can
  * construct the resulting path by following the path_prev links from
@@ -1310,52 +1486,50 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
  * Parameters: (PathfindingState *) s: The pathfinding state
  */
 static void AStar(PathfindingState *s) {
-	// Vertices of which the shortest path is known
-	VertexList closedSet;
-
-	// The remaining vertices
-	VertexList openSet;
+	// The vertices that may be next on the shortest path. Those of which the
+	// shortest path is known are marked VERTEX_CLOSED.
+	OpenSet openSet;
+	uint openCount = 0;
+	bool reachedEnd = false;
 
-	openSet.push_front(s->vertex_start);
 	s->vertex_start->costG = 0;
 	s->vertex_start->costF = (uint32)sqrt((float)s->vertex_start->v.sqrDist(s->vertex_end->v));
+	s->vertex_start->state = VERTEX_OPEN;
+	s->vertex_start->openOrder = openCount++;
+	openSetPush(openSet, s->vertex_start);
 
 	while (!openSet.empty()) {
 		// Find vertex in open set with lowest F cost
-		VertexList::iterator vertex_min_it = openSet.end();
-		Vertex *vertex_min = 0;
-		uint32 min = HUGE_DISTANCE;
-
-		for (VertexList::iterator it = openSet.begin(); it != openSet.end(); ++it) {
-			Vertex *vertex = *it;
-			if (vertex->costF < min) {
-				vertex_min_it = it;
-				vertex_min = *vertex_min_it;
-				min = vertex->costF;
-			}
-		}
+		const OpenSetEntry entry = openSetPop(openSet);
+		Vertex *vertex_min = entry.vertex;
 
-		assert(vertex_min != 0);	// the vertex cost should never be bigger than HUGE_DISTANCE
+		if (vertex_min->state == VERTEX_CLOSED || entry.costF != vertex_min->costF)
+			continue;
 
 		// Check if we are done
-		if (vertex_min == s->vertex_end)
+		if (vertex_min == s->vertex_end) {
+			reachedEnd = true;
 			break;
+		}
 
 		// Move vertex from set open to set closed
-		closedSet.push_front(vertex_min);
-		openSet.erase(vertex_min_it);
+		vertex_min->state = VERTEX_CLOSED;
 
 		VertexList *visVerts = visible_vertices(s, vertex_min);
 
 		for (VertexList::iterator it = visVerts->begin(); it != visVerts->end(); ++it) {
 			uint32 new_dist;
 			Vertex *vertex = *it;
+			bool added = false;
 
-			if (closedSet.contains(vertex))
+			if (vertex->state == VERTEX_CLOSED)
 				continue;
 
-			if (!openSet.contains(vertex))
-				openSet.push_front(vertex);
+			if (vertex->state == VERTEX_NEW) {
+				vertex->state = VERTEX_OPEN;
+				vertex->openOrder = openCount++;
+				added = true;
+			}
 
 			new_dist = vertex_min->costG + (uint32)sqrt((float)vertex_min->v.sqrDist(vertex->v));
 
@@ -1382,13 +1556,16 @@ static void AStar(PathfindingState *s) {
 				vertex->costG = new_dist;
 				vertex->costF = vertex->costG + (uint32)sqrt((float)vertex->v.sqrDist(s->vertex_end->v));
 				vertex->path_prev = vertex_min;
+				openSetPush(openSet, vertex);
+			} else if (added) {
+				openSetPush(openSet, vertex);
 			}
 		}
 
 		delete visVerts;
 	}
 
-	if (openSet.empty())
+	if (!reachedEnd)
 		debugC(kDebugLevelAvoidPath, "AvoidPath: End point (%i, %i) is unreachable", s->vertex_end->v.x, s->vertex_end->v.y);
 }
 
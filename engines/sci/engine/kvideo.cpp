@@ -50,6 +50,9 @@ void playVideo(Video::VideoDecoder *videoDecoder, VideoState videoState) {
 	if (!videoDecoder)
 		return;
 
+	// Decode the next frames while waiting for the current one to be due,
+	// so that a slow frame doesn't stall the video
+	videoDecoder->setDecodeAhead(4);
 	videoDecoder->start();
 
 	byte *scaleBuffer = 0;
@@ -124,11 +127,14 @@ void playVideo(Video::VideoDecoder *videoDecoder, VideoState videoState) {
 				skipVideo = true;
 		}
 
+		videoDecoder->pump();
 		g_system->delayMillis(10);
 	}
 
 	delete[] scaleBuffer;
 	delete videoDecoder;
+
+	g_sci->_gfxScreen->invalidateCopiedScreen();
 }
 
 reg_t kShowMovie(EngineState *s, int argc, reg_t *argv) {
@@ -63,6 +63,12 @@ void Script::freeScript() {
 	_lockers = 1;
 	_markedAsDeleted = false;
 	_objects.clear();
+
+	_instructionCache.clear();
+}
+
+int Script::readInstruction(uint32 offset, byte &extOpcode, int16 opparams[4]) {
+	return _instructionCache.read(_buf, _scriptSize, offset, readPMachineInstruction, extOpcode, opparams);
 }
 
 void Script::load(int script_nr, ResourceManager *resMan) {
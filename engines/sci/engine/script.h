@@ -24,6 +24,7 @@
 #define SCI_ENGINE_SCRIPT_H
 
 #include "common/str.h"
+#include "sci/engine/instruction_cache.h"
 #include "sci/engine/segment.h"
 
 namespace Sci {
@@ -74,6 +75,8 @@ private:
 
 	ObjMap _objects;	/**< Table for objects, contains property variables */
 
+	InstructionCache _instructionCache;
+
 public:
 	int getLocalsOffset() const { return _localsOffset; }
 	uint16 getLocalsCount() const { return _localsCount; }
@@ -83,6 +86,17 @@ public:
 	uint32 getBufSize() const { return _bufSize; }
 	const byte *getBuf(uint offset = 0) const { return _buf + offset; }
 
+	/**
+	 * Reads the instruction at the given offset, like
+	 * readPMachineInstruction() does, but decodes each instruction only the
+	 * first time it is read.
+	 * @param offset	offset of the instruction in the buffer
+	 * @param extOpcode	receives the extended opcode
+	 * @param opparams	receives the opcode parameters
+	 * @return			the length of the instruction in bytes
+	 */
+	int readInstruction(uint32 offset, byte &extOpcode, int16 opparams[4]);
+
 	int getScriptNumber() const { return _nr; }
 	SegmentId getLocalsSegment() const { return _localsSegment; }
 	reg_t *getLocalsBegin() { return _localsBlock ? _localsBlock->_locals.begin() : NULL; }
@@ -45,6 +45,7 @@ SegManager::SegManager(ResourceManager *resMan) {
 #endif
 
 	_resMan = resMan;
+	_gcCandidates = 1;
 
 	createClassTable();
 }
@@ -75,6 +76,9 @@ void SegManager::resetSegMan() {
 	_stringSegId = 0;
 #endif
 
+	// Whatever gets restored into the heap hasn't been collected yet
+	_gcCandidates = 1;
+
 	// Reinitialize class table
 	_classTable.clear();
 	createClassTable();
@@ -156,6 +160,7 @@ void SegManager::deallocate(SegmentId seg) {
 	if (mobj->getType() == SEG_TYPE_SCRIPT) {
 		Script *scr = (Script *)mobj;
 		_scriptSegMap.erase(scr->getScriptNumber());
+		_selectorDispatchCache.flush();
 		if (scr->getLocalsSegment()) {
 			// Check if the locals segment has already been deallocated.
 			// If the locals block has been stored in a segment with an ID
@@ -382,6 +387,7 @@ reg_t SegManager::allocateHunkEntry(const char *hunk_type, int size) {
 	table = (HunkTable *)_heap[_hunksSegId];
 
 	offset = table->allocEntry();
+	_gcCandidates++;
 
 	reg_t addr = make_reg(_hunksSegId, offset);
 	Hunk *h = &(table->_table[offset]);
@@ -417,6 +423,7 @@ Clone *SegManager::allocateClone(reg_t *addr) {
 		table = (CloneTable *)_heap[_clonesSegId];
 
 	offset = table->allocEntry();
+	_gcCandidates++;
 
 	*addr = make_reg(_clonesSegId, offset);
 	return &(table->_table[offset]);
@@ -431,6 +438,7 @@ List *SegManager::allocateList(reg_t *addr) {
 	table = (ListTable *)_heap[_listsSegId];
 
 	offset = table->allocEntry();
+	_gcCandidates++;
 
 	*addr = make_reg(_listsSegId, offset);
 	return &(table->_table[offset]);
@@ -445,6 +453,7 @@ Node *SegManager::allocateNode(reg_t *addr) {
 	table = (NodeTable *)_heap[_nodesSegId];
 
 	offset = table->allocEntry();
+	_gcCandidates++;
 
 	*addr = make_reg(_nodesSegId, offset);
 	return &(table->_table[offset]);
@@ -812,6 +821,7 @@ byte *SegManager::allocDynmem(int size, const char *descr, reg_t *addr) {
 	SegmentId seg;
 	SegmentObj *mobj = allocSegment(new DynMem(), &seg);
 	*addr = make_reg(seg, 0);
+	_gcCandidates++;
 
 	DynMem &d = *(DynMem *)mobj;
 
@@ -848,6 +858,7 @@ SciArray<reg_t> *SegManager::allocateArray(reg_t *addr) {
 		table = (ArrayTable *)_heap[_arraysSegId];
 
 	offset = table->allocEntry();
+	_gcCandidates++;
 
 	*addr = make_reg(_arraysSegId, offset);
 	return &(table->_table[offset]);
@@ -888,6 +899,7 @@ SciString *SegManager::allocateString(reg_t *addr) {
 		table = (StringTable *)_heap[_stringSegId];
 
 	offset = table->allocEntry();
+	_gcCandidates++;
 
 	*addr = make_reg(_stringSegId, offset);
 	return &(table->_table[offset]);
@@ -1012,6 +1024,7 @@ void SegManager::uninstantiateScript(int script_nr) {
 	if (!scr->getLockers()) {
 		// The actual script deletion seems to be done by SCI scripts themselves
 		scr->markDeleted();
+		_gcCandidates++;
 		debugC(kDebugLevelScripts, "Unloaded script 0x%x.", script_nr);
 	}
 }
@@ -441,11 +441,24 @@ public:
 
 	const Common::Array<SegmentObj *> &getSegments() const { return _heap; }
 
+	/** Selector lookups of send_selector(), flushed when a script goes away */
+	SelectorDispatchCache &getSelectorDispatchCache() { return _selectorDispatchCache; }
+
+	/**
+	 * Returns the number of objects which were allocated, or scripts which
+	 * were unloaded, since the last garbage collection. Only these can add
+	 * to the memory the garbage collector is able to free.
+	 */
+	uint32 getGCCandidates() const { return _gcCandidates; }
+	void resetGCCandidates() { _gcCandidates = 0; }
+
 private:
 	Common::Array<SegmentObj *> _heap;
 	Common::Array<Class> _classTable; /**< Table of all classes */
 	/** Map script ids to segment ids. */
 	Common::HashMap<int, SegmentId> _scriptSegMap;
+	SelectorDispatchCache _selectorDispatchCache;
+	uint32 _gcCandidates;
 
 	ResourceManager *_resMan;
 
@@ -295,4 +295,74 @@ SelectorType lookupSelector(SegManager *segMan, reg_t obj_location, Selector sel
 //	return _lookupSelector_function(segMan, obj, selectorId, fptr);
 }
 
+SelectorDispatchCache::SelectorDispatchCache() : _generation(1) {
+	memset(_inlineCache, 0, sizeof(_inlineCache));
+	resetStats();
+}
+
+SelectorType SelectorDispatchCache::lookup(SegManager *segMan, reg32_t callSite, reg_t obj, Selector selectorId, ObjVarRef *varp, reg_t *fptr) {
+	const Object *object = segMan->getObject(obj);
+	if (!object)
+		return lookupSelector(segMan, obj, selectorId, varp, fptr);
+
+	if (getSciVersion() == SCI_VERSION_0_EARLY)
+		selectorId &= ~1;
+
+	// Clones keep the position of the object they were cloned from
+	const reg_t species = object->getPos();
+
+	InlineEntry &entry = _inlineCache[(callSite.getSegment() * 31 + callSite.getOffset() * 7 + selectorId) & (kInlineCacheSize - 1)];
+	if (entry.generation == _generation && entry.callSite == callSite && entry.selector == selectorId && entry.species == species) {
+		_stats.inlineHits++;
+	} else {
+		DispatchTable &table = _tables[species];
+		DispatchTable::const_iterator cached = table.find(selectorId);
+
+		if (cached != table.end()) {
+			_stats.tableHits++;
+			entry.result = cached->_value;
+		} else {
+			_stats.misses++;
+
+			ObjVarRef var;
+			var.varindex = -1;
+			reg_t func = NULL_REG;
+			const SelectorType type = lookupSelector(segMan, obj, selectorId, &var, &func);
+			if (type == kSelectorNone)
+				return kSelectorNone;
+
+			entry.result.type = type;
+			entry.result.varIndex = var.varindex;
+			entry.result.func = func;
+			table[selectorId] = entry.result;
+		}
+
+		entry.generation = _generation;
+		entry.callSite = callSite;
+		entry.selector = selectorId;
+		entry.species = species;
+	}
+
+	if (entry.result.type == kSelectorVariable) {
+		if (varp) {
+			varp->obj = obj;
+			varp->varindex = entry.result.varIndex;
+		}
+	} else if (fptr) {
+		*fptr = entry.result.func;
+	}
+
+	return entry.result.type;
+}
+
+void SelectorDispatchCache::flush() {
+	_tables.clear();
+	_generation++;
+	_stats.flushes++;
+}
+
+void SelectorDispatchCache::resetStats() {
+	memset(&_stats, 0, sizeof(_stats));
+}
+
 } // End of namespace Sci
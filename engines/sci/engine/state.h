@@ -95,6 +95,31 @@ struct VideoState {
 	}
 };
 
+/** Statistics of the garbage collector, shown by the gc_stats console command */
+struct GCStats {
+	uint32 runs; ///< Number of collections
+	uint32 skipped; ///< Periodic collections skipped, as nothing collectable was allocated
+	uint32 freed; ///< Number of objects freed by all collections
+	uint32 lastPause; ///< Duration of the last collection, in ms
+	uint32 maxPause; ///< Duration of the longest collection, in ms
+	uint32 totalPause; ///< Time spent in all collections, in ms
+
+	GCStats() { reset(); }
+	void reset() {
+		runs = skipped = freed = 0;
+		lastPause = maxPause = totalPause = 0;
+	}
+};
+
+/**
+ * Visibility between the vertices of a polygon set, as found by kAvoidPath.
+ * The pairs of vertices are indexed in the order of the polygon set.
+ */
+struct AvoidPathVisibility {
+	Common::Array<int16> polygons; ///< Type, size and points of each polygon
+	Common::Array<byte> visible; ///< For each pair of vertices, if known yet
+};
+
 struct EngineState : public Common::Serializable {
 public:
 	EngineState(SegManager *segMan);
@@ -137,6 +162,9 @@ public:
 	Common::Point _cursorWorkaroundPoint;
 	Common::Rect _cursorWorkaroundRect;
 
+	/** Polygon sets kAvoidPath was last called with, most recent first */
+	Common::List<AvoidPathVisibility> _avoidPathCache;
+
 public:
 	/* VM Information */
 
@@ -184,6 +212,7 @@ public:
 	void shrinkStackToBase();
 
 	int gcCountDown; /**< Number of kernel calls until next gc */
+	GCStats gcStats;
 
 	MessageState *_msgState;
 
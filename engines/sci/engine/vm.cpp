@@ -272,6 +272,8 @@ ExecStack *send_selector(EngineState *s, reg_t send_obj, reg_t work_obj, StackPt
 	int origin = s->_executionStack.size() - 1; // Origin: Used for debugging
 	int activeBreakpointTypes = g_sci->_debugState._activeBreakpointTypes;
 	ObjVarRef varp;
+	SelectorDispatchCache &dispatchCache = s->_segMan->getSelectorDispatchCache();
+	const reg32_t callSite = s->_executionStack.empty() ? make_reg32(0, 0) : s->_executionStack.back().addr.pc;
 
 	Common::List<ExecStack>::iterator prevElementIterator = s->_executionStack.end();
 
@@ -283,7 +285,7 @@ ExecStack *send_selector(EngineState *s, reg_t send_obj, reg_t work_obj, StackPt
 		if (argc > 0x800)	// More arguments than the stack could possibly accomodate for
 			error("send_selector(): More than 0x800 arguments to function call");
 
-		SelectorType selectorType = lookupSelector(s->_segMan, send_obj, selector, &varp, &funcp);
+		SelectorType selectorType = dispatchCache.lookup(s->_segMan, callSite, send_obj, selector, &varp, &funcp);
 		if (selectorType == kSelectorNone)
 			error("Send to invalid selector 0x%x of object at %04x:%04x", 0xffff & selector, PRINT_REG(send_obj));
 
@@ -616,7 +618,7 @@ void run_vm(EngineState *s) {
 
 		// Get opcode
 		byte extOpcode;
-		s->xs->addr.pc.incOffset(readPMachineInstruction(scr->getBuf(s->xs->addr.pc.getOffset()), extOpcode, opparams));
+		s->xs->addr.pc.incOffset(scr->readInstruction(s->xs->addr.pc.getOffset(), extOpcode, opparams));
 		const byte opcode = extOpcode >> 1;
 		//debug("%s: %d, %d, %d, %d, acc = %04x:%04x, script %d, local script %d", opcodeNames[opcode], opparams[0], opparams[1], opparams[2], opparams[3], PRINT_REG(s->r_acc), scr->getScriptNumber(), local_script->getScriptNumber());
 
@@ -841,7 +843,13 @@ void run_vm(EngineState *s) {
 			// Run the garbage collector, if needed
 			if (s->gcCountDown-- <= 0) {
 				s->gcCountDown = s->scriptGCInterval;
-				run_gc(s);
+				// Objects which lost their last reference only hold on to
+				// memory, which can't grow without new allocations, so don't
+				// pay for marking the whole heap if nothing was allocated.
+				if (s->_segMan->getGCCandidates())
+					run_gc(s);
+				else
+					s->gcStats.skipped++;
 			}
 
 			// Call kernel function
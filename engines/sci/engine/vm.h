@@ -28,6 +28,7 @@
 #include "sci/engine/vm_types.h"	// for reg_t
 #include "sci/resource.h"	// for SciVersion
 
+#include "common/hashmap.h"
 #include "common/util.h"
 
 namespace Sci {
@@ -348,6 +349,68 @@ void script_debug(EngineState *s);
 SelectorType lookupSelector(SegManager *segMan, reg_t obj, Selector selectorid,
 		ObjVarRef *varp, reg_t *fptr);
 
+/**
+ * Caches the results of lookupSelector() for send_selector(). Every object
+ * definition, i.e. a class or an object of a script together with all of
+ * its clones, gets a dispatch table which maps selectors to its variables
+ * and methods, filled in as they are looked up. In front of these tables,
+ * an inline cache remembers the receiver and the result of the last send
+ * of each call site.
+ *
+ * Unloading a script may remove or move objects and their superclasses, so
+ * the whole cache is flushed whenever that happens.
+ */
+class SelectorDispatchCache {
+public:
+	struct Stats {
+		uint32 inlineHits;	///< Sends resolved by the inline cache
+		uint32 tableHits;	///< Sends resolved by a dispatch table
+		uint32 misses;		///< Sends which needed a full lookup
+		uint32 flushes;		///< Number of times the cache was flushed
+	};
+
+	SelectorDispatchCache();
+
+	/**
+	 * Looks up a selector of an object, like lookupSelector() does.
+	 * @param callSite	Address of the sending instruction
+	 */
+	SelectorType lookup(SegManager *segMan, reg32_t callSite, reg_t obj, Selector selectorId,
+		ObjVarRef *varp, reg_t *fptr);
+
+	/** Forgets all cached lookups */
+	void flush();
+
+	const Stats &getStats() const { return _stats; }
+	void resetStats();
+
+private:
+	enum {
+		kInlineCacheSize = 1024
+	};
+
+	struct Result {
+		SelectorType type;
+		int varIndex;
+		reg_t func;
+	};
+
+	struct InlineEntry {
+		uint32 generation;
+		reg32_t callSite;
+		Selector selector;
+		reg_t species;	///< Position of the definition of the receiver
+		Result result;
+	};
+
+	typedef Common::HashMap<Selector, Result> DispatchTable;
+
+	Common::HashMap<reg_t, DispatchTable, reg_t_Hash> _tables;
+	InlineEntry _inlineCache[kInlineCacheSize];
+	uint32 _generation;	///< Inline cache entries of older generations are stale
+	Stats _stats;
+};
+
 /**
  * Read a PMachine instruction from a memory buffer and return its length.
  *
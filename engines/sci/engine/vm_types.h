@@ -167,6 +167,12 @@ static inline reg_t make_reg(SegmentId segment, uint16 offset) {
 	return r;
 }
 
+struct reg_t_Hash {
+	uint operator()(const reg_t& x) const {
+		return (x.getSegment() << 3) ^ x.getOffset() ^ (x.getOffset() << 16);
+	}
+};
+
 #define PRINT_REG(r) (0xffff) & (unsigned) (r).getSegment(), (unsigned) (r).getOffset()
 
 // A true 32-bit reg_t
@@ -20,6 +20,7 @@
  *
  */
 
+#include "common/benchmark.h"
 #include "common/util.h"
 #include "common/stack.h"
 #include "graphics/primitives.h"
@@ -610,6 +611,9 @@ void GfxAnimate::kernelAnimate(reg_t listReference, bool cycle, int argc, reg_t
 		list = _s->_segMan->lookupList(listReference);
 	}
 
+	// Everything from here on is drawing, the doit methods have been run
+	Common::BenchmarkScope benchmark(Common::Benchmark::kCategoryRendering);
+
 	Port *oldPort = _ports->setPort((Port *)_ports->_picWind);
 	disposeLastCast();
 
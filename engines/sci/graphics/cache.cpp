@@ -20,6 +20,7 @@
  *
  */
 
+#include "common/config-manager.h"
 #include "common/util.h"
 #include "common/stack.h"
 #include "graphics/primitives.h"
@@ -35,7 +36,11 @@
 namespace Sci {
 
 GfxCache::GfxCache(ResourceManager *resMan, GfxScreen *screen, GfxPalette *palette)
-	: _resMan(resMan), _screen(screen), _palette(palette) {
+	: _resMan(resMan), _screen(screen), _palette(palette), _useCounter(0) {
+	_viewCacheBudget = VIEW_CACHE_SIZE;
+	if (ConfMan.hasKey("view_cache_size"))
+		_viewCacheBudget = MAX(ConfMan.getInt("view_cache_size"), 0) * 1024;
+	resetViewStats();
 }
 
 GfxCache::~GfxCache() {
@@ -45,8 +50,8 @@ GfxCache::~GfxCache() {
 
 void GfxCache::purgeFontCache() {
 	for (FontCache::iterator iter = _cachedFonts.begin(); iter != _cachedFonts.end(); ++iter) {
-		delete iter->_value;
-		iter->_value = 0;
+		delete iter->_value.object;
+		iter->_value.object = 0;
 	}
 
 	_cachedFonts.clear();
@@ -54,36 +59,98 @@ void GfxCache::purgeFontCache() {
 
 void GfxCache::purgeViewCache() {
 	for (ViewCache::iterator iter = _cachedViews.begin(); iter != _cachedViews.end(); ++iter) {
-		delete iter->_value;
-		iter->_value = 0;
+		delete iter->_value.object;
+		iter->_value.object = 0;
 	}
 
 	_cachedViews.clear();
 }
 
+void GfxCache::evictFont() {
+	FontCache::iterator oldest = _cachedFonts.begin();
+	for (FontCache::iterator iter = _cachedFonts.begin(); iter != _cachedFonts.end(); ++iter) {
+		if (iter->_value.lastUse < oldest->_value.lastUse)
+			oldest = iter;
+	}
+
+	delete oldest->_value.object;
+	_cachedFonts.erase(oldest);
+}
+
+void GfxCache::evictViews() {
+	uint32 size = getViewCacheSize();
+
+	// The views requested last are likely to be still in use by the caller,
+	// so some of them are always kept, whatever their size.
+	while (size > _viewCacheBudget && _cachedViews.size() > MIN_CACHED_VIEWS) {
+		ViewCache::iterator oldest = _cachedViews.begin();
+		for (ViewCache::iterator iter = _cachedViews.begin(); iter != _cachedViews.end(); ++iter) {
+			if (iter->_value.lastUse < oldest->_value.lastUse)
+				oldest = iter;
+		}
+
+		const uint32 viewSize = oldest->_value.object->getMemoryUsage();
+		delete oldest->_value.object;
+		_cachedViews.erase(oldest);
+
+		size -= viewSize;
+		_viewStats.evictedViews++;
+		_viewStats.evictedBytes += viewSize;
+	}
+}
+
+uint32 GfxCache::getViewCacheSize() const {
+	uint32 size = 0;
+	for (ViewCache::const_iterator iter = _cachedViews.begin(); iter != _cachedViews.end(); ++iter)
+		size += iter->_value.object->getMemoryUsage();
+	return size;
+}
+
+void GfxCache::resetViewStats() {
+	memset(&_viewStats, 0, sizeof(_viewStats));
+}
+
 GfxFont *GfxCache::getFont(GuiResourceId fontId) {
-	if (_cachedFonts.size() >= MAX_CACHED_FONTS)
-		purgeFontCache();
-
-	if (!_cachedFonts.contains(fontId)) {
-		// Create special SJIS font in japanese games, when font 900 is selected
-		if ((fontId == 900) && (g_sci->getLanguage() == Common::JA_JPN))
-			_cachedFonts[fontId] = new GfxFontSjis(_screen, fontId);
-		else
-			_cachedFonts[fontId] = new GfxFontFromResource(_resMan, _screen, fontId);
+	FontCache::iterator iter = _cachedFonts.find(fontId);
+	if (iter != _cachedFonts.end()) {
+		iter->_value.lastUse = ++_useCounter;
+		return iter->_value.object;
 	}
 
-	return _cachedFonts[fontId];
+	if (_cachedFonts.size() >= MAX_CACHED_FONTS)
+		evictFont();
+
+	CacheEntry<GfxFont> entry;
+	// Create special SJIS font in japanese games, when font 900 is selected
+	if ((fontId == 900) && (g_sci->getLanguage() == Common::JA_JPN))
+		entry.object = new GfxFontSjis(_screen, fontId);
+	else
+		entry.object = new GfxFontFromResource(_resMan, _screen, fontId);
+	entry.lastUse = ++_useCounter;
+	_cachedFonts[fontId] = entry;
+
+	return entry.object;
 }
 
 GfxView *GfxCache::getView(GuiResourceId viewId) {
-	if (_cachedViews.size() >= MAX_CACHED_VIEWS)
-		purgeViewCache();
+	ViewCache::iterator iter = _cachedViews.find(viewId);
+	if (iter != _cachedViews.end()) {
+		_viewStats.hits++;
+		iter->_value.lastUse = ++_useCounter;
+		return iter->_value.object;
+	}
+
+	// Cels get decoded after the view was handed out, so the budget is
+	// enforced whenever another view has to be loaded.
+	_viewStats.misses++;
+	evictViews();
 
-	if (!_cachedViews.contains(viewId))
-		_cachedViews[viewId] = new GfxView(_resMan, _screen, _palette, viewId);
+	CacheEntry<GfxView> entry;
+	entry.object = new GfxView(_resMan, _screen, _palette, viewId);
+	entry.lastUse = ++_useCounter;
+	_cachedViews[viewId] = entry;
 
-	return _cachedViews[viewId];
+	return entry.object;
 }
 
 int16 GfxCache::kernelViewGetCelWidth(GuiResourceId viewId, int16 loopNo, int16 celNo) {
@@ -30,14 +30,29 @@ namespace Sci {
 class GfxFont;
 class GfxView;
 
-typedef Common::HashMap<int, GfxFont *> FontCache;
-typedef Common::HashMap<int, GfxView *> ViewCache;
+template<typename T>
+struct CacheEntry {
+	T *object;
+	uint32 lastUse; ///< Value of GfxCache::_useCounter when last requested
+};
+
+typedef Common::HashMap<int, CacheEntry<GfxFont> > FontCache;
+typedef Common::HashMap<int, CacheEntry<GfxView> > ViewCache;
 
 /**
- * Cache class, handles caching of views/fonts
+ * Cache class, handles caching of views/fonts. Once the views, together
+ * with the cels decoded from them, take up more memory than the budget, the
+ * least recently used ones get dropped.
  */
 class GfxCache {
 public:
+	struct Stats {
+		uint32 hits;
+		uint32 misses;
+		uint32 evictedViews;
+		uint32 evictedBytes;
+	};
+
 	GfxCache(ResourceManager *resMan, GfxScreen *screen, GfxPalette *palette);
 	~GfxCache();
 
@@ -51,9 +66,19 @@ public:
 
 	byte kernelViewGetColorAtCoordinate(GuiResourceId viewId, int16 loopNo, int16 celNo, int16 x, int16 y);
 
+	/** Returns the hit rate and evictions of the view cache */
+	const Stats &getViewStats() const { return _viewStats; }
+	void resetViewStats();
+	/** Returns the memory taken up by the cached views, in bytes */
+	uint32 getViewCacheSize() const;
+	uint32 getViewCacheBudget() const { return _viewCacheBudget; }
+	uint getViewCacheCount() const { return _cachedViews.size(); }
+
 private:
 	void purgeFontCache();
 	void purgeViewCache();
+	void evictFont();
+	void evictViews();
 
 	ResourceManager *_resMan;
 	GfxScreen *_screen;
@@ -61,6 +86,9 @@ private:
 
 	FontCache _cachedFonts;
 	ViewCache _cachedViews;
+	uint32 _useCounter;
+	uint32 _viewCacheBudget;
+	Stats _viewStats;
 };
 
 } // End of namespace Sci
@@ -21,6 +21,7 @@
  */
 
 #include "common/algorithm.h"
+#include "common/benchmark.h"
 #include "common/events.h"
 #include "common/keyboard.h"
 #include "common/list_intern.h"
@@ -77,6 +78,7 @@ void GfxFrameout::clear() {
 	_planes.clear();
 	deletePlanePictures(NULL_REG);
 	clearScrollTexts();
+	_screen->getShownFrame().invalidate();
 }
 
 void GfxFrameout::clearScrollTexts() {
@@ -549,16 +551,16 @@ void GfxFrameout::showVideo() {
 
 		g_system->delayMillis(10);
 	}
+
+	_screen->invalidateCopiedScreen();
 }
 
 void GfxFrameout::createPlaneItemList(reg_t planeObject, FrameoutList &itemList) {
 	// Copy screen items of the current frame to the list of items to be drawn
 	for (FrameoutList::iterator listIterator = _screenItems.begin(); listIterator != _screenItems.end(); listIterator++) {
 		reg_t itemPlane = readSelector(_segMan, (*listIterator)->object, SELECTOR(plane));
-		if (planeObject == itemPlane) {
-			kernelUpdateScreenItem((*listIterator)->object);	// TODO: Why is this necessary?
+		if (planeObject == itemPlane)
 			itemList.push_back(*listIterator);
-		}
 	}
 
 	for (PlanePictureList::iterator pictureIt = _planePictures.begin(); pictureIt != _planePictures.end(); pictureIt++) {
@@ -643,7 +645,94 @@ void GfxFrameout::drawPicture(FrameoutEntry *itemEntry, int16 planeOffsetX, int1
 	//	warning("picture cel %d %d", itemEntry->celNo, itemEntry->priority);
 }
 
+static void pushFrameState(Common::Array<int16> &state, reg_t reg) {
+	state.push_back(reg.getSegment());
+	state.push_back(reg.getOffset());
+}
+
+static void pushFrameState(Common::Array<int16> &state, const Common::Rect &rect) {
+	state.push_back(rect.top);
+	state.push_back(rect.left);
+	state.push_back(rect.bottom);
+	state.push_back(rect.right);
+}
+
+bool GfxFrameout::getFrameState(Common::Array<int16> &state) {
+	// The scroll text and the text items are drawn from bitmaps, which may
+	// change without anything else changing, and remapped colors depend on
+	// the palette
+	if ((_showScrollText && !_scrollTexts.empty()) || _palette->isRemapping())
+		return false;
+
+	for (PlaneList::const_iterator it = _planes.begin(); it != _planes.end(); ++it) {
+		pushFrameState(state, it->object);
+		state.push_back(readSelectorValue(_segMan, it->object, SELECTOR(priority)));
+		state.push_back(it->lastPriority);
+		state.push_back(it->pictureId);
+		state.push_back(it->planeOffsetX);
+		state.push_back(it->planeOffsetY);
+		pushFrameState(state, it->planeRect);
+		state.push_back(it->planePictureMirrored);
+		state.push_back(it->planeBack);
+
+		for (PlaneLineList::const_iterator line = it->lines.begin(); line != it->lines.end(); ++line) {
+			state.push_back(line->startPoint.x);
+			state.push_back(line->startPoint.y);
+			state.push_back(line->endPoint.x);
+			state.push_back(line->endPoint.y);
+			state.push_back(line->color | (line->priority << 8));
+			state.push_back(line->control);
+		}
+		state.push_back(-1);
+	}
+
+	for (PlanePictureList::const_iterator it = _planePictures.begin(); it != _planePictures.end(); ++it) {
+		pushFrameState(state, it->object);
+		state.push_back(it->pictureId);
+		state.push_back(it->startX);
+		state.push_back(it->startY);
+	}
+
+	for (FrameoutList::const_iterator it = _screenItems.begin(); it != _screenItems.end(); ++it) {
+		const FrameoutEntry *itemEntry = *it;
+		if (lookupSelector(_segMan, itemEntry->object, SELECTOR(text), NULL, NULL) == kSelectorVariable)
+			return false;
+
+		pushFrameState(state, itemEntry->object);
+		pushFrameState(state, readSelector(_segMan, itemEntry->object, SELECTOR(plane)));
+		state.push_back(itemEntry->viewId);
+		state.push_back(itemEntry->loopNo);
+		state.push_back(itemEntry->celNo);
+		state.push_back(itemEntry->x);
+		state.push_back(itemEntry->y);
+		state.push_back(itemEntry->z);
+		state.push_back(itemEntry->priority);
+		state.push_back(itemEntry->signal);
+		state.push_back(itemEntry->scaleSignal);
+		state.push_back(itemEntry->scaleX);
+		state.push_back(itemEntry->scaleY);
+		state.push_back(itemEntry->visible);
+
+		if (readSelectorValue(_segMan, itemEntry->object, SELECTOR(useInsetRect))) {
+			state.push_back(readSelectorValue(_segMan, itemEntry->object, SELECTOR(inTop)));
+			state.push_back(readSelectorValue(_segMan, itemEntry->object, SELECTOR(inLeft)));
+			state.push_back(readSelectorValue(_segMan, itemEntry->object, SELECTOR(inBottom)));
+			state.push_back(readSelectorValue(_segMan, itemEntry->object, SELECTOR(inRight)));
+		} else if ((itemEntry->scaleSignal & kScaleSignalDoScaling32) &&
+		           !(itemEntry->scaleSignal & kScaleSignalDisableGlobalScaling32)) {
+			// Inputs of applyGlobalScaling()
+			reg_t globalVar2 = g_sci->getEngineState()->variables[VAR_GLOBAL][2];
+			state.push_back(readSelectorValue(_segMan, itemEntry->object, SELECTOR(maxScale)));
+			state.push_back(readSelectorValue(_segMan, globalVar2, SELECTOR(vanishingY)));
+		}
+	}
+
+	return true;
+}
+
 void GfxFrameout::kernelFrameout() {
+	Common::BenchmarkScope benchmark(Common::Benchmark::kCategoryRendering);
+
 	if (g_sci->_robotDecoder->isVideoLoaded()) {
 		showVideo();
 		return;
@@ -651,6 +740,29 @@ void GfxFrameout::kernelFrameout() {
 
 	_palette->palVaryUpdate();
 
+	for (FrameoutList::iterator listIterator = _screenItems.begin(); listIterator != _screenItems.end(); listIterator++)
+		kernelUpdateScreenItem((*listIterator)->object);	// TODO: Why is this necessary?
+
+	// Most frames only move a few items, if any. When nothing that gets
+	// drawn changed at all, and nothing else drew to the screen meanwhile,
+	// the screen already shows the frame.
+	FrameState &shownFrame = _screen->getShownFrame();
+	Common::Array<int16> frameState;
+	if (getFrameState(frameState)) {
+		if (shownFrame.isShown(frameState)) {
+			for (PlaneList::iterator it = _planes.begin(); it != _planes.end(); it++) {
+				if (it->priority >= 0 && it->pictureId != 0xFFFF)
+					_palette->drewPicture(it->pictureId);
+			}
+
+			g_sci->getEngineState()->_throttleTrigger = true;
+			return;
+		}
+		shownFrame.setShown(frameState);
+	} else {
+		shownFrame.invalidate();
+	}
+
 	for (PlaneList::iterator it = _planes.begin(); it != _planes.end(); it++) {
 		reg_t planeObject = it->object;
 
@@ -832,7 +944,7 @@ void GfxFrameout::kernelFrameout() {
 
 	showCurrentScrollText();
 
-	_screen->copyToScreen();
+	_screen->copyChangedToScreen();
 
 	g_sci->getEngineState()->_throttleTrigger = true;
 }
@@ -153,6 +153,12 @@ public:
 
 private:
 	void showVideo();
+	/**
+	 * Collects everything kernelFrameout() draws a frame from, to find out
+	 * whether a frame differs from the one before.
+	 * @return false if the frame has to be drawn regardless
+	 */
+	bool getFrameState(Common::Array<int16> &state);
 	void createPlaneItemList(reg_t planeObject, FrameoutList &itemList);
 	bool isPictureOutOfView(FrameoutEntry *itemEntry, Common::Rect planeRect, int16 planeOffsetX, int16 planeOffsetY);
 	void drawPicture(FrameoutEntry *itemEntry, int16 planeOffsetX, int16 planeOffsetY, bool planePictureMirrored);
@@ -23,6 +23,7 @@
 #ifndef SCI_GRAPHICS_HELPERS_H
 #define SCI_GRAPHICS_HELPERS_H
 
+#include "common/array.h"
 #include "common/endian.h"	// for READ_LE_UINT16
 #include "common/rect.h"
 #include "common/serializer.h"
@@ -33,7 +34,16 @@ namespace Sci {
 // Cache limits
 #define MAX_CACHED_CURSORS 10
 #define MAX_CACHED_FONTS 20
-#define MAX_CACHED_VIEWS 50
+#define MIN_CACHED_VIEWS 10
+
+// Default memory budget of the view cache in bytes, for the view resources
+// and their decoded cels. Can be overridden with the view_cache_size config
+// key, in KB.
+#if defined(__DS__) || defined(__GP32__) || defined(__N64__) || defined(__PLAYSTATION2__) || defined(__PSP__)
+#define VIEW_CACHE_SIZE (2 * 1024 * 1024)
+#else
+#define VIEW_CACHE_SIZE (16 * 1024 * 1024)
+#endif
 
 #define SCI_SHAKE_DIRECTION_VERTICAL 1
 #define SCI_SHAKE_DIRECTION_HORIZONTAL 2
@@ -135,6 +145,35 @@ struct PalSchedule {
 	uint32 schedule;
 };
 
+/**
+ * The state a frame on the screen was drawn from, see
+ * GfxFrameout::getFrameState(). kFrameout skips frames drawn from the state
+ * the screen already shows.
+ */
+class FrameState {
+public:
+	FrameState() : _valid(false) {}
+
+	/** Whether the screen shows the frame drawn from the given state. */
+	bool isShown(const Common::Array<int16> &state) const { return _valid && state == _state; }
+
+	/** Note that the screen now shows the frame drawn from the given state. */
+	void setShown(const Common::Array<int16> &state) {
+		_state = state;
+		_valid = true;
+	}
+
+	/** Note that something else was drawn to the screen. */
+	void invalidate() {
+		_state.clear();
+		_valid = false;
+	}
+
+private:
+	Common::Array<int16> _state;
+	bool _valid;
+};
+
 // Game view types, sorted by the number of colors
 enum ViewType {
 	kViewUnknown,   // uninitialized, or non-SCI
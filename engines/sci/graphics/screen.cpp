@@ -119,6 +119,8 @@ GfxScreen::GfxScreen(ResourceManager *resMan) : _resMan(resMan) {
 
 	// Sets display screen to be actually displayed
 	_activeScreen = _displayScreen;
+	_copiedScreen = NULL;
+	_copiedScreenSource = NULL;
 
 	_picNotValid = 0;
 	_picNotValidSci11 = 0;
@@ -161,12 +163,58 @@ GfxScreen::~GfxScreen() {
 	free(_priorityScreen);
 	free(_controlScreen);
 	free(_displayScreen);
+	free(_copiedScreen);
 }
 
 void GfxScreen::copyToScreen() {
 	g_system->copyRectToScreen(_activeScreen, _displayWidth, 0, 0, _displayWidth, _displayHeight);
 }
 
+void GfxScreen::copyChangedToScreen() {
+	if (!_copiedScreen)
+		_copiedScreen = (byte *)malloc(_displayPixels);
+
+	if (_copiedScreenSource != _activeScreen) {
+		copyToScreen();
+		memcpy(_copiedScreen, _activeScreen, _displayPixels);
+		_copiedScreenSource = _activeScreen;
+		return;
+	}
+
+	// Adjacent changed rows get copied as one rectangle, spanning the changed
+	// columns of all of them
+	int bandTop = -1;
+	int bandLeft = 0, bandRight = 0;
+
+	for (int y = 0; y <= _displayHeight; y++) {
+		const byte *src = _activeScreen + y * _displayWidth;
+		byte *copy = _copiedScreen + y * _displayWidth;
+
+		if (y < _displayHeight && memcmp(src, copy, _displayWidth)) {
+			int left = 0;
+			while (src[left] == copy[left])
+				left++;
+			int right = _displayWidth;
+			while (src[right - 1] == copy[right - 1])
+				right--;
+			memcpy(copy + left, src + left, right - left);
+
+			if (bandTop < 0) {
+				bandTop = y;
+				bandLeft = left;
+				bandRight = right;
+			} else {
+				bandLeft = MIN(bandLeft, left);
+				bandRight = MAX(bandRight, right);
+			}
+		} else if (bandTop >= 0) {
+			g_system->copyRectToScreen(_activeScreen + bandTop * _displayWidth + bandLeft, _displayWidth,
+				bandLeft, bandTop, bandRight - bandLeft, y - bandTop);
+			bandTop = -1;
+		}
+	}
+}
+
 void GfxScreen::copyFromScreen(byte *buffer) {
 	// TODO this ignores the pitch
 	Graphics::Surface *screen = g_system->lockScreen();
@@ -201,6 +249,9 @@ void GfxScreen::copyDisplayRectToScreen(const Common::Rect &rect) {
 }
 
 void GfxScreen::copyRectToScreen(const Common::Rect &rect, int16 x, int16 y) {
+	// The rect doesn't end up where it is in the active screen
+	invalidateCopiedScreen();
+
 	if (!_upscaledHires)  {
 		g_system->copyRectToScreen(_activeScreen + rect.top * _displayWidth + rect.left, _displayWidth, x, y, rect.width(), rect.height());
 	} else {
@@ -73,6 +73,21 @@ public:
 	byte getColorDefaultVectorData() { return _colorDefaultVectorData; }
 
 	void copyToScreen();
+	/**
+	 * Copies only the parts of the active screen which changed since the last
+	 * call to the actual screen. Whatever draws to the actual screen in other
+	 * ways has to call invalidateCopiedScreen() afterwards.
+	 */
+	void copyChangedToScreen();
+	void invalidateCopiedScreen() {
+		_copiedScreenSource = NULL;
+		_shownFrame.invalidate();
+	}
+	/**
+	 * The state of the frame kFrameout put on the screen last. It is
+	 * invalidated together with the copy of the screen.
+	 */
+	FrameState &getShownFrame() { return _shownFrame; }
 	void copyFromScreen(byte *buffer);
 	void kernelSyncWithFramebuffer();
 	void copyRectToScreen(const Common::Rect &rect);
@@ -177,6 +192,15 @@ private:
 	 */
 	byte *_activeScreen;
 
+	/**
+	 * What copyChangedToScreen() put on the actual screen, and the screen it
+	 * was copied from. _copiedScreenSource is NULL if the actual screen may
+	 * show something else now.
+	 */
+	byte *_copiedScreen;
+	const byte *_copiedScreenSource;
+	FrameState _shownFrame;
+
 	/**
 	 * This variable defines, if upscaled hires is active and what upscaled mode
 	 * is used.
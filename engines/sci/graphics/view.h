@@ -77,6 +77,8 @@ public:
 	void drawScaled(const Common::Rect &rect, const Common::Rect &clipRect, const Common::Rect &clipRectTranslated, int16 loopNo, int16 celNo, byte priority, int16 scaleX, int16 scaleY);
 	uint16 getLoopCount() const { return _loopCount; }
 	uint16 getCelCount(int16 loopNo) const;
+	/** Returns the memory held by the view resource and its decoded cels */
+	uint32 getMemoryUsage() const { return _resourceSize + _bitmapSize; }
 	Palette *getPalette();
 
 	bool isScaleable();
@@ -101,6 +103,7 @@ private:
 	Resource *_resource;
 	byte *_resourceData;
 	int _resourceSize;
+	uint32 _bitmapSize; ///< Total size of all rawBitmaps
 
 	uint16 _loopCount;
 	LoopInfo *_loop;
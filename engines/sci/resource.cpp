@@ -22,9 +22,13 @@
 
 // Resource library
 
+#include "common/algorithm.h"
+#include "common/config-manager.h"
 #include "common/file.h"
 #include "common/fs.h"
 #include "common/macresman.h"
+#include "common/savefile.h"
+#include "common/str-array.h"
 #include "common/textconsole.h"
 
 #include "sci/resource.h"
@@ -781,6 +785,9 @@ void DirectoryResourceSource::scanSource(ResourceManager *resMan) {
 }
 
 void ExtMapResourceSource::scanSource(ResourceManager *resMan) {
+	if (resMan->readIndexedMap(this))
+		return;
+
 	if (resMan->_mapVersion < kResVersionSci1Late)
 		resMan->readResourceMapSCI0(this);
 	else
@@ -892,11 +899,22 @@ void ResourceManager::init(bool initFromFallbackDetector) {
 	_LRU.clear();
 	_resMap.clear();
 	_audioMapSCI1 = NULL;
+	_indexMaps.clear();
+	_indexLoaded = false;
+	_indexRecording = false;
+
+	// The fallback detector has no game to keep an index for
+	if (!initFromFallbackDetector && g_sci) {
+		_indexLoaded = loadIndex();
+		_indexRecording = !_indexLoaded;
+	}
 
 	// FIXME: put this in an Init() function, so that we can error out if detection fails completely
 
-	_mapVersion = detectMapVersion();
-	_volVersion = detectVolVersion();
+	if (!_indexLoaded) {
+		_mapVersion = detectMapVersion();
+		_volVersion = detectVolVersion();
+	}
 
 	// TODO/FIXME: Remove once SCI3 resource detection is finished
 	if ((_mapVersion == kResVersionSci3 || _volVersion == kResVersionSci3) && (_mapVersion != _volVersion)) {
@@ -937,7 +955,12 @@ void ResourceManager::init(bool initFromFallbackDetector) {
 		scanNewSources();
 	}
 
-	detectSciVersion();
+	// The index already holds the SCI version and view type
+	if (!_indexLoaded)
+		detectSciVersion();
+
+	if (_indexRecording)
+		saveIndex();
 
 	debugC(1, kDebugLevelResMan, "resMan: Detected %s", getSciVersionDesc(getSciVersion()));
 
@@ -1577,6 +1600,206 @@ void ResourceManager::readResourcePatches() {
 	}
 }
 
+enum {
+	kResourceIndexVersion = 1
+};
+
+static void writeIndexString(Common::WriteStream &stream, const Common::String &str) {
+	stream.writeUint32LE(str.size());
+	stream.write(str.c_str(), str.size());
+}
+
+static Common::String readIndexString(Common::SeekableReadStream &stream) {
+	const uint32 size = stream.readUint32LE();
+	Common::String str;
+
+	if (size > (uint32)stream.size())
+		return str;
+
+	char *buf = new char[size];
+	stream.read(buf, size);
+	str = Common::String(buf, size);
+	delete[] buf;
+	return str;
+}
+
+Common::String ResourceManager::getIndexFileName() const {
+	return g_sci->getFilePrefix() + ".residx";
+}
+
+Common::String ResourceManager::getIndexFingerprint() const {
+	const Common::FSNode gameDataDir(ConfMan.get("path"));
+	Common::FSList files;
+	if (!gameDataDir.getChildren(files, Common::FSNode::kListFilesOnly))
+		return Common::String();
+
+	// Saved games and other files the game writes are kept out, in case they
+	// end up in the game directory.
+	Common::String prefix = g_sci->getFilePrefix();
+	prefix.toLowercase();
+
+	Common::StringArray entries;
+	for (Common::FSList::const_iterator file = files.begin(); file != files.end(); ++file) {
+		Common::String name = file->getName();
+		name.toLowercase();
+		if (name.hasPrefix(prefix))
+			continue;
+
+		int32 size;
+		uint32 modificationTime;
+		if (!file->getFileStatus(size, modificationTime))
+			return Common::String();
+
+		entries.push_back(Common::String::format("%s:%d:%u\n", name.c_str(), size, modificationTime));
+	}
+
+	Common::sort(entries.begin(), entries.end());
+
+	Common::String fingerprint;
+	for (uint i = 0; i < entries.size(); i++)
+		fingerprint += entries[i];
+	return fingerprint;
+}
+
+Common::String ResourceManager::getIndexMapKey(const ResourceSource *map) {
+	return Common::String::format("%s:%d", map->getLocationName().c_str(), map->_volumeNumber);
+}
+
+bool ResourceManager::loadIndex() {
+	Common::SeekableReadStream *in = g_sci->getSaveFileManager()->openForLoading(getIndexFileName());
+	if (!in)
+		return false;
+
+	bool valid = in->readUint32BE() == MKTAG('S', 'R', 'I', 'X')
+		&& in->readUint32LE() == kResourceIndexVersion
+#ifdef ENABLE_SCI32
+		&& in->readByte() == 1
+#else
+		&& in->readByte() == 0
+#endif
+		&& in->readUint32LE() == (uint32)g_sci->getGameId()
+		&& in->readUint32LE() == (uint32)g_sci->getLanguage()
+		&& in->readUint32LE() == (uint32)g_sci->getPlatform();
+
+	if (valid) {
+		const Common::String fingerprint = getIndexFingerprint();
+		valid = !fingerprint.empty() && readIndexString(*in) == fingerprint;
+	}
+
+	if (valid) {
+		_mapVersion = (ResVersion)in->readByte();
+		_volVersion = (ResVersion)in->readByte();
+		s_sciVersion = (SciVersion)in->readByte();
+		_viewType = (ViewType)in->readByte();
+
+		const uint32 mapCount = in->readUint32LE();
+		for (uint32 i = 0; i < mapCount && !in->eos() && !in->err(); i++) {
+			IndexEntryList &entries = _indexMaps[readIndexString(*in)];
+			const uint32 entryCount = in->readUint32LE();
+
+			for (uint32 j = 0; j < entryCount && !in->eos() && !in->err(); j++) {
+				IndexEntry entry;
+				const ResourceType type = (ResourceType)in->readByte();
+				const uint16 number = in->readUint16LE();
+				entry.id = ResourceId(type, number, in->readUint32LE());
+				entry.volume = in->readSint32LE();
+				entry.offset = in->readUint32LE();
+				entries.push_back(entry);
+			}
+		}
+
+		valid = !in->eos() && !in->err();
+	}
+
+	delete in;
+
+	if (!valid) {
+		_indexMaps.clear();
+		return false;
+	}
+
+	debugC(1, kDebugLevelResMan, "resMan: Using the resource index %s", getIndexFileName().c_str());
+	return true;
+}
+
+void ResourceManager::saveIndex() {
+	const Common::String fingerprint = getIndexFingerprint();
+	if (fingerprint.empty())
+		return;
+
+	Common::OutSaveFile *out = g_sci->getSaveFileManager()->openForSaving(getIndexFileName(), false);
+	if (!out) {
+		warning("Could not write the resource index");
+		return;
+	}
+
+	out->writeUint32BE(MKTAG('S', 'R', 'I', 'X'));
+	out->writeUint32LE(kResourceIndexVersion);
+#ifdef ENABLE_SCI32
+	out->writeByte(1);
+#else
+	out->writeByte(0);
+#endif
+	out->writeUint32LE(g_sci->getGameId());
+	out->writeUint32LE(g_sci->getLanguage());
+	out->writeUint32LE(g_sci->getPlatform());
+	writeIndexString(*out, fingerprint);
+
+	out->writeByte(_mapVersion);
+	out->writeByte(_volVersion);
+	out->writeByte(s_sciVersion);
+	out->writeByte(_viewType);
+
+	out->writeUint32LE(_indexMaps.size());
+	for (Common::HashMap<Common::String, IndexEntryList>::const_iterator i = _indexMaps.begin(); i != _indexMaps.end(); ++i) {
+		writeIndexString(*out, i->_key);
+		out->writeUint32LE(i->_value.size());
+
+		for (uint j = 0; j < i->_value.size(); j++) {
+			const IndexEntry &entry = i->_value[j];
+			out->writeByte(entry.id.getType());
+			out->writeUint16LE(entry.id.getNumber());
+			out->writeUint32LE(entry.id.getTuple());
+			out->writeSint32LE(entry.volume);
+			out->writeUint32LE(entry.offset);
+		}
+	}
+
+	out->finalize();
+	if (out->err())
+		warning("Could not write the resource index");
+
+	delete out;
+}
+
+bool ResourceManager::readIndexedMap(ResourceSource *map) {
+	if (!_indexLoaded)
+		return false;
+
+	const Common::String key = getIndexMapKey(map);
+	if (!_indexMaps.contains(key))
+		return false;
+
+	// Replaying the recorded entries in order leaves the same resources as
+	// reading the map did, as the sources are scanned in the same order.
+	const IndexEntryList &entries = _indexMaps[key];
+	for (uint i = 0; i < entries.size(); i++)
+		addVolumeResource(entries[i].id, findVolume(map, entries[i].volume), entries[i].offset);
+
+	return true;
+}
+
+void ResourceManager::recordIndexEntry(ResourceSource *map, ResourceId resId, int volume, uint32 offset) {
+	if (!_indexRecording)
+		return;
+
+	IndexEntry entry;
+	entry.id = resId;
+	entry.volume = volume;
+	entry.offset = offset;
+	_indexMaps[getIndexMapKey(map)].push_back(entry);
+}
+
 int ResourceManager::readResourceMapSCI0(ResourceSource *map) {
 	Common::SeekableReadStream *fileStream = 0;
 	ResourceType type = kResourceTypeInvalid;	// to silence a false positive in MSVC
@@ -1641,6 +1864,7 @@ int ResourceManager::readResourceMapSCI0(ResourceSource *map) {
 			}
 
 			addResource(resId, source, offset & (((~bMask) << 24) | 0xFFFFFF));
+			recordIndexEntry(map, resId, offset >> bShift, offset & (((~bMask) << 24) | 0xFFFFFF));
 		}
 	} while (!fileStream->eos());
 
@@ -1717,24 +1941,8 @@ int ResourceManager::readResourceMapSCI1(ResourceSource *map) {
 
 			assert(source);
 
-			Resource *resource = _resMap.getVal(resId, NULL);
-			if (!resource) {
-				addResource(resId, source, fileOffset);
-			} else {
-				// If the resource is already present in a volume, change it to
-				// the new content (but only in a volume, so as not to overwrite
-				// external patches - refer to bug #3366295).
-				// This is needed at least for the German version of Pharkas.
-				// That version contains several duplicate resources INSIDE the
-				// resource data files like fonts, views, scripts, etc. Thus,
-				// if we use the first entries in the resource file, half of the
-				// game will be English and umlauts will also be missing :P
-				if (resource->_source->getSourceType() == kSourceVolume) {
-					resource->_source = source;
-					resource->_fileOffset = fileOffset;
-					resource->size = 0;
-				}
-			}
+			addVolumeResource(resId, source, fileOffset);
+			recordIndexEntry(map, resId, mapVolumeNr, fileOffset);
 		}
 	}
 
@@ -1844,6 +2052,27 @@ void ResourceManager::addResource(ResourceId resId, ResourceSource *src, uint32
 	}
 }
 
+void ResourceManager::addVolumeResource(ResourceId resId, ResourceSource *volume, uint32 offset) {
+	Resource *resource = _resMap.getVal(resId, NULL);
+	if (!resource) {
+		addResource(resId, volume, offset);
+	} else {
+		// If the resource is already present in a volume, change it to
+		// the new content (but only in a volume, so as not to overwrite
+		// external patches - refer to bug #3366295).
+		// This is needed at least for the German version of Pharkas.
+		// That version contains several duplicate resources INSIDE the
+		// resource data files like fonts, views, scripts, etc. Thus,
+		// if we use the first entries in the resource file, half of the
+		// game will be English and umlauts will also be missing :P
+		if (resource->_source && resource->_source->getSourceType() == kSourceVolume) {
+			resource->_source = volume;
+			resource->_fileOffset = offset;
+			resource->size = 0;
+		}
+	}
+}
+
 Resource *ResourceManager::updateResource(ResourceId resId, ResourceSource *src, uint32 size) {
 	// Update a patched resource, whether it exists or not
 	Resource *res = 0;
@@ -24,8 +24,10 @@
 #define SCI_RESOURCE_H
 
 #include "common/str.h"
+#include "common/array.h"
 #include "common/list.h"
 #include "common/hashmap.h"
+#include "common/hash-str.h"
 
 #include "sci/graphics/helpers.h"		// for ViewType
 #include "sci/decompressor.h"
@@ -398,6 +400,18 @@ protected:
 	ResVersion _volVersion; ///< resource.0xx version
 	ResVersion _mapVersion; ///< resource.map version
 
+	/** A resource map entry, as kept in the resource index */
+	struct IndexEntry {
+		ResourceId id;
+		int volume;
+		uint32 offset;
+	};
+	typedef Common::Array<IndexEntry> IndexEntryList;
+
+	Common::HashMap<Common::String, IndexEntryList> _indexMaps; ///< Resource index entries, by map source
+	bool _indexLoaded; ///< Detection results and map entries were read from the resource index
+	bool _indexRecording; ///< Map entries are recorded for a new resource index
+
 	/**
 	 * Add a path to the resource manager's list of sources.
 	 * @return a pointer to the added source structure, or NULL if an error occurred.
@@ -447,6 +461,11 @@ protected:
 	void loadResource(Resource *res);
 	void freeOldResources();
 	void addResource(ResourceId resId, ResourceSource *src, uint32 offset, uint32 size = 0);
+	/**
+	 * Adds a resource from a map, or moves it to the given volume if it was
+	 * already found in another volume.
+	 */
+	void addVolumeResource(ResourceId resId, ResourceSource *volume, uint32 offset);
 	Resource *updateResource(ResourceId resId, ResourceSource *src, uint32 size);
 	void removeAudioResource(ResourceId resId);
 
@@ -483,6 +502,34 @@ protected:
 	 */
 	int readAudioMapSCI1(ResourceSource *map, bool unload = false);
 
+	/**--- Resource index functions ---*/
+
+	/**
+	 * The resource index keeps the detected map, volume and SCI versions,
+	 * the view type and the entries of all resource maps of a game in its
+	 * save directory, so later launches can skip the detection and the
+	 * parsing of the maps. It is only used while the files in the game
+	 * directory keep their sizes and modification times.
+	 */
+	Common::String getIndexFileName() const;
+	Common::String getIndexFingerprint() const;
+	static Common::String getIndexMapKey(const ResourceSource *map);
+
+	/**
+	 * Reads the resource index of the current game.
+	 * @return true if a valid index was found
+	 */
+	bool loadIndex();
+	void saveIndex();
+
+	/**
+	 * Adds the resources of a map from the loaded resource index.
+	 * @param map The map
+	 * @return true if the index had the entries of this map
+	 */
+	bool readIndexedMap(ResourceSource *map);
+	void recordIndexEntry(ResourceSource *map, ResourceId resId, int volume, uint32 offset);
+
 	/**--- Patch management functions ---*/
 
 	/**
@@ -20,6 +20,7 @@
  *
  */
 
+#include "common/benchmark.h"
 #include "common/system.h"	// for setFocusRectangle/clearFocusRectangle
 #include "scumm/scumm.h"
 #include "scumm/actor.h"
@@ -1242,6 +1243,7 @@ AdjustBoxResult Actor::adjustXYToBeInBox(int dstX, int dstY) {
 	int tmpDist, bestDist, threshold, numBoxes;
 	byte flags, bestBox;
 	int box;
+	Common::Array<uint32> nearBoxes;
 	const int firstValidBox = (_vm->_game.features & GF_SMALL_HEADER) ? 0 : 1;
 
 	abr.x = dstX;
@@ -1261,6 +1263,9 @@ AdjustBoxResult Actor::adjustXYToBeInBox(int dstX, int dstY) {
 		bestDist = (_vm->_game.version >= 7) ? 0x7FFFFFFF : 0xFFFF;
 		bestBox = kInvalidBox;
 
+		if (threshold > 0)
+			_vm->getBoxCache().findBoxesNear(dstX, dstY, threshold, nearBoxes);
+
 		// We iterate (backwards) over all boxes, searching the one closest
 		// to the desired coordinates.
 		for (box = numBoxes; box >= firstValidBox; box--) {
@@ -1272,8 +1277,8 @@ AdjustBoxResult Actor::adjustXYToBeInBox(int dstX, int dstY) {
 
 			// For increased performance, we perform a quick test if
 			// the coordinates can even be within a distance of 'threshold'
-			// pixels of the box.
-			if (threshold > 0 && inBoxQuickReject(_vm->getBoxCoordinates(box), dstX, dstY, threshold))
+			// pixels of the box, looking at the nearby boxes only.
+			if (threshold > 0 && (!BoxCache::isInMask(nearBoxes, box) || inBoxQuickReject(_vm->getBoxCoordinates(box), dstX, dstY, threshold)))
 				continue;
 
 			// Check if the point is contained in the box. If it is,
@@ -1542,6 +1547,8 @@ Actor *ScummEngine::derefActorSafe(int id, const char *errmsg) const {
 
 
 void ScummEngine::processActors() {
+	Common::BenchmarkScope benchmark(Common::Benchmark::kCategoryRendering);
+
 	int numactors = 0;
 
 	// Make a list of all actors in this room
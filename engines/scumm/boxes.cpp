@@ -571,7 +571,31 @@ bool ScummEngine::checkXYInBoxBounds(int boxnum, int x, int y) {
 	return true;
 }
 
+const BoxCache &ScummEngine::getBoxCache() {
+	if (!_boxCache->isValid()) {
+		Common::Array<BoxCoords> coords;
+		const int numOfBoxes = getNumBoxes();
+		for (int i = 0; i < numOfBoxes; i++)
+			coords.push_back(decodeBoxCoordinates(i));
+		_boxCache->build(coords);
+	}
+	return *_boxCache;
+}
+
+void ScummEngine::invalidateBoxCache() {
+	_boxCache->invalidate();
+}
+
 BoxCoords ScummEngine::getBoxCoordinates(int boxnum) {
+	const BoxCache &cache = getBoxCache();
+	if (boxnum >= 0 && boxnum < cache.getNumBoxes())
+		return cache.getCoords(boxnum);
+
+	// Out of range boxes are handled (or rejected) by getBoxBaseAddr
+	return decodeBoxCoordinates(boxnum);
+}
+
+BoxCoords ScummEngine::decodeBoxCoordinates(int boxnum) {
 	BoxCoords tmp, *box = &tmp;
 	Box *bp = getBoxBaseAddr(boxnum);
 	assert(bp);
@@ -684,6 +708,113 @@ int getClosestPtOnBox(const BoxCoords &box, int x, int y, int16& outX, int16& ou
 	return bestdist;
 }
 
+BoxCache::BoxCache() : _valid(false), _gridLeft(0), _gridTop(0), _gridWidth(0), _gridHeight(0), _gridWords(0) {
+}
+
+void BoxCache::build(const Common::Array<BoxCoords> &coords) {
+	_coords = coords;
+	_valid = true;
+
+	_grid.clear();
+	_gridWidth = _gridHeight = 0;
+	_gridWords = (coords.size() + 31) / 32;
+	if (coords.empty())
+		return;
+
+	// Determine the bounding rectangle of each box, and of all of them
+	Common::Array<int> bounds;
+	int gridRight = 0, gridBottom = 0;
+	for (uint i = 0; i < coords.size(); i++) {
+		const BoxCoords &box = coords[i];
+		const int left = MIN(MIN(box.ul.x, box.ur.x), MIN(box.ll.x, box.lr.x));
+		const int top = MIN(MIN(box.ul.y, box.ur.y), MIN(box.ll.y, box.lr.y));
+		const int right = MAX(MAX(box.ul.x, box.ur.x), MAX(box.ll.x, box.lr.x));
+		const int bottom = MAX(MAX(box.ul.y, box.ur.y), MAX(box.ll.y, box.lr.y));
+
+		if (i == 0 || left < _gridLeft)
+			_gridLeft = left;
+		if (i == 0 || top < _gridTop)
+			_gridTop = top;
+		if (i == 0 || right > gridRight)
+			gridRight = right;
+		if (i == 0 || bottom > gridBottom)
+			gridBottom = bottom;
+
+		bounds.push_back(left);
+		bounds.push_back(top);
+		bounds.push_back(right);
+		bounds.push_back(bottom);
+	}
+
+	_gridWidth = (gridRight - _gridLeft) / kGridCellSize + 1;
+	_gridHeight = (gridBottom - _gridTop) / kGridCellSize + 1;
+	_grid.resize(_gridWidth * _gridHeight * _gridWords);
+
+	// Add each box to all cells its bounding rectangle overlaps
+	for (uint i = 0; i < coords.size(); i++) {
+		const int x1 = (bounds[i * 4 + 0] - _gridLeft) / kGridCellSize;
+		const int y1 = (bounds[i * 4 + 1] - _gridTop) / kGridCellSize;
+		const int x2 = (bounds[i * 4 + 2] - _gridLeft) / kGridCellSize;
+		const int y2 = (bounds[i * 4 + 3] - _gridTop) / kGridCellSize;
+
+		for (int y = y1; y <= y2; y++) {
+			for (int x = x1; x <= x2; x++)
+				_grid[(y * _gridWidth + x) * _gridWords + (i >> 5)] |= 1u << (i & 31);
+		}
+	}
+}
+
+void BoxCache::findBoxesNear(int x, int y, int dist, Common::Array<uint32> &mask) const {
+	mask.clear();
+	mask.resize(_gridWords);
+
+	const int left = MAX(x - dist, _gridLeft);
+	const int top = MAX(y - dist, _gridTop);
+	const int right = MIN(x + dist, _gridLeft + _gridWidth * kGridCellSize - 1);
+	const int bottom = MIN(y + dist, _gridTop + _gridHeight * kGridCellSize - 1);
+	if (left > right || top > bottom)
+		return;
+
+	const int x1 = (left - _gridLeft) / kGridCellSize;
+	const int y1 = (top - _gridTop) / kGridCellSize;
+	const int x2 = (right - _gridLeft) / kGridCellSize;
+	const int y2 = (bottom - _gridTop) / kGridCellSize;
+
+	for (int cy = y1; cy <= y2; cy++) {
+		for (int cx = x1; cx <= x2; cx++) {
+			const uint32 *cell = &_grid[(cy * _gridWidth + cx) * _gridWords];
+			for (uint i = 0; i < _gridWords; i++)
+				mask[i] |= cell[i];
+		}
+	}
+}
+
+const byte *BoxCache::findItinerary(const Common::Array<byte> &boxData) {
+	for (Common::List<Itinerary>::iterator it = _itineraries.begin(); it != _itineraries.end(); ++it) {
+		if (it->boxData.size() != boxData.size() || memcmp(it->boxData.begin(), boxData.begin(), boxData.size()))
+			continue;
+
+		if (it != _itineraries.begin()) {
+			_itineraries.push_front(*it);
+			_itineraries.erase(it);
+		}
+		return _itineraries.front().matrix.begin();
+	}
+
+	return 0;
+}
+
+const byte *BoxCache::addItinerary(const Common::Array<byte> &boxData, const byte *matrix, uint size) {
+	_itineraries.push_front(Itinerary());
+	_itineraries.front().boxData = boxData;
+	_itineraries.front().matrix.assign(matrix, matrix + size);
+
+	if (_itineraries.size() > kItineraryCacheSize)
+		_itineraries.pop_back();
+
+	return _itineraries.front().matrix.begin();
+}
+
 byte *ScummEngine::getBoxMatrixBaseAddr() {
 	byte *ptr = getResourceAddress(rtMatrix, 1);
 	assert(ptr);
@@ -720,8 +851,7 @@ int ScummEngine::getNextBox(byte from, byte to) {
 
 	if (_game.version == 0) {
 		// calculate shortest paths
-		byte *itineraryMatrix = (byte *)malloc(numOfBoxes * numOfBoxes);
-		calcItineraryMatrix(itineraryMatrix, numOfBoxes);
+		const byte *itineraryMatrix = getItineraryMatrix(numOfBoxes);
 
 		dest = to;
 		do {
@@ -731,7 +861,6 @@ int ScummEngine::getNextBox(byte from, byte to) {
 		if (dest == Actor::kInvalidBox)
 			dest = -1;
 
-		free(itineraryMatrix);
 		return dest;
 	} else if (_game.version <= 2) {
 		// The v2 box matrix is a real matrix with numOfBoxes rows and columns.
@@ -929,7 +1058,7 @@ static void printMatrix(byte *boxm, int num) {
 	}
 }
 
-static void printMatrix2(byte *matrix, int num) {
+static void printMatrix2(const byte *matrix, int num) {
 	int i, j;
 	debug("    ");
 	for (i = 0; i < num; i++)
@@ -1005,6 +1134,37 @@ void ScummEngine::calcItineraryMatrix(byte *itineraryMatrix, int num) {
 	free(adjacentMatrix);
 }
 
+/**
+ * Returns the itinerary matrix (see calcItineraryMatrix) for the current
+ * walk boxes, computing it only if it was not computed from the same box
+ * data before.
+ */
+const byte *ScummEngine::getItineraryMatrix(int num) {
+	// The neighbors of the boxes are determined by their coordinates and
+	// flags, or in V0 given by the box matrix
+	Common::Array<byte> boxData;
+	const ResourceManager::Resource &boxes = _res->_types[rtMatrix][2];
+	if (boxes._address)
+		boxData.assign(boxes._address, boxes._address + boxes._size);
+	if (_game.version == 0) {
+		const ResourceManager::Resource &matrix = _res->_types[rtMatrix][1];
+		if (matrix._address)
+			boxData.insert_at(boxData.size(), Common::Array<byte>(matrix._address, matrix._size));
+	}
+
+	const byte *itineraryMatrix = _boxCache->findItinerary(boxData);
+	if (itineraryMatrix)
+		return itineraryMatrix;
+
+	const uint8 boxSize = (_game.version == 0) ? num : 64;
+	byte *newMatrix = (byte *)malloc(boxSize * boxSize);
+	calcItineraryMatrix(newMatrix, num);
+
+	itineraryMatrix = _boxCache->addItinerary(boxData, newMatrix, boxSize * boxSize);
+	free(newMatrix);
+	return itineraryMatrix;
+}
+
 void ScummEngine::createBoxMatrix() {
 	int num, i, j;
 
@@ -1014,8 +1174,7 @@ void ScummEngine::createBoxMatrix() {
 	const uint8 boxSize = (_game.version == 0) ? num : 64;
 
 	// calculate shortest paths
-	byte *itineraryMatrix = (byte *)malloc(boxSize * boxSize);
-	calcItineraryMatrix(itineraryMatrix, num);
+	const byte *itineraryMatrix = getItineraryMatrix(num);
 
 	// "Compress" the distance matrix into the box matrix format used
 	// by the engine. The format is like this:
@@ -1056,8 +1215,6 @@ void ScummEngine::createBoxMatrix() {
 	debug("compressed matrix:\n");
 	printMatrix(getBoxMatrixBaseAddr(), num);
 #endif
-
-	free(itineraryMatrix);
 }
 
 /** Check if two boxes are neighbors. */
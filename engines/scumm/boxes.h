@@ -23,6 +23,8 @@
 #ifndef SCUMM_BOXES_H
 #define SCUMM_BOXES_H
 
+#include "common/array.h"
+#include "common/list.h"
 #include "common/rect.h"
 
 namespace Scumm {
@@ -51,6 +53,72 @@ struct BoxCoords {			/* Box coordinates */
 
 int getClosestPtOnBox(const BoxCoords &box, int x, int y, int16& outX, int16& outY);
 
+/**
+ * Data derived from the walk boxes of the current room, so that it does not
+ * have to be computed again for every actor and frame:
+ * - The decoded coordinates of each box, and a grid over them telling which
+ *   boxes may be near a point. Both are dropped whenever the box resources
+ *   change, and rebuilt on demand.
+ * - The last few itinerary matrices computed, keyed by the box data they
+ *   were computed from. Scripts tend to switch back and forth between a few
+ *   sets of box flags (e.g. for doors), and rebuild the box matrix each time.
+ */
+class BoxCache {
+public:
+	BoxCache();
+
+	void invalidate() { _valid = false; }
+	bool isValid() const { return _valid; }
+
+	/** Set the decoded coordinates of all walk boxes, and build the grid. */
+	void build(const Common::Array<BoxCoords> &coords);
+
+	int getNumBoxes() const { return _coords.size(); }
+	const BoxCoords &getCoords(int box) const { return _coords[box]; }
+
+	/**
+	 * Find the boxes whose bounding rectangles may be within the given
+	 * distance of a point. Some of the boxes set in the mask may still be
+	 * further away, but none of the others is nearer.
+	 */
+	void findBoxesNear(int x, int y, int dist, Common::Array<uint32> &mask) const;
+
+	/** Check if a box is set in a mask filled by findBoxesNear(). */
+	static bool isInMask(const Common::Array<uint32> &mask, int box) {
+		return (uint)(box >> 5) >= mask.size() || (mask[box >> 5] & (1u << (box & 31)));
+	}
+
+	/**
+	 * Look up the itinerary matrix computed from the given box data.
+	 * @return the matrix, or 0 if it is not cached
+	 */
+	const byte *findItinerary(const Common::Array<byte> &boxData);
+
+	/** Cache an itinerary matrix, evicting the least recently used one. */
+	const byte *addItinerary(const Common::Array<byte> &boxData, const byte *matrix, uint size);
+
+private:
+	enum {
+		kGridCellSize = 32,
+		kItineraryCacheSize = 8
+	};
+
+	struct Itinerary {
+		Common::Array<byte> boxData;
+		Common::Array<byte> matrix;
+	};
+
+	bool _valid;
+	Common::Array<BoxCoords> _coords;
+
+	int _gridLeft, _gridTop;
+	int _gridWidth, _gridHeight; ///< In cells
+	uint _gridWords; ///< Number of 32 bit words holding the boxes of a cell
+	Common::Array<uint32> _grid;
+
+	Common::List<Itinerary> _itineraries; ///< Most recently used first
+};
+
 } // End of namespace Scumm
 
 #endif
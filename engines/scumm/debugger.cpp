@@ -31,6 +31,7 @@
 #include "scumm/debugger.h"
 #include "scumm/imuse/imuse.h"
 #include "scumm/object.h"
+#include "scumm/prefetch.h"
 #include "scumm/resource.h"
 #include "scumm/scumm.h"
 #include "scumm/sound.h"
@@ -79,6 +80,7 @@ ScummDebugger::ScummDebugger(ScummEngine *s)
 	DCmd_Register("scr",       WRAP_METHOD(ScummDebugger, Cmd_Script));
 	DCmd_Register("scripts",   WRAP_METHOD(ScummDebugger, Cmd_PrintScript));
 	DCmd_Register("importres", WRAP_METHOD(ScummDebugger, Cmd_ImportRes));
+	DCmd_Register("resources", WRAP_METHOD(ScummDebugger, Cmd_Resources));
 
 	if (_vm->_game.id == GID_LOOM)
 		DCmd_Register("drafts",  WRAP_METHOD(ScummDebugger, Cmd_PrintDraft));
@@ -311,6 +313,45 @@ bool ScummDebugger::Cmd_ImportRes(int argc, const char** argv) {
 	return true;
 }
 
+bool ScummDebugger::Cmd_Resources(int argc, const char **argv) {
+	ResourceManager *res = _vm->_res;
+
+	if (argc > 1 && !strcmp(argv[1], "reset")) {
+		res->resetStats();
+		_vm->_prefetcher->resetStats();
+		DebugPrintf("Resource statistics reset\n");
+		return true;
+	}
+
+	if (argc > 2 && !strcmp(argv[1], "heap")) {
+		int max = atoi(argv[2]);
+		int min = (argc > 3) ? atoi(argv[3]) : max / 4 * 3;
+		if (max <= 0 || min < 0 || min > max) {
+			DebugPrintf("Syntax: resources heap <max KB> [<min KB>]\n");
+			return true;
+		}
+		res->setHeapThreshold(min * 1024, max * 1024);
+	} else if (argc > 1) {
+		DebugPrintf("Syntax: resources [reset | heap <max KB> [<min KB>]]\n");
+		return true;
+	}
+
+	const ResourceManager::Stats &stats = res->getStats();
+	const uint32 lookups = stats.hits + stats.loads;
+
+	DebugPrintf("Heap: %d KB allocated, expiring from %d KB down to %d KB\n", res->getAllocatedSize() / 1024,
+		res->getMaxHeapThreshold() / 1024, res->getMinHeapThreshold() / 1024);
+	DebugPrintf("Lookups: %d hits, %d loads (%.1f%% hits)\n", stats.hits, stats.loads,
+		lookups ? stats.hits * 100.0 / lookups : 0.0);
+	DebugPrintf("Reloads: %d resources, %d KB\n", stats.reloads, stats.reloadedBytes / 1024);
+	DebugPrintf("Expired: %d resources, %d KB\n", stats.expired, stats.expiredBytes / 1024);
+
+	const RoomPrefetcher::Stats &prefetchStats = _vm->_prefetcher->getStats();
+	DebugPrintf("Prefetched: %d rooms (%d entered next), %d resources, %d KB\n", prefetchStats.rooms,
+		prefetchStats.entered, prefetchStats.resources, prefetchStats.bytes / 1024);
+	return true;
+}
+
 bool ScummDebugger::Cmd_PrintScript(int argc, const char **argv) {
 	int i;
 	ScriptSlot *ss = _vm->vm.slot;
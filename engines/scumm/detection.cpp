@@ -940,7 +940,8 @@ bool ScummEngine::hasFeature(EngineFeature f) const {
 		(f == kSupportsRTL) ||
 		(f == kSupportsLoadingDuringRuntime) ||
 		(f == kSupportsSavingDuringRuntime) ||
-		(f == kSupportsSubtitleOptions);
+		(f == kSupportsSubtitleOptions) ||
+		(f == kSupportsFrameLoop);
 }
 
 GameList ScummMetaEngine::getSupportedGames() const {
@@ -19,6 +19,7 @@
  *
  */
 
+#include "common/benchmark.h"
 #include "common/system.h"
 #include "scumm/actor.h"
 #include "scumm/charset.h"
@@ -214,6 +215,9 @@ Gdi::Gdi(ScummEngine *vm) : _vm(vm) {
 	_zbufferDisabled = false;
 	_objectMode = false;
 	_distaff = false;
+	_stripCache.smap = 0;
+	_stripCache.height = 0;
+	_cacheStrips = false;
 }
 
 Gdi::~Gdi() {
@@ -274,6 +278,41 @@ void Gdi::init() {
 }
 
 void Gdi::roomChanged(byte *roomptr) {
+	clearStripCache();
+}
+
+void Gdi::clearStripCache() {
+	_stripCache.smap = 0;
+	_stripCache.height = 0;
+	_stripCache.pixels.clear();
+	_stripCache.valid.clear();
+}
+
+/**
+ * Get the cache entry for a strip of the room background, (re)initializing
+ * the cache if it was filled from other data.
+ * @return the strip's pixels, or 0 if it cannot be cached
+ */
+byte *Gdi::getCachedStrip(const byte *smap_ptr, int stripnr, int height, bool &valid) {
+	// Keep the cache within reasonable bounds for the largest rooms
+	const uint kMaxStripCacheSize = 2 * 1024 * 1024;
+
+	const int numStrips = _vm->_roomWidth / 8;
+	if (stripnr < 0 || stripnr >= numStrips || (uint)(numStrips * 8 * height) > kMaxStripCacheSize)
+		return 0;
+
+	if (_stripCache.smap != smap_ptr || _stripCache.height != height || memcmp(_stripCache.roomPalette, _roomPalette, 256)) {
+		_stripCache.smap = smap_ptr;
+		_stripCache.height = height;
+		memcpy(_stripCache.roomPalette, _roomPalette, 256);
+		_stripCache.pixels.resize(numStrips * 8 * height);
+		_stripCache.valid.clear();
+		_stripCache.valid.resize(numStrips);
+	}
+
+	valid = _stripCache.valid[stripnr];
+	_stripCache.valid[stripnr] = true;
+	return &_stripCache.pixels[stripnr * 8 * height];
 }
 
 void GdiNES::roomChanged(byte *roomptr) {
@@ -503,6 +542,8 @@ void ScummEngine::markRectAsDirty(VirtScreenNumber virt, int left, int right, in
  * code in the backend is controlled from here.
  */
 void ScummEngine::drawDirtyScreenParts() {
+	Common::BenchmarkScope benchmark(Common::Benchmark::kCategoryRendering);
+
 	// Update verbs
 	updateDirtyScreen(kVerbVirtScreen);
 
@@ -1007,7 +1048,7 @@ void ScummEngine::redrawBGStrip(int start, int num) {
 	else
 		room = getResourceAddress(rtRoom, _roomResource);
 
-	_gdi->drawBitmap(room + _IM00_offs, &_virtscr[kMainVirtScreen], s, 0, _roomWidth, _virtscr[kMainVirtScreen].h, s, num, 0);
+	_gdi->drawBitmap(room + _IM00_offs, &_virtscr[kMainVirtScreen], s, 0, _roomWidth, _virtscr[kMainVirtScreen].h, s, num, Gdi::dbRoomBackground);
 }
 
 void ScummEngine::restoreBackground(Common::Rect rect, byte backColor) {
@@ -1795,6 +1836,7 @@ void Gdi::drawBitmap(const byte *ptr, VirtScreen *vs, int x, const int y, const
 	_vertStripNextInc = height * vs->pitch - 1 * vs->format.bytesPerPixel;
 
 	_objectMode = (flag & dbObjectMode) == dbObjectMode;
+	_cacheStrips = (flag & dbRoomBackground) && vs->format.bytesPerPixel == 1;
 	prepareDrawBitmap(ptr, vs, x, y, width, height, stripnr, numstrip);
 
 	sx = x - vs->xstart / 8;
@@ -1904,7 +1946,27 @@ bool Gdi::drawStrip(byte *dstPtr, VirtScreen *vs, int x, int y, const int width,
 			_roomPalette = _vm->_roomPalette;
 	}
 
-	return decompressBitmap(dstPtr, vs->pitch, smap_ptr + offset, height);
+	if (!_cacheStrips)
+		return decompressBitmap(dstPtr, vs->pitch, smap_ptr + offset, height);
+
+	bool valid;
+	byte *cached = getCachedStrip(smap_ptr, stripnr, height, valid);
+	if (cached && valid) {
+		for (int i = 0; i < height; i++, cached += 8, dstPtr += vs->pitch)
+			memcpy(dstPtr, cached, 8);
+		return false;
+	}
+
+	const bool transpStrip = decompressBitmap(dstPtr, vs->pitch, smap_ptr + offset, height);
+	if (cached) {
+		if (transpStrip) {
+			_stripCache.valid[stripnr] = false;
+		} else {
+			for (int i = 0; i < height; i++, cached += 8, dstPtr += vs->pitch)
+				memcpy(cached, dstPtr, 8);
+		}
+	}
+	return transpStrip;
 }
 
 bool GdiNES::drawStrip(byte *dstPtr, VirtScreen *vs, int x, int y, const int width, const int height,
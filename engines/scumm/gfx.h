@@ -24,6 +24,7 @@
 #define SCUMM_GFX_H
 
 #include "common/system.h"
+#include "common/array.h"
 #include "common/list.h"
 
 #include "graphics/surface.h"
@@ -197,6 +198,25 @@ protected:
 	/** Flag which is true when an object is being rendered, false otherwise. */
 	bool _objectMode;
 
+	/**
+	 * The decoded strips of the room background, so that scrolling back and
+	 * forth over a wide room does not decode the same strips over and over.
+	 * Only opaque strips are cached, as the others depend on what was drawn
+	 * below them.
+	 */
+	struct StripCache {
+		const byte *smap; ///< The strip table the strips were decoded from
+		int height;
+		byte roomPalette[256]; ///< The room palette they were decoded with
+		Common::Array<byte> pixels; ///< 8 x height pixels per strip
+		Common::Array<bool> valid;
+	} _stripCache;
+
+	/** Flag which is true when the room background is being drawn. */
+	bool _cacheStrips;
+
+	byte *getCachedStrip(const byte *smap_ptr, int stripnr, int height, bool &valid);
+
 public:
 	/** Flag which is true when loading objects or titles for distaff, in PCEngine version of Loom. */
 	bool _distaff;
@@ -250,6 +270,7 @@ public:
 
 	virtual void init();
 	virtual void roomChanged(byte *roomptr);
+	void clearStripCache();
 	virtual void loadTiles(byte *roomptr);
 	void setTransparentColor(byte transparentColor) { _transparentColor = transparentColor; }
 
@@ -270,7 +291,8 @@ public:
 	enum DrawBitmapFlags {
 		dbAllowMaskOr   = 1 << 0,
 		dbDrawMaskOnAll = 1 << 1,
-		dbObjectMode    = 2 << 2
+		dbObjectMode    = 2 << 2,
+		dbRoomBackground = 1 << 4
 	};
 };
 
@@ -81,14 +81,27 @@ int MoviePlayer::load(const char *filename, int flags, int image) {
 	return 0;
 }
 
-void MoviePlayer::copyFrameToBuffer(byte *dst, int dstType, uint x, uint y, uint pitch) {
+bool MoviePlayer::copyFrameToBuffer(byte *dst, int dstType, uint x, uint y, uint pitch) {
 	uint h = _video->getHeight();
 	uint w = _video->getWidth();
 
+	// Have 16 bit frames written to the screen buffer directly, as they
+	// are copied unchanged anyway
+	if ((_vm->_game.features & GF_16BIT_COLOR) && dstType == kDstScreen && _video->getPixelFormat().bytesPerPixel == 2) {
+		Graphics::Surface screen;
+		screen.pixels = dst + y * pitch + x * 2;
+		screen.w = w;
+		screen.h = h;
+		screen.pitch = pitch;
+		screen.format = _video->getPixelFormat();
+
+		return _video->decodeNextFrameTo(screen);
+	}
+
 	const Graphics::Surface *surface = _video->decodeNextFrame();
 
 	if (!surface)
-		return;
+		return false;
 
 	byte *src = (byte *)surface->pixels;
 
@@ -143,6 +156,8 @@ void MoviePlayer::copyFrameToBuffer(byte *dst, int dstType, uint x, uint y, uint
 			src += w;
 		} while (--h);
 	}
+
+	return true;
 }
 
 void MoviePlayer::handleNextFrame() {
@@ -158,13 +173,11 @@ void MoviePlayer::handleNextFrame() {
 		assert(dst);
 		copyFrameToBuffer(dst, kDstResource, 0, 0, _vm->_screenWidth * _vm->_bytesPerPixel);
 	} else if (_flags & 1) {
-		copyFrameToBuffer(pvs->getBackPixels(0, 0), kDstScreen, 0, 0, pvs->pitch);
-
-		Common::Rect imageRect(_video->getWidth(), _video->getHeight());
-		_vm->restoreBackgroundHE(imageRect);
-	} else {
-		copyFrameToBuffer(pvs->getPixels(0, 0), kDstScreen, 0, 0, pvs->pitch);
-
+		if (copyFrameToBuffer(pvs->getBackPixels(0, 0), kDstScreen, 0, 0, pvs->pitch)) {
+			Common::Rect imageRect(_video->getWidth(), _video->getHeight());
+			_vm->restoreBackgroundHE(imageRect);
+		}
+	} else if (copyFrameToBuffer(pvs->getPixels(0, 0), kDstScreen, 0, 0, pvs->pitch)) {
 		Common::Rect imageRect(_video->getWidth(), _video->getHeight());
 		_vm->markRectAsDirty(kMainVirtScreen, imageRect);
 	}
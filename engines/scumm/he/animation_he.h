@@ -41,7 +41,8 @@ public:
 	int getImageNum();
 	int load(const char *filename, int flags, int image = 0);
 
-	void copyFrameToBuffer(byte *dst, int dstType, uint x, uint y, uint pitch);
+	/** Decode the next frame into dst, return whether there was one */
+	bool copyFrameToBuffer(byte *dst, int dstType, uint x, uint y, uint pitch);
 	void handleNextFrame();
 
 	void close();
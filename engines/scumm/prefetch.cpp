@@ -0,0 +1,170 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "common/config-manager.h"
+#include "common/system.h"
+
+#include "scumm/prefetch.h"
+#include "scumm/resource.h"
+#include "scumm/scumm.h"
+
+namespace Scumm {
+
+RoomPrefetcher::RoomPrefetcher(ScummEngine *vm) : _vm(vm) {
+	_enabled = !ConfMan.hasKey("prefetch_rooms") || ConfMan.getBool("prefetch_rooms");
+	_lastRoom = 0;
+	_queuePos = 0;
+}
+
+void RoomPrefetcher::roomEntered(int room) {
+	if (!_enabled)
+		return;
+
+	uint i;
+	for (i = 0; i < _rooms.size(); i++) {
+		if (_rooms[i] == room) {
+			_stats.entered++;
+			break;
+		}
+	}
+
+	if (_lastRoom > 0 && _lastRoom != room) {
+		for (i = 0; i < _transitions.size(); i++) {
+			if (_transitions[i].from == _lastRoom && _transitions[i].to == room)
+				break;
+		}
+		if (i == _transitions.size()) {
+			Transition t;
+			t.from = _lastRoom;
+			t.to = room;
+			t.count = 0;
+			_transitions.push_back(t);
+		}
+		_transitions[i].count++;
+	}
+
+	_rooms.clear();
+	_queue.clear();
+	_queuePos = 0;
+
+	// Pick the rooms most often entered from this one so far
+	while (_rooms.size() < kMaxRooms) {
+		int best = -1;
+		for (i = 0; i < _transitions.size(); i++) {
+			const Transition &t = _transitions[i];
+			if (t.from != room || (best >= 0 && t.count <= _transitions[best].count))
+				continue;
+
+			uint j;
+			for (j = 0; j < _rooms.size() && _rooms[j] != t.to; j++)
+				;
+			if (j == _rooms.size())
+				best = i;
+		}
+		if (best < 0)
+			break;
+		_rooms.push_back(_transitions[best].to);
+	}
+
+	// Going back is always a good guess
+	if (_rooms.size() < kMaxRooms && _lastRoom > 0 && _lastRoom != room &&
+		(_rooms.empty() || _rooms[0] != _lastRoom))
+		_rooms.push_back(_lastRoom);
+
+	_lastRoom = room;
+
+	for (i = 0; i < _rooms.size(); i++)
+		queueRoom(_rooms[i]);
+}
+
+void RoomPrefetcher::queueRoom(int room) {
+	const ResourceManager *res = _vm->_res;
+
+	if (room <= 0 || room >= (int)res->_types[rtRoom].size())
+		return;
+
+	// Rooms on another disc of COMI would need a disc change
+	if (_vm->_game.version == 8 && res->_types[rtRoom][room]._roomno != res->_types[rtRoom][_vm->_roomResource]._roomno)
+		return;
+
+	_stats.rooms++;
+
+	queueResource(rtRoom, room);
+	if (_vm->_game.version == 8)
+		queueResource(rtRoomScripts, room);
+	else if (_vm->_game.heversion >= 70)
+		queueResource(rtRoomImage, room);
+
+	// The global scripts and costumes stored in the room are mostly the
+	// ones used there
+	static const ResType types[] = { rtScript, rtCostume };
+	for (int i = 0; i < ARRAYSIZE(types); i++) {
+		const ResourceManager::ResTypeData &data = res->_types[types[i]];
+		for (ResId idx = 1; idx < data.size(); idx++) {
+			if (data[idx]._roomno == room && data[idx]._roomoffs != RES_INVALID_OFFSET && !data[idx]._address)
+				queueResource(types[i], idx);
+		}
+	}
+}
+
+void RoomPrefetcher::queueResource(ResType type, ResId idx) {
+	Item item;
+	item.type = type;
+	item.idx = idx;
+	_queue.push_back(item);
+}
+
+void RoomPrefetcher::run(uint32 msecs) {
+	ResourceManager *res = _vm->_res;
+	const uint32 start = g_system->getMillis();
+
+	while (_queuePos < _queue.size()) {
+		// Only use free heap space, the prefetched resources should never
+		// push out the ones in use
+		if (res->getAllocatedSize() >= res->getMinHeapThreshold())
+			return;
+
+		const Item &item = _queue[_queuePos++];
+		if (item.idx >= res->_types[item.type].size() || res->_types[item.type][item.idx]._address)
+			continue;
+
+		// Creating a resource past the high threshold expires others, so
+		// resources which do not fit below it are left to be loaded when
+		// they are used
+		const uint32 size = _vm->peekResourceSize(item.type, item.idx);
+		if (size == 0 || res->getAllocatedSize() + size >= res->getMaxHeapThreshold())
+			continue;
+
+		_vm->ensureResourceLoaded(item.type, item.idx);
+
+		if (res->_types[item.type][item.idx]._address) {
+			// Until the resource is used, it is the first to be expired
+			res->setResourceCounter(item.type, item.idx, 0x7F);
+			_stats.resources++;
+			_stats.bytes += res->_types[item.type][item.idx]._size;
+		}
+
+		if (g_system->getMillis() - start >= msecs)
+			return;
+	}
+}
+
+} // End of namespace Scumm
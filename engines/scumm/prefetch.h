@@ -0,0 +1,116 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef SCUMM_PREFETCH_H
+#define SCUMM_PREFETCH_H
+
+#include "common/array.h"
+#include "scumm/scumm.h"	// for ResType
+
+namespace Scumm {
+
+class ScummEngine;
+
+/**
+ * Loads the resources of the rooms the player is likely to enter next, in
+ * the time left over between frames, so that entering them does not stall
+ * on reading the game data files.
+ *
+ * Room exits are implemented by scripts in SCUMM and cannot be told from the
+ * room data, so the likely rooms are learned from the room changes seen so
+ * far. Until a room has been left once, the room the player came from is
+ * assumed to be the likely one.
+ *
+ * The resources are loaded by the engine thread. The resource manager and
+ * the data file the engine reads from are not locked, and any script may
+ * load or expire resources, so a loading thread would race with them.
+ */
+class RoomPrefetcher {
+public:
+	/**
+	 * Statistics of the prefetcher, shown by the "resources" debugger
+	 * command.
+	 */
+	struct Stats {
+		uint32 rooms; ///< Rooms queued for prefetching
+		uint32 entered; ///< Room changes to one of the queued rooms
+		uint32 resources; ///< Resources loaded ahead of time
+		uint32 bytes; ///< Total size of those resources
+
+		Stats() { reset(); }
+		void reset() {
+			rooms = entered = resources = bytes = 0;
+		}
+	};
+
+	RoomPrefetcher(ScummEngine *vm);
+
+	/**
+	 * Learn from a room change, and queue the resources of the rooms likely
+	 * to be entered from the new room.
+	 */
+	void roomEntered(int room);
+
+	/**
+	 * Load queued resources for at most the given time. Nothing is loaded
+	 * if the heap is too full to do so without expiring other resources.
+	 */
+	void run(uint32 msecs);
+
+	const Stats &getStats() const { return _stats; }
+	void resetStats() { _stats.reset(); }
+
+private:
+	enum {
+		kMaxRooms = 2 ///< Number of rooms prefetched after a room change
+	};
+
+	/** How often the player went from one room to another */
+	struct Transition {
+		uint16 from;
+		uint16 to;
+		uint32 count;
+	};
+
+	struct Item {
+		ResType type;
+		ResId idx;
+	};
+
+	ScummEngine *_vm;
+	bool _enabled;
+
+	Common::Array<Transition> _transitions;
+	int _lastRoom;
+
+	Common::Array<int> _rooms; ///< The rooms queued at the last room change
+	Common::Array<Item> _queue;
+	uint _queuePos;
+
+	Stats _stats;
+
+	void queueRoom(int room);
+	void queueResource(ResType type, ResId idx);
+};
+
+} // End of namespace Scumm
+
+#endif
@@ -48,6 +48,7 @@ enum {
 	RF_USAGE_MAX = RF_USAGE,
 
 	RS_MODIFIED = 0x10,
+	RS_EXPIRED = 0x20,
 	RF_OFFHEAP = 0x40
 };
 
@@ -540,9 +541,18 @@ void ResourceManager::allocResTypeData(ResType type, uint32 tag, int num, ResTyp
 
 	// If there was data in there, let's clear it out completely. This is important
 	// in case we are restarting the game.
+	for (ResId idx = 0; idx < _types[type].size(); idx++) {
+		if (isInExpiryList(_types[type][idx]))
+			removeFromExpiryList(_types[type][idx]);
+	}
 	_types[type].clear();
 	_types[type].resize(num);
 
+	for (ResId idx = 0; idx < _types[type].size(); idx++) {
+		_types[type][idx]._type = type;
+		_types[type][idx]._idx = idx;
+	}
+
 /*
 	TODO: Use multiple Resource subclasses, one for each res mode; then,
 	given them serializability.
@@ -700,6 +710,40 @@ int ScummEngine::loadResource(ResType type, ResId idx) {
 	return 1;
 }
 
+uint32 ScummEngine::peekResourceSize(ResType type, ResId idx) {
+	// Sounds and small header charsets have headers of their own
+	if (type == rtSound || (type == rtCharset && (_game.features & GF_SMALL_HEADER)))
+		return 0;
+
+	if (idx >= _res->_types[type].size())
+		return 0;
+
+	int roomNr = getResourceRoomNr(type, idx);
+	if (roomNr == 0)
+		roomNr = _roomResource;
+
+	const uint32 fileOffs = getResourceRoomOffset(type, idx);
+	if (fileOffs == RES_INVALID_OFFSET)
+		return 0;
+
+	openRoom(roomNr);
+
+	_fileHandle->seek(fileOffs + _fileOffset, SEEK_SET);
+
+	// The same headers loadResource() reads
+	if (_game.features & GF_OLD_BUNDLE)
+		return _fileHandle->readUint16LE();
+
+	if (_game.features & GF_SMALL_HEADER) {
+		if (_game.version == 4)
+			_fileHandle->seek(8, SEEK_CUR);
+		return _fileHandle->readUint32LE();
+	}
+
+	_fileHandle->seek(4, SEEK_CUR);
+	return _fileHandle->readUint32BE();
+}
+
 int ScummEngine::getResourceRoomNr(ResType type, ResId idx) {
 	if (type == rtRoom && _game.heversion < 70)
 		return idx;
@@ -736,8 +780,11 @@ byte *ScummEngine::getResourceAddress(ResType type, ResId idx) {
 		return NULL;
 
 	// If the resource is missing, but loadable from the game data files, try to do so.
-	if (!_res->_types[type][idx]._address && _res->_types[type]._mode != kDynamicResTypeMode) {
-		ensureResourceLoaded(type, idx);
+	if (_res->_types[type]._mode != kDynamicResTypeMode) {
+		if (!_res->_types[type][idx]._address)
+			ensureResourceLoaded(type, idx);
+		else
+			_res->countHit();
 	}
 
 	ptr = (byte *)_res->_types[type][idx]._address;
@@ -777,19 +824,34 @@ void ResourceManager::increaseExpireCounter() {
 }
 
 void ResourceManager::increaseResourceCounters() {
-	for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1)) {
-		ResId idx = _types[type].size();
-		while (idx-- > 0) {
-			byte counter = _types[type][idx].getResourceCounter();
-			if (counter && counter < RF_USAGE_MAX) {
-				setResourceCounter(type, idx, counter + 1);
-			}
+	// Only the counters of resources which may be expired are of interest,
+	// so skip the (in HE games several thousand) unloaded ones.
+	for (Resource *res = _expiryHead; res; res = res->_expiryNext) {
+		byte counter = res->getResourceCounter();
+		if (counter && counter < RF_USAGE_MAX) {
+			res->setResourceCounter(counter + 1);
 		}
 	}
 }
 
 void ResourceManager::setResourceCounter(ResType type, ResId idx, byte counter) {
-	_types[type][idx].setResourceCounter(counter);
+	Resource &res = _types[type][idx];
+	res.setResourceCounter(counter);
+
+	if (!isInExpiryList(res))
+		return;
+
+	if (counter == 1 && _expiryTail != &res) {
+		// Just used, so make it the last to be expired
+		removeFromExpiryList(res);
+		addToExpiryList(res);
+	} else if (counter >= RF_USAGE_MAX && _expiryHead != &res) {
+		// Scripts use this to ask for the resource to be expired first
+		removeFromExpiryList(res);
+		res._expiryNext = _expiryHead;
+		_expiryHead->_expiryPrev = &res;
+		_expiryHead = &res;
+	}
 }
 
 void ResourceManager::Resource::setResourceCounter(byte counter) {
@@ -831,9 +893,23 @@ byte *ResourceManager::createResource(ResType type, ResId idx, uint32 size) {
 	memset(ptr, 0, size + SAFETY_AREA);
 	_allocatedSize += size;
 
-	_types[type][idx]._address = ptr;
-	_types[type][idx]._size = size;
-	setResourceCounter(type, idx, 1);
+	Resource &res = _types[type][idx];
+	res._address = ptr;
+	res._size = size;
+	res.setResourceCounter(1);
+
+	if (_types[type]._mode != kDynamicResTypeMode) {
+		_stats.loads++;
+		if (res._status & RS_EXPIRED) {
+			res._status &= ~RS_EXPIRED;
+			_stats.reloads++;
+			_stats.reloadedBytes += size;
+		}
+	}
+
+	if (isExpirable(res))
+		addToExpiryList(res);
+
 	return ptr;
 }
 
@@ -842,6 +918,10 @@ ResourceManager::Resource::Resource() {
 	_size = 0;
 	_flags = 0;
 	_status = 0;
+	_type = rtInvalid;
+	_idx = 0;
+	_expiryPrev = 0;
+	_expiryNext = 0;
 	_roomno = 0;
 	_roomoffs = 0;
 }
@@ -872,6 +952,8 @@ ResourceManager::ResourceManager(ScummEngine *vm) : _vm(vm) {
 	_maxHeapThreshold = 0;
 	_minHeapThreshold = 0;
 	_expireCounter = 0;
+	_expiryHead = 0;
+	_expiryTail = 0;
 }
 
 ResourceManager::~ResourceManager() {
@@ -895,8 +977,14 @@ bool ResourceManager::validateResource(const char *str, ResType type, ResId idx)
 
 void ResourceManager::nukeResource(ResType type, ResId idx) {
 	byte *ptr = _types[type][idx]._address;
+
+	// This is also called before the resource is (re)created
+	if (type == rtMatrix)
+		_vm->invalidateBoxCache();
 	if (ptr != NULL) {
 		debugC(DEBUG_RESOURCE, "nukeResource(%s,%d)", nameOfResType(type), idx);
+		if (isInExpiryList(_types[type][idx]))
+			removeFromExpiryList(_types[type][idx]);
 		_allocatedSize -= _types[type][idx]._size;
 		_types[type][idx].nuke();
 	}
@@ -931,12 +1019,16 @@ void ResourceManager::lock(ResType type, ResId idx) {
 	if (!validateResource("Locking", type, idx))
 		return;
 	_types[type][idx].lock();
+	if (isInExpiryList(_types[type][idx]))
+		removeFromExpiryList(_types[type][idx]);
 }
 
 void ResourceManager::unlock(ResType type, ResId idx) {
 	if (!validateResource("Unlocking", type, idx))
 		return;
 	_types[type][idx].unlock();
+	if (isExpirable(_types[type][idx]) && !isInExpiryList(_types[type][idx]))
+		addToExpiryList(_types[type][idx]);
 }
 
 bool ResourceManager::isLocked(ResType type, ResId idx) const {
@@ -998,12 +1090,16 @@ void ResourceManager::setOffHeap(ResType type, ResId idx) {
 	if (!validateResource("setOffHeap", type, idx))
 		return;
 	_types[type][idx].setOffHeap();
+	if (isInExpiryList(_types[type][idx]))
+		removeFromExpiryList(_types[type][idx]);
 }
 
 void ResourceManager::setOnHeap(ResType type, ResId idx) {
 	if (!validateResource("setOnHeap", type, idx))
 		return;
 	_types[type][idx].setOnHeap();
+	if (isExpirable(_types[type][idx]) && !isInExpiryList(_types[type][idx]))
+		addToExpiryList(_types[type][idx]);
 }
 
 bool ResourceManager::isModified(ResType type, ResId idx) const {
@@ -1032,10 +1128,38 @@ void ResourceManager::Resource::setOnHeap() {
 	_status &= ~RF_OFFHEAP;
 }
 
+bool ResourceManager::isExpirable(const Resource &res) const {
+	// Resources of dynamic types cannot be reloaded from the data files
+	return res._address && _types[res._type]._mode != kDynamicResTypeMode && !res.isLocked() && !res.isOffHeap();
+}
+
+bool ResourceManager::isInExpiryList(const Resource &res) const {
+	return res._expiryPrev || _expiryHead == &res;
+}
+
+void ResourceManager::addToExpiryList(Resource &res) {
+	res._expiryPrev = _expiryTail;
+	res._expiryNext = 0;
+	if (_expiryTail)
+		_expiryTail->_expiryNext = &res;
+	else
+		_expiryHead = &res;
+	_expiryTail = &res;
+}
+
+void ResourceManager::removeFromExpiryList(Resource &res) {
+	if (res._expiryPrev)
+		res._expiryPrev->_expiryNext = res._expiryNext;
+	else
+		_expiryHead = res._expiryNext;
+	if (res._expiryNext)
+		res._expiryNext->_expiryPrev = res._expiryPrev;
+	else
+		_expiryTail = res._expiryPrev;
+	res._expiryPrev = res._expiryNext = 0;
+}
+
 void ResourceManager::expireResources(uint32 size) {
-	byte best_counter;
-	ResType best_type;
-	int best_res = 0;
 	uint32 oldAllocatedSize;
 
 	if (_expireCounter != 0xFF) {
@@ -1048,31 +1172,20 @@ void ResourceManager::expireResources(uint32 size) {
 
 	oldAllocatedSize = _allocatedSize;
 
-	do {
-		best_type = rtInvalid;
-		best_counter = 2;
-
-		for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1)) {
-			if (_types[type]._mode != kDynamicResTypeMode) {
-				// Resources of this type can be reloaded from the data files,
-				// so we can potentially unload them to free memory.
-				ResId idx = _types[type].size();
-				while (idx-- > 0) {
-					Resource &tmp = _types[type][idx];
-					byte counter = tmp.getResourceCounter();
-					if (!tmp.isLocked() && counter >= best_counter && tmp._address && !_vm->isResourceInUse(type, idx) && !tmp.isOffHeap()) {
-						best_counter = counter;
-						best_type = type;
-						best_res = idx;
-					}
-				}
-			}
+	// The expiry list is ordered from the least recently used resource on,
+	// which is also the order of decreasing counters. Resources used since
+	// the counters were last increased, or in use otherwise, are spared.
+	Resource *res = _expiryHead;
+	while (res && size + _allocatedSize > _minHeapThreshold) {
+		Resource *next = res->_expiryNext;
+		if (res->getResourceCounter() >= 2 && !_vm->isResourceInUse(res->_type, res->_idx)) {
+			_stats.expired++;
+			_stats.expiredBytes += res->_size;
+			nukeResource(res->_type, res->_idx);
+			res->_status |= RS_EXPIRED;
 		}
-
-		if (!best_type)
-			break;
-		nukeResource(best_type, best_res);
-	} while (size + _allocatedSize > _minHeapThreshold);
+		res = next;
+	}
 
 	increaseResourceCounters();
 
@@ -1134,6 +1247,8 @@ void ResourceManager::resourceStats() {
 	}
 
 	debug(1, "Total allocated size=%d, locked=%d(%d)", _allocatedSize, lockedSize, lockedNum);
+	debug(1, "Hits=%d, loads=%d, reloads=%d(%d), expired=%d(%d)", _stats.hits, _stats.loads,
+		_stats.reloads, _stats.reloadedBytes, _stats.expired, _stats.expiredBytes);
 }
 
 void ScummEngine_v5::readMAXS(int blockSize) {
@@ -80,6 +80,7 @@ protected:
 
 public:
 	class Resource {
+	friend class ResourceManager;
 	public:
 		/**
 		 * Pointer to the data contained in this resource
@@ -104,11 +105,23 @@ public:
 		byte _flags;
 
 		/**
-		 * The status of the resource. Currently only one bit is used, which
-		 * indicates whether the resource is modified.
+		 * The status of the resource: whether it is modified, kept off the
+		 * heap, or was expired since it was last loaded.
 		 */
 		byte _status;
 
+		/**
+		 * The type and index of this resource, set by allocResTypeData().
+		 */
+		ResType _type;
+		ResId _idx;
+
+		/**
+		 * The neighbours of this resource in the resource manager's expiry
+		 * list, see ResourceManager::_expiryHead.
+		 */
+		Resource *_expiryPrev, *_expiryNext;
+
 	public:
 		/**
 		 * The id of the room (resp. the disk) the resource is contained in.
@@ -170,16 +183,58 @@ public:
 	};
 	ResTypeData _types[rtLast + 1];
 
+	/**
+	 * Statistics of the resource cache, shown by the "resources" debugger
+	 * command.
+	 */
+	struct Stats {
+		uint32 hits; ///< Lookups of loadable resources which were already loaded
+		uint32 loads; ///< Loadable resources read from the game data files
+		uint32 reloads; ///< Loads of resources which had been expired before
+		uint32 reloadedBytes; ///< Total size of those reloads
+		uint32 expired; ///< Resources expired to stay within the heap threshold
+		uint32 expiredBytes; ///< Total size of the expired resources
+
+		Stats() { reset(); }
+		void reset() {
+			hits = loads = reloads = reloadedBytes = 0;
+			expired = expiredBytes = 0;
+		}
+	};
+
 protected:
 	uint32 _allocatedSize;
 	uint32 _maxHeapThreshold, _minHeapThreshold;
 	byte _expireCounter;
 
+	/**
+	 * The loaded resources which may be expired, i.e. those which can be
+	 * reloaded from the game data files and are neither locked nor off heap.
+	 * The list is ordered from the least to the most recently used resource,
+	 * so expireResources() can take its victims from the head. Resources are
+	 * moved to the tail when they are accessed, and to the head when a script
+	 * asks for them to be nuked.
+	 */
+	Resource *_expiryHead, *_expiryTail;
+
+	Stats _stats;
+
 public:
 	ResourceManager(ScummEngine *vm);
 	~ResourceManager();
 
 	void setHeapThreshold(int min, int max);
+	uint32 getMinHeapThreshold() const { return _minHeapThreshold; }
+	uint32 getMaxHeapThreshold() const { return _maxHeapThreshold; }
+	uint32 getAllocatedSize() const { return _allocatedSize; }
+
+	const Stats &getStats() const { return _stats; }
+	void resetStats() { _stats.reset(); }
+
+	/**
+	 * Count a lookup of a loaded resource, for the statistics.
+	 */
+	void countHit() { _stats.hits++; }
 
 	void allocResTypeData(ResType type, uint32 tag, int num, ResTypeMode mode);
 	void freeResources();
@@ -210,13 +265,14 @@ public:
 	void increaseExpireCounter();
 
 	/**
-	 * Update the specified resource's counter.
+	 * Update the specified resource's counter. A counter of 1 marks the
+	 * resource as just used, the maximal count marks it to be expired first.
 	 */
 	void setResourceCounter(ResType type, ResId idx, byte counter);
 
 	/**
-	 * Increment the counter of all unlocked loaded resources.
-	 * The maximal count is 255.
+	 * Increment the counter of all loaded resources which may be expired.
+	 * The maximal count is 127.
 	 * This is called by increaseExpireCounter and expireResources,
 	 * but also by ScummEngine::startScene.
 	 */
@@ -228,6 +284,11 @@ public:
 	bool validateResource(const char *str, ResType type, ResId idx) const;
 protected:
 	void expireResources(uint32 size);
+
+	bool isExpirable(const Resource &res) const;
+	bool isInExpiryList(const Resource &res) const;
+	void addToExpiryList(Resource &res);
+	void removeFromExpiryList(Resource &res);
 };
 
 } // End of namespace Scumm
@@ -28,6 +28,7 @@
 #include "scumm/he/intern_he.h"
 #endif
 #include "scumm/object.h"
+#include "scumm/prefetch.h"
 #include "scumm/resource.h"
 #include "scumm/scumm_v3.h"
 #include "scumm/sound.h"
@@ -128,8 +129,10 @@ void ScummEngine::startScene(int room, Actor *a, int objectNr) {
 	if (VAR_ROOM_RESOURCE != 0xFF)
 		VAR(VAR_ROOM_RESOURCE) = _roomResource;
 
-	if (room != 0)
+	if (room != 0) {
 		ensureResourceLoaded(rtRoom, room);
+		_prefetcher->roomEntered(_roomResource);
+	}
 
 	clearRoomObjects();
 
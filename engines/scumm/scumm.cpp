@@ -20,6 +20,7 @@
  *
  */
 
+#include "common/benchmark.h"
 #include "common/config-manager.h"
 #include "common/debug-channels.h"
 #include "common/md5.h"
@@ -35,6 +36,7 @@
 #include "graphics/cursorman.h"
 
 #include "scumm/akos.h"
+#include "scumm/boxes.h"
 #include "scumm/charset.h"
 #include "scumm/costume.h"
 #include "scumm/debugger.h"
@@ -64,6 +66,7 @@
 #include "scumm/player_v3m.h"
 #include "scumm/player_v4a.h"
 #include "scumm/player_v5m.h"
+#include "scumm/prefetch.h"
 #include "scumm/resource.h"
 #include "scumm/he/resource_he.h"
 #include "scumm/scumm_v0.h"
@@ -81,16 +84,8 @@
 
 #include "audio/mixer.h"
 
-#ifdef EMSCRIPTEN
-#include "emscripten/emscripten.h"
-#endif
-
 using Common::File;
 
-typedef void (*FuncPtr)();
-extern FuncPtr mainLoopUpdateFunc;
-extern void emscriptenUpdate(void *);
-
 namespace Scumm {
 
 // Use g_scumm from error() ONLY
@@ -147,6 +142,8 @@ ScummEngine::ScummEngine(OSystem *syst, const DetectorResult &dr)
 		_gdi = new Gdi(this);
 	}
 	_res = new ResourceManager(this);
+	_boxCache = new BoxCache();
+	_prefetcher = new RoomPrefetcher(this);
 
 	// Convert MD5 checksum back into a digest
 	for (int i = 0; i < 16; ++i) {
@@ -651,7 +648,9 @@ ScummEngine::~ScummEngine() {
 
 	delete _debugger;
 
+	delete _prefetcher;
 	delete _res;
+	delete _boxCache;	// Used by _res when freeing the box resources
 	delete _gdi;
 }
 
@@ -1320,7 +1319,16 @@ void ScummEngine::setupScumm() {
 		maxHeapThreshold = 550000;
 	}
 
-	_res->setHeapThreshold(400000, maxHeapThreshold);
+	int minHeapThreshold = 400000;
+
+	// The heap size, in KB, can be overridden, e.g. to keep more resources
+	// loaded on systems with memory to spare
+	if (ConfMan.hasKey("resource_heap_size")) {
+		maxHeapThreshold = MAX(ConfMan.getInt("resource_heap_size"), 64) * 1024;
+		minHeapThreshold = maxHeapThreshold / 4 * 3;
+	}
+
+	_res->setHeapThreshold(minHeapThreshold, maxHeapThreshold);
 
 	free(_compositeBuf);
 	_compositeBuf = (byte *)malloc(_screenWidth * _textSurfaceMultiplier * _screenHeight * _textSurfaceMultiplier * _outputPixelFormat.bytesPerPixel);
@@ -1972,25 +1980,20 @@ int ScummEngine::getTalkSpeed() {
 #pragma mark --- Main loop ---
 #pragma mark -
 
-namespace
-{
-	int diff = 0;	// Duration of one loop iteration
-	int delta = 1;
-	ScummEngine *e = 0;
-}
+int32 ScummEngine::runFrame() {
+	if (shouldQuit())
+		return -1;
 
-void ScummEngine::updateIteration()
-{
 	// Start the stop watch!
-	diff = _system->getMillis();
+	const uint32 frameStart = _system->getMillis();
+	int diff = frameStart;
 
 	// Run the main loop
-	scummLoop(delta);
+	scummLoop(_loopDelta);
 
 	// Halt the stop watch and compute how much time this iteration took.
 	diff = _system->getMillis() - diff;
 
-
 	if (shouldQuit()) {
 		// TODO: Maybe perform an autosave on exit?
 	}
@@ -2008,9 +2011,9 @@ void ScummEngine::updateIteration()
 		VAR(VAR_TIMER_TOTAL) += diff * 60 / 1000;
 
 	// Determine how long to wait before the next loop iteration should start
-	delta = (VAR_TIMER_NEXT != 0xFF) ? VAR(VAR_TIMER_NEXT) : 4;
-	if (delta < 1)	// Ensure we don't get into an endless loop
-		delta = 1;  // by not decreasing sleepers.
+	_loopDelta = (VAR_TIMER_NEXT != 0xFF) ? VAR(VAR_TIMER_NEXT) : 4;
+	if (_loopDelta < 1)	// Ensure we don't get into an endless loop
+		_loopDelta = 1;  // by not decreasing sleepers.
 
 	// WORKAROUND: walking speed in the original v0/v1 interpreter
 	// is sometimes slower (e.g. during scrolling) than in ScummVM.
@@ -2018,15 +2021,25 @@ void ScummEngine::updateIteration()
 	// otherwise (delta < 6) a single kid is able to escape.
 	if ((_game.version == 0 && isScriptRunning(132)) ||
 		(_game.version == 1 && isScriptRunning(137)))
-		delta = 6;
+		_loopDelta = 6;
 
-	// Wait...
-	waitForTimer(delta * 1000 / 60 - diff);
-}
-void updateIterationGlobal()
-{
-	if (e)
-		e->updateIteration();
+	// Present the frame. Waiting for the next one is up to the caller,
+	// which owns the scheduling (see Engine::kSupportsFrameLoop).
+	updateScreenAndEvents();
+
+	// Spend half of the time left until the next frame on loading the
+	// resources of the rooms likely to be entered next
+	if (!_fastMode) {
+		const int32 idle = _loopDelta * 1000 / 60 - (int32)(_system->getMillis() - frameStart);
+		if (idle > 1)
+			_prefetcher->run(idle / 2);
+	}
+
+	if (_fastMode & 2)
+		return diff;
+	else if (_fastMode & 1)
+		return diff + 10;
+	return _loopDelta * 1000 / 60;
 }
 
 Common::Error ScummEngine::go() {
@@ -2040,52 +2053,27 @@ Common::Error ScummEngine::go() {
 		_saveLoadFlag = 0;
 	}
 
-	diff = 0;
-	e = this;
-	mainLoopUpdateFunc = updateIterationGlobal;
-
-/*
-	while (!shouldQuit()) {
-		updateIteration();
-	}
-*/
+	// The main loop itself is run by repeated calls to runFrame()
+	_loopDelta = 1;
 
 	return Common::kNoError;
 }
 
-uint32 nextUpdateTime = 0;
-
-void emscriptenWaitForUpdate(void *)
-{
-	if (e)
-		e->waitForNextUpdate();
-}
-
-void ScummEngine::waitForNextUpdate() {
-	_sound->updateCD();
+void ScummEngine::updateScreenAndEvents() {
+	_sound->updateCD(); // Loop CD Audio if needed
 	parseEvents();
 
 #ifndef DISABLE_TOWNS_DUAL_LAYER_MODE
-                if (_townsScreen)
-                        _townsScreen->update();
+	if (_townsScreen)
+		_townsScreen->update();
 #endif
 
-                _system->updateScreen();
-
-	uint32 t = _system->getMillis();
-	if (t >= nextUpdateTime || (t < nextUpdateTime && nextUpdateTime - t > 1000))
-	{
-		emscriptenUpdate(0);
-		return;
-	}
-	else {
-                emscripten_async_call(emscriptenWaitForUpdate, 0, 5);
-	}
+	_system->updateScreen();
 }
 
 void ScummEngine::waitForTimer(int msec_delay) {
 	uint32 start_time;
-//	warning("msec delay: %d", msec_delay);
+
 	if (_fastMode & 2)
 		msec_delay = 0;
 	else if (_fastMode & 1)
@@ -2093,32 +2081,18 @@ void ScummEngine::waitForTimer(int msec_delay) {
 
 	start_time = _system->getMillis();
 
-#ifndef EMSCRIPTEN
-	while (!shouldQuit())
-#endif
-{
-		_sound->updateCD(); // Loop CD Audio if needed
-		parseEvents();
-
-#ifndef DISABLE_TOWNS_DUAL_LAYER_MODE
-		if (_townsScreen)
-			_townsScreen->update();
-#endif
+	while (!shouldQuit()) {
+		updateScreenAndEvents();
 
-		_system->updateScreen();
 #ifdef EMSCRIPTEN
-//		msec_delay = 100;
-		if (msec_delay < 1)
-			msec_delay = 1;
-		if (msec_delay > 110)
-			msec_delay = 110;
-		nextUpdateTime = start_time + msec_delay;
-		emscripten_async_call(emscriptenWaitForUpdate, 0, 1);
-		return;
+		// Blocking is not possible inside a browser callback, so nested
+		// waits (e.g. during screen transition effects) are skipped.
+		break;
 #else
-		if (_system->getMillis() >= start_time + msec_delay)
+		uint32 now = _system->getMillis();
+		if (now >= start_time + msec_delay)
 			break;
-		_system->delayMillis(10);
+		_system->delayMillis(MIN<uint32>(start_time + msec_delay - now, 10));
 #endif
 	}
 }
@@ -2439,6 +2413,8 @@ void ScummEngine_v8::scummLoop_handleSaveLoad() {
 #endif
 
 void ScummEngine::scummLoop_handleDrawing() {
+	Common::BenchmarkScope benchmark(Common::Benchmark::kCategoryRendering);
+
 	if (camera._cur != camera._last || _bgNeedsRedraw || _fullRedraw) {
 		redrawBGAreas();
 	}
@@ -93,6 +93,7 @@ class Sound;
 
 struct Box;
 struct BoxCoords;
+class BoxCache;
 struct FindObjectInRoom;
 
 // Use g_scumm from error() ONLY
@@ -361,6 +362,7 @@ enum ResType {
 typedef uint16 ResId;
 
 class ResourceManager;
+class RoomPrefetcher;
 
 /**
  * Base class for all SCUMM engines.
@@ -398,11 +400,17 @@ public:
 	/** Central resource data. */
 	ResourceManager *_res;
 
+	/** Loads the resources of the rooms likely to be entered next. */
+	RoomPrefetcher *_prefetcher;
+
 protected:
 	VirtualMachineState vm;
 
 	bool _oldSoundsPaused;
 
+	/** Number of ticks (1/60 s) the next main loop iteration should advance. */
+	int _loopDelta;
+
 public:
 	// Constructor / Destructor
 	ScummEngine(OSystem *syst, const DetectorResult &dr);
@@ -411,7 +419,7 @@ public:
 	// Engine APIs
 	Common::Error init();
 	Common::Error go();
-	void updateIteration();
+	virtual int32 runFrame();
 	virtual Common::Error run() {
 		Common::Error err;
 		err = init();
@@ -461,10 +469,10 @@ protected:
 	// Event handling
 public:
 	void parseEvents();	// Used by IMuseDigital::startSound
-	void waitForNextUpdate();
 protected:
 	virtual void parseEvent(Common::Event event);
 
+	void updateScreenAndEvents();
 	void waitForTimer(int msec_delay);
 	virtual void processInput();
 	virtual void processKeyboard(Common::KeyState lastKeyHit);
@@ -754,6 +762,12 @@ public:
 	byte *getStringAddressVar(int i);
 	void ensureResourceLoaded(ResType type, ResId idx);
 
+	/**
+	 * Read the size of a resource from the data files, without loading it.
+	 * @return the size, or 0 if it cannot be told from the resource header
+	 */
+	uint32 peekResourceSize(ResType type, ResId idx);
+
 protected:
 	int readSoundResource(ResId idx);
 	int readSoundResourceSmallHeader(ResId idx);
@@ -1137,6 +1151,10 @@ public:
 
 	BoxCoords getBoxCoordinates(int boxnum);
 
+	/** Get the cached data of the walk boxes, updating it if necessary. */
+	const BoxCache &getBoxCache();
+	void invalidateBoxCache();
+
 	byte getMaskFromBox(int box);
 	Box *getBoxBaseAddr(int box);
 	byte getBoxFlags(int box);
@@ -1156,6 +1174,10 @@ protected:
 	void setBoxScaleSlot(int box, int slot);
 	void convertScaleTableToScaleSlot(int slot);
 
+	BoxCache *_boxCache;
+	BoxCoords decodeBoxCoordinates(int boxnum);
+
+	const byte *getItineraryMatrix(int num);
 	void calcItineraryMatrix(byte *itineraryMatrix, int num);
 	void createBoxMatrix();
 	virtual bool areBoxesNeighbors(int i, int j);
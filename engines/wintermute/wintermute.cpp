@@ -22,6 +22,7 @@
 
 #include "common/scummsys.h"
 
+#include "common/benchmark.h"
 #include "common/config-manager.h"
 #include "common/debug.h"
 #include "common/debug-channels.h"
@@ -231,10 +232,13 @@ int WintermuteEngine::messageLoop() {
 		}
 
 		if (_game && _game->_renderer->_active && _game->_renderer->isReady()) {
-			_game->displayContent();
-			_game->displayQuickMsg();
+			{
+				Common::BenchmarkScope benchmark(Common::Benchmark::kCategoryRendering);
+				_game->displayContent();
+				_game->displayQuickMsg();
 
-			_game->displayDebugInfo();
+				_game->displayDebugInfo();
+			}
 
 			time = _system->getMillis();
 			diff = time - prevTime;
@@ -28,9 +28,6 @@
 
 int gBitFormat = 565;
 
-extern "C" {
-	uint32 *RGBtoYUV = 0;
-}
 #ifdef USE_HQ_SCALERS
 // RGB-to-YUV lookup table
 extern "C" {
@@ -176,8 +173,8 @@ void Normal1x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPit
 			unsigned short r = (c >> 11) << 3;
 			unsigned short g = ((c >> 5) & 63) << 2;
 			unsigned short b = (c & 31) << 3;
-			unsigned long newcol = 0xFF000000 | (b << 16) | (g << 8) | r;
-			*(unsigned long *)(dstPtr + y*dstPitch+x*4) = newcol;//src[y*offscreen_16bit->pitch/2+x];
+			uint32 newcol = 0xFF000000 | (b << 16) | (g << 8) | r;
+			*(uint32 *)(dstPtr + y*dstPitch+x*4) = newcol;//src[y*offscreen_16bit->pitch/2+x];
 		}
 }
 #if 0
@@ -0,0 +1,141 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_SCALER_HQX_H
+#define GRAPHICS_SCALER_HQX_H
+
+#include "graphics/scaler/intern.h"
+
+// SSE2 is always available on x86-64, and NEON on AArch64, so the vector
+// code is chosen at compile time.
+#if defined(__SSE2__)
+#define HQX_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define HQX_NEON
+#include <arm_neon.h>
+#endif
+
+/**
+ * Compute the pattern of the hq scaler family for the pixel w5, using the
+ * RGBtoYUV lookup table. Bit n of the result is set if w5 differs visibly
+ * from the n-th of its neighbours w1, w2, w3, w4, w6, w7, w8 and w9.
+ */
+static inline int hqxPatternScalar(const uint32 *yuvTable, int w1, int w2, int w3, int w4, int w5, int w6, int w7, int w8, int w9) {
+	int pattern = 0;
+	const int yuv5 = yuvTable[w5];
+	if (w5 != w1 && diffYUV(yuv5, yuvTable[w1])) pattern |= 0x0001;
+	if (w5 != w2 && diffYUV(yuv5, yuvTable[w2])) pattern |= 0x0002;
+	if (w5 != w3 && diffYUV(yuv5, yuvTable[w3])) pattern |= 0x0004;
+	if (w5 != w4 && diffYUV(yuv5, yuvTable[w4])) pattern |= 0x0008;
+	if (w5 != w6 && diffYUV(yuv5, yuvTable[w6])) pattern |= 0x0010;
+	if (w5 != w7 && diffYUV(yuv5, yuvTable[w7])) pattern |= 0x0020;
+	if (w5 != w8 && diffYUV(yuv5, yuvTable[w8])) pattern |= 0x0040;
+	if (w5 != w9 && diffYUV(yuv5, yuvTable[w9])) pattern |= 0x0080;
+	return pattern;
+}
+
+// The vector versions compute the YUV values of all eight neighbours in
+// 16 bit lanes, the same way InitLUT() fills RGBtoYUV for the pixel format
+// described by ColorMask, instead of looking them up one by one. The
+// offsets of U and V cancel out in the differences and are left out.
+// diffYUV() then amounts to comparing the absolute differences against 48
+// for Y, 7 for U and 6 for V.
+
+#ifdef HQX_SSE2
+
+template<typename ColorMask>
+static inline void hqxToYUV(__m128i c, __m128i &y, __m128i &u, __m128i &v) {
+	const __m128i byteMask = _mm_set1_epi16(0xFF);
+	const __m128i r = _mm_and_si128(_mm_slli_epi16(_mm_srli_epi16(c, ColorMask::kRedShift), 8 - ColorMask::kRedBits), byteMask);
+	const __m128i g = _mm_and_si128(_mm_slli_epi16(_mm_srli_epi16(c, ColorMask::kGreenShift), 8 - ColorMask::kGreenBits), byteMask);
+	const __m128i b = _mm_and_si128(_mm_slli_epi16(_mm_srli_epi16(c, ColorMask::kBlueShift), 8 - ColorMask::kBlueBits), byteMask);
+
+	y = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(r, g), b), 2);
+	u = _mm_srai_epi16(_mm_sub_epi16(r, b), 2);
+	v = _mm_srai_epi16(_mm_sub_epi16(_mm_add_epi16(g, g), _mm_add_epi16(r, b)), 3);
+}
+
+static inline __m128i hqxDiffers(__m128i a, __m128i b, int threshold) {
+	const __m128i diff = _mm_sub_epi16(a, b);
+	const __m128i absDiff = _mm_max_epi16(diff, _mm_sub_epi16(_mm_setzero_si128(), diff));
+	return _mm_cmpgt_epi16(absDiff, _mm_set1_epi16(threshold));
+}
+
+template<typename ColorMask>
+static inline int hqxPattern(const uint32 *yuvTable, int w1, int w2, int w3, int w4, int w5, int w6, int w7, int w8, int w9) {
+	__m128i y, u, v, y5, u5, v5;
+	hqxToYUV<ColorMask>(_mm_set_epi16(w9, w8, w7, w6, w4, w3, w2, w1), y, u, v);
+	hqxToYUV<ColorMask>(_mm_set1_epi16(w5), y5, u5, v5);
+
+	const __m128i differs = _mm_or_si128(_mm_or_si128(hqxDiffers(y, y5, 48), hqxDiffers(u, u5, 7)), hqxDiffers(v, v5, 6));
+	return _mm_movemask_epi8(_mm_packs_epi16(differs, _mm_setzero_si128()));
+}
+
+#elif defined(HQX_NEON)
+
+template<typename ColorMask>
+static inline void hqxToYUV(uint16x8_t c, int16x8_t &y, int16x8_t &u, int16x8_t &v) {
+	const uint16x8_t byteMask = vdupq_n_u16(0xFF);
+	// vshlq shifts to the right for negative amounts, including zero
+	const int16x8_t r = vreinterpretq_s16_u16(vandq_u16(vshlq_u16(vshlq_u16(c, vdupq_n_s16(-ColorMask::kRedShift)), vdupq_n_s16(8 - ColorMask::kRedBits)), byteMask));
+	const int16x8_t g = vreinterpretq_s16_u16(vandq_u16(vshlq_u16(vshlq_u16(c, vdupq_n_s16(-ColorMask::kGreenShift)), vdupq_n_s16(8 - ColorMask::kGreenBits)), byteMask));
+	const int16x8_t b = vreinterpretq_s16_u16(vandq_u16(vshlq_u16(vshlq_u16(c, vdupq_n_s16(-ColorMask::kBlueShift)), vdupq_n_s16(8 - ColorMask::kBlueBits)), byteMask));
+
+	y = vshrq_n_s16(vaddq_s16(vaddq_s16(r, g), b), 2);
+	u = vshrq_n_s16(vsubq_s16(r, b), 2);
+	v = vshrq_n_s16(vsubq_s16(vaddq_s16(g, g), vaddq_s16(r, b)), 3);
+}
+
+template<typename ColorMask>
+static inline int hqxPattern(const uint32 *yuvTable, int w1, int w2, int w3, int w4, int w5, int w6, int w7, int w8, int w9) {
+	const uint16 neighbours[8] = { (uint16)w1, (uint16)w2, (uint16)w3, (uint16)w4, (uint16)w6, (uint16)w7, (uint16)w8, (uint16)w9 };
+	static const uint16 bits[8] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80 };
+
+	int16x8_t y, u, v, y5, u5, v5;
+	hqxToYUV<ColorMask>(vld1q_u16(neighbours), y, u, v);
+	hqxToYUV<ColorMask>(vdupq_n_u16(w5), y5, u5, v5);
+
+	const uint16x8_t differs = vorrq_u16(vorrq_u16(
+		vcgtq_s16(vabdq_s16(y, y5), vdupq_n_s16(48)),
+		vcgtq_s16(vabdq_s16(u, u5), vdupq_n_s16(7))),
+		vcgtq_s16(vabdq_s16(v, v5), vdupq_n_s16(6)));
+	const uint16x8_t pattern = vandq_u16(differs, vld1q_u16(bits));
+
+#ifdef __aarch64__
+	return vaddvq_u16(pattern);
+#else
+	const uint64x2_t sum = vpaddlq_u32(vpaddlq_u16(pattern));
+	return (int)(vgetq_lane_u64(sum, 0) + vgetq_lane_u64(sum, 1));
+#endif
+}
+
+#else
+
+template<typename ColorMask>
+static inline int hqxPattern(const uint32 *yuvTable, int w1, int w2, int w3, int w4, int w5, int w6, int w7, int w8, int w9) {
+	return hqxPatternScalar(yuvTable, w1, w2, w3, w4, w5, w6, w7, w8, w9);
+}
+
+#endif
+
+#endif
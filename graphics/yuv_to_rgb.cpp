@@ -86,6 +86,20 @@
 #include "graphics/surface.h"
 #include "graphics/yuv_to_rgb.h"
 
+// SSE2 is always available on x86-64, and NEON on AArch64, so the vector
+// code is chosen at compile time.
+#if defined(__SSE2__)
+#define YUV_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define YUV_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(YUV_SSE2) || defined(YUV_NEON)
+#define YUV_SIMD
+#endif
+
 namespace Common {
 DECLARE_SINGLETON(Graphics::YUVToRGBManager);
 }
@@ -192,6 +206,269 @@ const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format, Y
 	return _lookup;
 }
 
+#ifdef YUV_SIMD
+
+// The vector code computes what the lookup tables hold, 8 pixels at a time,
+// in 16 bit lanes. The chroma offsets are the products of the chroma with the
+// coefficients of the color tables, truncated like the tables are: the
+// magnitudes are multiplied by the doubled constants below, the high 16 bits
+// of the products kept, and the signs restored. The ITU luminance scale,
+// (i - 16) * 255 / 219, is computed the same way. The constants give the
+// same results as the tables for every input.
+enum {
+	kCrRMul = 45900, // 0.419 / 0.299
+	kCrGMul = 23386, // 0.299 / 0.419
+	kCbGMul = 11283, // 0.114 / 0.331
+	kCbBMul = 58110, // 0.587 / 0.331
+	kITUMul = 38156  // 255 / 219
+};
+
+#ifdef YUV_SSE2
+
+typedef __m128i YUVVec;
+
+/** The shifts packing the channels into pixels of a format. */
+struct YUVVecFormat {
+	__m128i rLoss, gLoss, bLoss;
+	__m128i rShift, gShift, bShift;
+	__m128i alpha16, alpha32;
+
+	YUVVecFormat(const Graphics::PixelFormat &format) {
+		rLoss = _mm_cvtsi32_si128(format.rLoss);
+		gLoss = _mm_cvtsi32_si128(format.gLoss);
+		bLoss = _mm_cvtsi32_si128(format.bLoss);
+		rShift = _mm_cvtsi32_si128(format.rShift);
+		gShift = _mm_cvtsi32_si128(format.gShift);
+		bShift = _mm_cvtsi32_si128(format.bShift);
+
+		const uint32 alpha = (0xFF >> format.aLoss) << format.aShift;
+		alpha16 = _mm_set1_epi16((int16)alpha);
+		alpha32 = _mm_set1_epi32(alpha);
+	}
+};
+
+static inline YUVVec yuvLoad(const byte *src) {
+	return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)src), _mm_setzero_si128());
+}
+
+static inline YUVVec yuvSet(int16 x) { return _mm_set1_epi16(x); }
+static inline YUVVec yuvAdd(YUVVec a, YUVVec b) { return _mm_add_epi16(a, b); }
+static inline YUVVec yuvSub(YUVVec a, YUVVec b) { return _mm_sub_epi16(a, b); }
+static inline YUVVec yuvClamp(YUVVec a, int16 lo, int16 hi) { return _mm_min_epi16(_mm_max_epi16(a, _mm_set1_epi16(lo)), _mm_set1_epi16(hi)); }
+
+/** (a * m) >> 15 for a in [0, 255]. */
+static inline YUVVec yuvMulHigh(YUVVec a, uint16 m) {
+	return _mm_mulhi_epu16(_mm_slli_epi16(a, 1), _mm_set1_epi16((int16)m));
+}
+
+/** (int16)(c * a), for the coefficient c of m, and a in [-128, 127]. */
+static inline YUVVec yuvMulChroma(YUVVec a, uint16 m) {
+	const __m128i sign = _mm_srai_epi16(a, 15);
+	const __m128i abs = _mm_sub_epi16(_mm_xor_si128(a, sign), sign);
+	return _mm_sub_epi16(_mm_xor_si128(yuvMulHigh(abs, m), sign), sign);
+}
+
+/** Repeat each of the low or the high 4 lanes once, for 420. */
+static inline YUVVec yuvDupLow(YUVVec a) { return _mm_unpacklo_epi16(a, a); }
+static inline YUVVec yuvDupHigh(YUVVec a) { return _mm_unpackhi_epi16(a, a); }
+
+static inline void yuvStore16(byte *dst, YUVVec r, YUVVec g, YUVVec b, const YUVVecFormat &format) {
+	__m128i pixels = format.alpha16;
+	pixels = _mm_or_si128(pixels, _mm_sll_epi16(_mm_srl_epi16(r, format.rLoss), format.rShift));
+	pixels = _mm_or_si128(pixels, _mm_sll_epi16(_mm_srl_epi16(g, format.gLoss), format.gShift));
+	pixels = _mm_or_si128(pixels, _mm_sll_epi16(_mm_srl_epi16(b, format.bLoss), format.bShift));
+	_mm_storeu_si128((__m128i *)dst, pixels);
+}
+
+static inline void yuvStore32(byte *dst, YUVVec r, YUVVec g, YUVVec b, const YUVVecFormat &format) {
+	const __m128i zero = _mm_setzero_si128();
+	r = _mm_srl_epi16(r, format.rLoss);
+	g = _mm_srl_epi16(g, format.gLoss);
+	b = _mm_srl_epi16(b, format.bLoss);
+
+	__m128i lo = format.alpha32;
+	lo = _mm_or_si128(lo, _mm_sll_epi32(_mm_unpacklo_epi16(r, zero), format.rShift));
+	lo = _mm_or_si128(lo, _mm_sll_epi32(_mm_unpacklo_epi16(g, zero), format.gShift));
+	lo = _mm_or_si128(lo, _mm_sll_epi32(_mm_unpacklo_epi16(b, zero), format.bShift));
+
+	__m128i hi = format.alpha32;
+	hi = _mm_or_si128(hi, _mm_sll_epi32(_mm_unpackhi_epi16(r, zero), format.rShift));
+	hi = _mm_or_si128(hi, _mm_sll_epi32(_mm_unpackhi_epi16(g, zero), format.gShift));
+	hi = _mm_or_si128(hi, _mm_sll_epi32(_mm_unpackhi_epi16(b, zero), format.bShift));
+
+	_mm_storeu_si128((__m128i *)dst, lo);
+	_mm_storeu_si128((__m128i *)(dst + 16), hi);
+}
+
+#endif // YUV_SSE2
+
+#ifdef YUV_NEON
+
+typedef int16x8_t YUVVec;
+
+/** The shifts packing the channels into pixels of a format. */
+struct YUVVecFormat {
+	int16x8_t rLoss, gLoss, bLoss;
+	int16x8_t rShift16, gShift16, bShift16;
+	int32x4_t rShift32, gShift32, bShift32;
+	uint16x8_t alpha16;
+	uint32x4_t alpha32;
+
+	YUVVecFormat(const Graphics::PixelFormat &format) {
+		// NEON shifts right by negative counts
+		rLoss = vdupq_n_s16(-format.rLoss);
+		gLoss = vdupq_n_s16(-format.gLoss);
+		bLoss = vdupq_n_s16(-format.bLoss);
+		rShift16 = vdupq_n_s16(format.rShift);
+		gShift16 = vdupq_n_s16(format.gShift);
+		bShift16 = vdupq_n_s16(format.bShift);
+		rShift32 = vdupq_n_s32(format.rShift);
+		gShift32 = vdupq_n_s32(format.gShift);
+		bShift32 = vdupq_n_s32(format.bShift);
+
+		const uint32 alpha = (0xFF >> format.aLoss) << format.aShift;
+		alpha16 = vdupq_n_u16((uint16)alpha);
+		alpha32 = vdupq_n_u32(alpha);
+	}
+};
+
+static inline YUVVec yuvLoad(const byte *src) {
+	return vreinterpretq_s16_u16(vmovl_u8(vld1_u8(src)));
+}
+
+static inline YUVVec yuvSet(int16 x) { return vdupq_n_s16(x); }
+static inline YUVVec yuvAdd(YUVVec a, YUVVec b) { return vaddq_s16(a, b); }
+static inline YUVVec yuvSub(YUVVec a, YUVVec b) { return vsubq_s16(a, b); }
+static inline YUVVec yuvClamp(YUVVec a, int16 lo, int16 hi) { return vminq_s16(vmaxq_s16(a, vdupq_n_s16(lo)), vdupq_n_s16(hi)); }
+
+/** (a * m) >> 15 for a in [0, 255]. */
+static inline YUVVec yuvMulHigh(YUVVec a, uint16 m) {
+	const uint16x8_t a2 = vreinterpretq_u16_s16(vshlq_n_s16(a, 1));
+	const uint16x4_t lo = vshrn_n_u32(vmull_n_u16(vget_low_u16(a2), m), 16);
+	const uint16x4_t hi = vshrn_n_u32(vmull_n_u16(vget_high_u16(a2), m), 16);
+	return vreinterpretq_s16_u16(vcombine_u16(lo, hi));
+}
+
+/** (int16)(c * a), for the coefficient c of m, and a in [-128, 127]. */
+static inline YUVVec yuvMulChroma(YUVVec a, uint16 m) {
+	const YUVVec product = yuvMulHigh(vabsq_s16(a), m);
+	return vbslq_s16(vcltq_s16(a, vdupq_n_s16(0)), vnegq_s16(product), product);
+}
+
+/** Repeat each of the low or the high 4 lanes once, for 420. */
+static inline YUVVec yuvDupLow(YUVVec a) { return vzipq_s16(a, a).val[0]; }
+static inline YUVVec yuvDupHigh(YUVVec a) { return vzipq_s16(a, a).val[1]; }
+
+static inline void yuvStore16(byte *dst, YUVVec r, YUVVec g, YUVVec b, const YUVVecFormat &format) {
+	uint16x8_t pixels = format.alpha16;
+	pixels = vorrq_u16(pixels, vshlq_u16(vshlq_u16(vreinterpretq_u16_s16(r), format.rLoss), format.rShift16));
+	pixels = vorrq_u16(pixels, vshlq_u16(vshlq_u16(vreinterpretq_u16_s16(g), format.gLoss), format.gShift16));
+	pixels = vorrq_u16(pixels, vshlq_u16(vshlq_u16(vreinterpretq_u16_s16(b), format.bLoss), format.bShift16));
+	vst1q_u16((uint16 *)dst, pixels);
+}
+
+static inline void yuvStore32(byte *dst, YUVVec r, YUVVec g, YUVVec b, const YUVVecFormat &format) {
+	const uint16x8_t r16 = vshlq_u16(vreinterpretq_u16_s16(r), format.rLoss);
+	const uint16x8_t g16 = vshlq_u16(vreinterpretq_u16_s16(g), format.gLoss);
+	const uint16x8_t b16 = vshlq_u16(vreinterpretq_u16_s16(b), format.bLoss);
+
+	uint32x4_t lo = format.alpha32;
+	lo = vorrq_u32(lo, vshlq_u32(vmovl_u16(vget_low_u16(r16)), format.rShift32));
+	lo = vorrq_u32(lo, vshlq_u32(vmovl_u16(vget_low_u16(g16)), format.gShift32));
+	lo = vorrq_u32(lo, vshlq_u32(vmovl_u16(vget_low_u16(b16)), format.bShift32));
+
+	uint32x4_t hi = format.alpha32;
+	hi = vorrq_u32(hi, vshlq_u32(vmovl_u16(vget_high_u16(r16)), format.rShift32));
+	hi = vorrq_u32(hi, vshlq_u32(vmovl_u16(vget_high_u16(g16)), format.gShift32));
+	hi = vorrq_u32(hi, vshlq_u32(vmovl_u16(vget_high_u16(b16)), format.bShift32));
+
+	vst1q_u32((uint32 *)dst, lo);
+	vst1q_u32((uint32 *)(dst + 16), hi);
+}
+
+#endif // YUV_NEON
+
+/** The chroma offsets of each channel, as in Cr_r_tab, Cr_g_tab + Cb_g_tab and Cb_b_tab. */
+static inline void yuvChroma(const byte *uSrc, const byte *vSrc, YUVVec &r, YUVVec &g, YUVVec &b) {
+	const YUVVec cb = yuvSub(yuvLoad(uSrc), yuvSet(128));
+	const YUVVec cr = yuvSub(yuvLoad(vSrc), yuvSet(128));
+
+	r = yuvMulChroma(cr, kCrRMul);
+	g = yuvSub(yuvSub(yuvSet(0), yuvMulChroma(cr, kCrGMul)), yuvMulChroma(cb, kCbGMul));
+	b = yuvMulChroma(cb, kCbBMul);
+}
+
+/** The value of a channel, as in rgbToPix. */
+template<YUVToRGBManager::LuminanceScale scale>
+static inline YUVVec yuvChannel(YUVVec value) {
+	if (scale == YUVToRGBManager::kScaleFull)
+		return yuvClamp(value, 0, 255);
+
+	return yuvMulHigh(yuvSub(yuvClamp(value, 16, 235), yuvSet(16)), kITUMul);
+}
+
+/** Convert 8 pixels of luminance ySrc, with the chroma offsets r, g and b. */
+template<typename PixelInt, YUVToRGBManager::LuminanceScale scale>
+static inline void yuvPutPixels(byte *dst, const byte *ySrc, YUVVec r, YUVVec g, YUVVec b, const YUVVecFormat &format) {
+	const YUVVec y = yuvLoad(ySrc);
+
+	r = yuvChannel<scale>(yuvAdd(y, r));
+	g = yuvChannel<scale>(yuvAdd(y, g));
+	b = yuvChannel<scale>(yuvAdd(y, b));
+
+	if (sizeof(PixelInt) == 2)
+		yuvStore16(dst, r, g, b, format);
+	else
+		yuvStore32(dst, r, g, b, format);
+}
+
+/** Convert a YUV444 image whose width is a multiple of 8. */
+template<typename PixelInt, YUVToRGBManager::LuminanceScale scale>
+static void convertYUV444ToRGBVector(byte *dstPtr, int dstPitch, const YUVVecFormat &format, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	for (int h = 0; h < yHeight; h++) {
+		for (int w = 0; w < yWidth; w += 8) {
+			YUVVec r, g, b;
+			yuvChroma(uSrc + w, vSrc + w, r, g, b);
+
+			yuvPutPixels<PixelInt, scale>(dstPtr + w * sizeof(PixelInt), ySrc + w, r, g, b, format);
+		}
+
+		dstPtr += dstPitch;
+		ySrc += yPitch;
+		uSrc += uvPitch;
+		vSrc += uvPitch;
+	}
+}
+
+/** Convert a YUV420 image whose width is a multiple of 16. */
+template<typename PixelInt, YUVToRGBManager::LuminanceScale scale>
+static void convertYUV420ToRGBVector(byte *dstPtr, int dstPitch, const YUVVecFormat &format, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	for (int h = 0; h < yHeight; h += 2) {
+		for (int w = 0; w < yWidth; w += 16) {
+			YUVVec r, g, b;
+			yuvChroma(uSrc + (w >> 1), vSrc + (w >> 1), r, g, b);
+
+			// Each chroma sample covers two pixels of both rows
+			byte *dst = dstPtr + w * sizeof(PixelInt);
+			const byte *y = ySrc + w;
+			yuvPutPixels<PixelInt, scale>(dst, y, yuvDupLow(r), yuvDupLow(g), yuvDupLow(b), format);
+			yuvPutPixels<PixelInt, scale>(dst + dstPitch, y + yPitch, yuvDupLow(r), yuvDupLow(g), yuvDupLow(b), format);
+
+			dst += 8 * sizeof(PixelInt);
+			y += 8;
+			yuvPutPixels<PixelInt, scale>(dst, y, yuvDupHigh(r), yuvDupHigh(g), yuvDupHigh(b), format);
+			yuvPutPixels<PixelInt, scale>(dst + dstPitch, y + yPitch, yuvDupHigh(r), yuvDupHigh(g), yuvDupHigh(b), format);
+		}
+
+		dstPtr += dstPitch << 1;
+		ySrc += yPitch << 1;
+		uSrc += uvPitch;
+		vSrc += uvPitch;
+	}
+}
+
+#endif // YUV_SIMD
+
 #define PUT_PIXEL(s, d) \
 	L = &rgbToPix[(s)]; \
 	*((PixelInt *)(d)) = (L[cr_r] | L[crb_g] | L[cb_b])
@@ -233,13 +510,45 @@ void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert(dst->format.bytesPerPixel == 2 || dst->format.bytesPerPixel == 4);
 	assert(ySrc && uSrc && vSrc);
 
+	byte *dstPtr = (byte *)dst->pixels;
+
+#ifdef YUV_SIMD
+	// Convert all but the last yWidth % 8 columns with the vector code
+	const int vectorWidth = yWidth & ~7;
+
+	if (vectorWidth) {
+		const YUVVecFormat format(dst->format);
+
+		if (dst->format.bytesPerPixel == 2) {
+			if (scale == kScaleFull)
+				convertYUV444ToRGBVector<uint16, kScaleFull>(dstPtr, dst->pitch, format, ySrc, uSrc, vSrc, vectorWidth, yHeight, yPitch, uvPitch);
+			else
+				convertYUV444ToRGBVector<uint16, kScaleITU>(dstPtr, dst->pitch, format, ySrc, uSrc, vSrc, vectorWidth, yHeight, yPitch, uvPitch);
+		} else {
+			if (scale == kScaleFull)
+				convertYUV444ToRGBVector<uint32, kScaleFull>(dstPtr, dst->pitch, format, ySrc, uSrc, vSrc, vectorWidth, yHeight, yPitch, uvPitch);
+			else
+				convertYUV444ToRGBVector<uint32, kScaleITU>(dstPtr, dst->pitch, format, ySrc, uSrc, vSrc, vectorWidth, yHeight, yPitch, uvPitch);
+		}
+
+		dstPtr += vectorWidth * dst->format.bytesPerPixel;
+		ySrc += vectorWidth;
+		uSrc += vectorWidth;
+		vSrc += vectorWidth;
+		yWidth -= vectorWidth;
+
+		if (!yWidth)
+			return;
+	}
+#endif
+
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
-		convertYUV444ToRGB<uint16>((byte *)dst->pixels, dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV444ToRGB<uint16>(dstPtr, dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 	else
-		convertYUV444ToRGB<uint32>((byte *)dst->pixels, dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV444ToRGB<uint32>(dstPtr, dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 }
 
 template<typename PixelInt>
@@ -274,7 +583,7 @@ void convertYUV420ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 			dstPtr += sizeof(PixelInt);
 		}
 
-		dstPtr += dstPitch;
+		dstPtr += (dstPitch << 1) - yWidth * sizeof(PixelInt);
 		ySrc += (yPitch << 1) - yWidth;
 		uSrc += uvPitch - halfWidth;
 		vSrc += uvPitch - halfWidth;
@@ -289,13 +598,45 @@ void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert((yWidth & 1) == 0);
 	assert((yHeight & 1) == 0);
 
+	byte *dstPtr = (byte *)dst->pixels;
+
+#ifdef YUV_SIMD
+	// Convert all but the last yWidth % 16 columns with the vector code
+	const int vectorWidth = yWidth & ~15;
+
+	if (vectorWidth) {
+		const YUVVecFormat format(dst->format);
+
+		if (dst->format.bytesPerPixel == 2) {
+			if (scale == kScaleFull)
+				convertYUV420ToRGBVector<uint16, kScaleFull>(dstPtr, dst->pitch, format, ySrc, uSrc, vSrc, vectorWidth, yHeight, yPitch, uvPitch);
+			else
+				convertYUV420ToRGBVector<uint16, kScaleITU>(dstPtr, dst->pitch, format, ySrc, uSrc, vSrc, vectorWidth, yHeight, yPitch, uvPitch);
+		} else {
+			if (scale == kScaleFull)
+				convertYUV420ToRGBVector<uint32, kScaleFull>(dstPtr, dst->pitch, format, ySrc, uSrc, vSrc, vectorWidth, yHeight, yPitch, uvPitch);
+			else
+				convertYUV420ToRGBVector<uint32, kScaleITU>(dstPtr, dst->pitch, format, ySrc, uSrc, vSrc, vectorWidth, yHeight, yPitch, uvPitch);
+		}
+
+		dstPtr += vectorWidth * dst->format.bytesPerPixel;
+		ySrc += vectorWidth;
+		uSrc += vectorWidth >> 1;
+		vSrc += vectorWidth >> 1;
+		yWidth -= vectorWidth;
+
+		if (!yWidth)
+			return;
+	}
+#endif
+
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
-		convertYUV420ToRGB<uint16>((byte *)dst->pixels, dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV420ToRGB<uint16>(dstPtr, dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 	else
-		convertYUV420ToRGB<uint32>((byte *)dst->pixels, dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV420ToRGB<uint32>(dstPtr, dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 }
 
 #define READ_QUAD(ptr, prefix) \
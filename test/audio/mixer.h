@@ -0,0 +1,325 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/mixer_intern.h"
+#include "audio/audiostream.h"
+#include "common/array.h"
+#include "common/atomic.h"
+#include "common/system.h"
+
+#include "test/system.h"
+
+#ifdef POSIX
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+/**
+ * A mono stream of constant samples, which reports reads after it was
+ * stopped and counts its destruction.
+ */
+class MixerTestStream : public Audio::AudioStream {
+public:
+	MixerTestStream(int length, volatile int32 *deleted = 0) : _left(length), _deleted(deleted), _stopped(0) {}
+	~MixerTestStream() {
+		if (_deleted)
+			Common::atomicAdd(_deleted, 1);
+	}
+
+	int readBuffer(int16 *buffer, const int numSamples) {
+#ifdef POSIX
+		// Give the other threads a chance to run while we are mixed
+		sched_yield();
+#endif
+		if (Common::atomicLoad(&_stopped))
+			Common::atomicAdd(&_readsAfterStop, 1);
+
+		const int samples = MIN(numSamples, _left);
+		for (int i = 0; i < samples; i++)
+			buffer[i] = 1000;
+		_left -= samples;
+		return samples;
+	}
+
+	bool isStereo() const { return false; }
+	int getRate() const { return 22050; }
+	bool endOfData() const { return _left == 0; }
+
+	/** Mark the stream as stopped; the mixer must not read it anymore. */
+	void markStopped() { Common::atomicStore(&_stopped, 1); }
+
+	static volatile int32 _readsAfterStop;
+
+private:
+	int _left;
+	volatile int32 *_deleted;
+	volatile int32 _stopped;
+};
+
+volatile int32 MixerTestStream::_readsAfterStop = 0;
+
+/**
+ * A stream which calls the mixer while it is mixed, as streams driving
+ * other sounds do: it floods the command queue, then stops a sound.
+ */
+class MixerCallingStream : public MixerTestStream {
+public:
+	MixerCallingStream(Audio::Mixer *mixer, Audio::SoundHandle other) : MixerTestStream(1000), _mixer(mixer), _other(other) {}
+
+	int readBuffer(int16 *buffer, const int numSamples) {
+		for (int i = 0; i < 1000; i++)
+			_mixer->setChannelVolume(_other, i & 0xFF);
+		_mixer->stopHandle(_other);
+		_mixer->stopID(7);
+		return MixerTestStream::readBuffer(buffer, numSamples);
+	}
+
+private:
+	Audio::Mixer *_mixer;
+	Audio::SoundHandle _other;
+};
+
+/**
+ * A stream which stops its own sound while it is mixed, then fills the
+ * command queue with commands for another sound, and notes whether it was
+ * deleted meanwhile.
+ */
+class MixerSelfStoppingStream : public MixerTestStream {
+public:
+	MixerSelfStoppingStream(Audio::Mixer *mixer, volatile int32 *deleted) : MixerTestStream(1000, deleted), _mixer(mixer), _deleted(deleted) {}
+
+	void setHandles(Audio::SoundHandle handle, Audio::SoundHandle other) {
+		_handle = handle;
+		_other = other;
+	}
+
+	int readBuffer(int16 *buffer, const int numSamples) {
+		volatile int32 *deleted = _deleted;
+
+		_mixer->stopHandle(_handle);
+		for (int i = 0; i < 1000; i++)
+			_mixer->setChannelVolume(_other, i & 0xFF);
+
+		if (Common::atomicLoad(deleted)) {
+			_deletedWhileRead = 1;
+			return 0;
+		}
+		return MixerTestStream::readBuffer(buffer, numSamples);
+	}
+
+	static int _deletedWhileRead;
+
+private:
+	Audio::Mixer *_mixer;
+	volatile int32 *_deleted;
+	Audio::SoundHandle _handle, _other;
+};
+
+int MixerSelfStoppingStream::_deletedWhileRead = 0;
+
+class MixerTestSuite : public CxxTest::TestSuite {
+	TestSystem *_system;
+	OSystem *_oldSystem;
+	Audio::MixerImpl *_mixerImpl;
+	Audio::Mixer *_mixer;
+
+	static volatile int32 _stopMixing;
+
+#ifdef POSIX
+	static void *mixThread(void *arg) {
+		Audio::MixerImpl *mixer = (Audio::MixerImpl *)arg;
+		int16 buffer[256 * 2];
+		while (!Common::atomicLoad(&_stopMixing)) {
+			mixer->mixCallback((byte *)buffer, sizeof(buffer));
+			sched_yield();
+		}
+		return 0;
+	}
+#endif
+
+public:
+	void setUp() {
+		_oldSystem = g_system;
+		_system = new TestSystem();
+		g_system = _system;
+
+		_mixerImpl = new Audio::MixerImpl(_system, 22050);
+		_mixerImpl->setReady(true);
+		_mixer = _mixerImpl;
+		MixerTestStream::_readsAfterStop = 0;
+	}
+
+	void tearDown() {
+		delete _mixerImpl;
+		delete _system;
+		g_system = _oldSystem;
+	}
+
+	void test_play_and_finish() {
+		int16 buffer[64 * 2];
+		volatile int32 deleted = 0;
+		Audio::SoundHandle handle;
+
+		_mixer->playStream(Audio::Mixer::kSFXSoundType, &handle, new MixerTestStream(100, &deleted), 42);
+		TS_ASSERT(_mixer->isSoundHandleActive(handle));
+		TS_ASSERT(_mixer->isSoundIDActive(42));
+		TS_ASSERT_EQUALS(_mixer->getSoundID(handle), 42);
+
+		_mixerImpl->mixCallback((byte *)buffer, sizeof(buffer));
+		// 1000 at channel volume 255 and sound type volume 256
+		TS_ASSERT_EQUALS(buffer[0], 1000);
+		TS_ASSERT_EQUALS(buffer[1], 1000);
+
+		_mixerImpl->mixCallback((byte *)buffer, sizeof(buffer));
+		TS_ASSERT(_mixer->isSoundHandleActive(handle));
+
+		// The third callback finds the stream drained
+		_mixerImpl->mixCallback((byte *)buffer, sizeof(buffer));
+		TS_ASSERT(!_mixer->isSoundHandleActive(handle));
+		TS_ASSERT(!_mixer->isSoundIDActive(42));
+		TS_ASSERT_EQUALS(deleted, 1);
+	}
+
+	void test_commands() {
+		int16 buffer[16 * 2];
+		volatile int32 deleted = 0;
+		Audio::SoundHandle handle;
+
+		_mixer->playStream(Audio::Mixer::kSFXSoundType, &handle, new MixerTestStream(1000, &deleted));
+
+		_mixer->setChannelVolume(handle, 0);
+		TS_ASSERT_EQUALS(_mixer->getChannelVolume(handle), 0);
+		_mixerImpl->mixCallback((byte *)buffer, sizeof(buffer));
+		TS_ASSERT_EQUALS(buffer[0], 0);
+
+		_mixer->setChannelVolume(handle, 255);
+		_mixer->setChannelBalance(handle, 127);
+		TS_ASSERT_EQUALS(_mixer->getChannelBalance(handle), 127);
+		_mixerImpl->mixCallback((byte *)buffer, sizeof(buffer));
+		TS_ASSERT_EQUALS(buffer[0], 0);
+		TS_ASSERT_EQUALS(buffer[1], 1000);
+
+		_mixer->muteSoundType(Audio::Mixer::kSFXSoundType, true);
+		_mixerImpl->mixCallback((byte *)buffer, sizeof(buffer));
+		TS_ASSERT_EQUALS(buffer[1], 0);
+		_mixer->muteSoundType(Audio::Mixer::kSFXSoundType, false);
+
+		_mixer->pauseHandle(handle, true);
+		TS_ASSERT_EQUALS(_mixerImpl->mixCallback((byte *)buffer, sizeof(buffer)), 0);
+		_mixer->pauseHandle(handle, false);
+		TS_ASSERT_EQUALS(_mixerImpl->mixCallback((byte *)buffer, sizeof(buffer)), 16);
+
+		_mixer->stopHandle(handle);
+		TS_ASSERT(!_mixer->isSoundHandleActive(handle));
+		_mixerImpl->mixCallback((byte *)buffer, sizeof(buffer));
+		TS_ASSERT_EQUALS(deleted, 1);
+	}
+
+	void test_full_queue() {
+		volatile int32 deleted = 0;
+		Audio::SoundHandle handle;
+
+		// Without any callback, the mixer methods have to drain the
+		// queue themselves.
+		_mixer->playStream(Audio::Mixer::kSFXSoundType, &handle, new MixerTestStream(1000, &deleted));
+		for (int i = 0; i < 1000; i++)
+			_mixer->setChannelVolume(handle, i & 0xFF);
+
+		_mixer->stopAll();
+		TS_ASSERT(!_mixer->isSoundHandleActive(handle));
+
+		delete _mixerImpl;
+		_mixerImpl = 0;
+		TS_ASSERT_EQUALS(deleted, 1);
+	}
+
+	void test_calls_from_callback() {
+		int16 buffer[16 * 2];
+		volatile int32 deleted = 0;
+		Audio::SoundHandle handle, other;
+
+		// The mixer methods called from inside the callback must neither
+		// wait for the callback to finish, nor for it to drain the queue.
+		_mixer->playStream(Audio::Mixer::kSFXSoundType, &other, new MixerTestStream(1000, &deleted), 7);
+		_mixer->playStream(Audio::Mixer::kSFXSoundType, &handle, new MixerCallingStream(_mixer, other));
+		_mixerImpl->mixCallback((byte *)buffer, sizeof(buffer));
+
+		TS_ASSERT(!_mixer->isSoundHandleActive(other));
+		TS_ASSERT(_mixer->isSoundHandleActive(handle));
+
+		_mixerImpl->mixCallback((byte *)buffer, sizeof(buffer));
+		TS_ASSERT_EQUALS(deleted, 1);
+	}
+
+	void test_stop_self_from_callback() {
+		int16 buffer[16 * 2];
+		volatile int32 deleted = 0;
+		Audio::SoundHandle handle, other;
+
+		// Draining the full queue inside the callback must not delete the
+		// channel being mixed
+		MixerSelfStoppingStream *stream = new MixerSelfStoppingStream(_mixer, &deleted);
+		_mixer->playStream(Audio::Mixer::kSFXSoundType, &handle, stream);
+		_mixer->playStream(Audio::Mixer::kSFXSoundType, &other, new MixerTestStream(1000));
+		stream->setHandles(handle, other);
+		_mixerImpl->mixCallback((byte *)buffer, sizeof(buffer));
+
+		TS_ASSERT_EQUALS(MixerSelfStoppingStream::_deletedWhileRead, 0);
+		TS_ASSERT_EQUALS(deleted, 1);
+		TS_ASSERT(!_mixer->isSoundHandleActive(handle));
+	}
+
+	void test_stress() {
+#ifdef POSIX
+		volatile int32 deleted = 0;
+		int created = 0;
+		Common::Array<MixerTestStream *> localStreams;
+
+		_stopMixing = 0;
+		pthread_t thread;
+		TS_ASSERT_EQUALS(pthread_create(&thread, 0, &mixThread, _mixerImpl), 0);
+
+		for (int i = 0; i < 2000; i++) {
+			Audio::SoundHandle handle, localHandle;
+
+			// A stream owned by the mixer, short enough to finish on its own
+			// now and then.
+			_mixer->playStream(Audio::Mixer::kSFXSoundType, &handle, new MixerTestStream(i % 700, &deleted), i % 3 ? -1 : 7);
+			created++;
+			_mixer->setChannelVolume(handle, i & 0xFF);
+			_mixer->pauseHandle(handle, (i & 1) != 0);
+			_mixer->getElapsedTime(handle);
+
+			// A stream owned by us, which must not be read after it was stopped
+			MixerTestStream *local = new MixerTestStream(100000);
+			localStreams.push_back(local);
+			_mixer->playStream(Audio::Mixer::kMusicSoundType, &localHandle, local, -1, 255, 0, DisposeAfterUse::NO);
+			_mixer->setChannelBalance(localHandle, (i % 255) - 127);
+			if (i % 5)
+				sched_yield();
+			_mixer->stopHandle(localHandle);
+			local->markStopped();
+			TS_ASSERT(!_mixer->isSoundHandleActive(localHandle));
+
+			if (i % 8 == 7)
+				_mixer->stopAll();
+			else if (i & 1)
+				_mixer->stopHandle(handle);
+		}
+
+		_mixer->stopAll();
+		Common::atomicStore(&_stopMixing, 1);
+		pthread_join(thread, 0);
+
+		delete _mixerImpl;
+		_mixerImpl = 0;
+
+		TS_ASSERT_EQUALS(MixerTestStream::_readsAfterStop, 0);
+		TS_ASSERT_EQUALS(deleted, created);
+
+		for (uint i = 0; i < localStreams.size(); i++)
+			delete localStreams[i];
+#endif
+	}
+};
+
+volatile int32 MixerTestSuite::_stopMixing = 0;
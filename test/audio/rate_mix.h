@@ -0,0 +1,140 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/rate_mix.h"
+#include "audio/mixer.h"
+#include "common/util.h"
+
+#include "helper.h"
+
+class RateMixTestSuite : public CxxTest::TestSuite {
+public:
+	void tearDown() {
+		Audio::selectMixImplementation(Audio::kMixAuto);
+	}
+
+	void test_kernels_bit_exact() {
+		const Audio::MixProcs *reference = Audio::getMixProcs(Audio::kMixScalar);
+		TS_ASSERT(reference != 0);
+
+		for (int impl = Audio::kMixScalar + 1; impl < Audio::kMixAuto; impl++) {
+			const Audio::MixProcs *procs = Audio::getMixProcs((Audio::MixImplementation)impl);
+			if (!procs)
+				continue;
+
+			compareProcs(reference->mono, procs->mono, false);
+			compareProcs(reference->stereo, procs->stereo, true);
+			compareProcs(reference->stereoReverse, procs->stereoReverse, true);
+		}
+	}
+
+	void test_scalar_reference() {
+		const Audio::MixProcs *procs = Audio::getMixProcs(Audio::kMixScalar);
+
+		const int16 in[4] = { -32768, 32767, -1, 255 };
+		int16 out[4] = { 32767, -32768, 0, 0 };
+
+		procs->stereoReverse(in, out, 2, 256, 128);
+		// Left input goes to the right output and vice versa; the
+		// division rounds towards zero and the addition saturates.
+		TS_ASSERT_EQUALS(out[0], 32767);
+		TS_ASSERT_EQUALS(out[1], -32768);
+		TS_ASSERT_EQUALS(out[2], 127);
+		TS_ASSERT_EQUALS(out[3], -1);
+	}
+
+	void test_converters_bit_exact() {
+		static const int rates[][2] = {
+			{ 22050, 22050 },	// copy
+			{ 44100, 22050 },	// simple
+			{ 11025, 22050 },	// linear
+			{ 22050, 44100 }	// linear
+		};
+
+		for (int i = 0; i < ARRAYSIZE(rates); i++) {
+			for (int stereo = 0; stereo < 2; stereo++) {
+				for (int reverse = 0; reverse <= stereo; reverse++)
+					compareConverters(rates[i][0], rates[i][1], stereo != 0, reverse != 0);
+			}
+		}
+	}
+
+private:
+	static void fillRandom(int16 *buf, int len, uint32 &seed) {
+		static const int16 edges[] = { -32768, -32767, -256, -255, -1, 0, 1, 255, 256, 32766, 32767 };
+
+		for (int i = 0; i < len; i++) {
+			seed = seed * 1103515245 + 12345;
+			if ((seed >> 28) < 4)
+				buf[i] = edges[(seed >> 16) % ARRAYSIZE(edges)];
+			else
+				buf[i] = (int16)(seed >> 12);
+		}
+	}
+
+	void compareProcs(Audio::MixProc reference, Audio::MixProc proc, bool stereo) {
+		static const int volumes[] = { 0, 1, 127, 128, 255, 256 };
+		const int kMaxLen = 70;
+
+		int16 in[kMaxLen * 2];
+		int16 out[kMaxLen * 2 + 2], expected[kMaxLen * 2 + 2];
+		uint32 seed = 1;
+
+		for (int len = 0; len <= kMaxLen; len++) {
+			for (int l = 0; l < ARRAYSIZE(volumes); l++) {
+				for (int r = 0; r < ARRAYSIZE(volumes); r++) {
+					fillRandom(in, len * (stereo ? 2 : 1), seed);
+					fillRandom(expected, len * 2 + 2, seed);
+					memcpy(out, expected, sizeof(out));
+
+					reference(in, expected, len, volumes[l], volumes[r]);
+					proc(in, out, len, volumes[l], volumes[r]);
+
+					// Includes one sample pair beyond the end, which must
+					// stay untouched.
+					TS_ASSERT_SAME_DATA(out, expected, (len * 2 + 2) * sizeof(int16));
+				}
+			}
+		}
+	}
+
+	static void convert(int inRate, int outRate, bool stereo, bool reverse, int16 *out, int outLen) {
+		Audio::SeekableAudioStream *stream = createSineStream<int16>(inRate, 1, 0, true, stereo);
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, stereo, reverse);
+
+		memset(out, 0, outLen * 2 * sizeof(int16));
+
+		// Flow in odd sized pieces with changing volumes, the way the mixer
+		// would, until the stream runs dry.
+		int pos = 0, step = 1;
+		while (pos < outLen) {
+			const int len = MIN(step, outLen - pos);
+			const int done = converter->flow(*stream, out + pos * 2, len, 37 * step % 257, 256 - step % 200);
+			pos += done;
+			if (done < len)
+				break;
+			step = step * 3 + 1;
+			if (step > 2000)
+				step %= 97;
+		}
+
+		delete converter;
+		delete stream;
+	}
+
+	void compareConverters(int inRate, int outRate, bool stereo, bool reverse) {
+		const int outLen = outRate + 100;
+		int16 *expected = new int16[outLen * 2];
+		int16 *out = new int16[outLen * 2];
+
+		TS_ASSERT(Audio::selectMixImplementation(Audio::kMixScalar));
+		convert(inRate, outRate, stereo, reverse, expected, outLen);
+
+		TS_ASSERT(Audio::selectMixImplementation(Audio::kMixAuto));
+		convert(inRate, outRate, stereo, reverse, out, outLen);
+
+		TS_ASSERT_SAME_DATA(out, expected, outLen * 2 * sizeof(int16));
+
+		delete[] expected;
+		delete[] out;
+	}
+};
@@ -0,0 +1,174 @@
+#include <cxxtest/TestSuite.h>
+
+#include "backends/timer/default/default-timer.h"
+#include "common/array.h"
+
+#include "test/system.h"
+
+class TimerTestSuite : public CxxTest::TestSuite {
+	TestSystem *_system;
+	OSystem *_oldSystem;
+	DefaultTimerManager *_manager;
+
+	struct Calls {
+		TimerTestSuite *suite;
+		int id;
+		uint count;
+	};
+
+	Common::Array<int> _order;
+	Common::TimerManager::TimerProc _removeFromCallback;
+
+	template<int N>
+	static void timerProc(void *refCon) {
+		Calls *calls = (Calls *)refCon;
+		calls->count++;
+		calls->suite->_order.push_back(calls->id);
+		if (calls->suite->_removeFromCallback) {
+			calls->suite->_manager->removeTimerProc(calls->suite->_removeFromCallback);
+			calls->suite->_removeFromCallback = 0;
+		}
+	}
+
+	void initCalls(Calls &calls, int id) {
+		calls.suite = this;
+		calls.id = id;
+		calls.count = 0;
+	}
+
+	void runUntil(uint32 start, uint32 end) {
+		for (uint32 t = start; t <= end; t++) {
+			_system->setMillis(t);
+			_manager->handler();
+		}
+	}
+
+public:
+	void setUp() {
+		_oldSystem = g_system;
+		_system = new TestSystem();
+		g_system = _system;
+		_system->setMillis(0);
+
+		_manager = new DefaultTimerManager();
+		_removeFromCallback = 0;
+		_order.clear();
+	}
+
+	void tearDown() {
+		delete _manager;
+		delete _system;
+		g_system = _oldSystem;
+	}
+
+	void test_order() {
+		static const int intervals[] = { 10000, 25000, 7000, 10000, 3000 };
+		Calls calls[ARRAYSIZE(intervals)];
+
+		for (int i = 0; i < ARRAYSIZE(intervals); i++)
+			initCalls(calls[i], i);
+		_manager->installTimerProc(&timerProc<0>, intervals[0], &calls[0], "t0");
+		_manager->installTimerProc(&timerProc<1>, intervals[1], &calls[1], "t1");
+		_manager->installTimerProc(&timerProc<2>, intervals[2], &calls[2], "t2");
+		_manager->installTimerProc(&timerProc<3>, intervals[3], &calls[3], "t3");
+		_manager->installTimerProc(&timerProc<4>, intervals[4], &calls[4], "t4");
+
+		// With one handler call per millisecond, every timer is invoked
+		// right after each of its deadlines.
+		Common::Array<uint32> deadlines;
+		uint32 next[ARRAYSIZE(intervals)];
+		for (int i = 0; i < ARRAYSIZE(intervals); i++)
+			next[i] = intervals[i] / 1000;
+
+		for (uint32 t = 1; t <= 1000; t++) {
+			const uint done = _order.size();
+			_system->setMillis(t);
+			_manager->handler();
+
+			for (uint j = done; j < _order.size(); j++) {
+				const int id = _order[j];
+				TS_ASSERT_EQUALS(next[id] + 1, t);
+				next[id] += intervals[id] / 1000;
+			}
+		}
+
+		for (int i = 0; i < ARRAYSIZE(intervals); i++) {
+			TS_ASSERT_EQUALS(calls[i].count, 999 / (intervals[i] / 1000));
+
+			Common::TimerManager::TimerStats stats;
+			TS_ASSERT(_manager->getTimerStats(i == 0 ? &timerProc<0> : i == 1 ? &timerProc<1> : i == 2 ? &timerProc<2> : i == 3 ? &timerProc<3> : &timerProc<4>, stats));
+			TS_ASSERT_EQUALS(stats.calls, calls[i].count);
+			TS_ASSERT_EQUALS(stats.overruns, 0u);
+			TS_ASSERT_EQUALS(stats.maxLateness, 1u);
+		}
+	}
+
+	void test_no_drift() {
+		Calls calls;
+		initCalls(calls, 0);
+
+		// 60 Hz, which is not a whole number of milliseconds
+		_manager->installTimerProc(&timerProc<0>, 16667, &calls, "60hz");
+		runUntil(1, 10001);
+
+		TS_ASSERT_EQUALS(calls.count, 600u);
+	}
+
+	void test_overruns() {
+		Calls calls;
+		initCalls(calls, 0);
+
+		Common::TimerManager::TimerStats stats;
+		TS_ASSERT(!_manager->getTimerStats(&timerProc<0>, stats));
+
+		_manager->installTimerProc(&timerProc<0>, 10000, &calls, "late");
+
+		// The handler is called late, so the timer catches up with all the
+		// deadlines it missed.
+		_system->setMillis(55);
+		_manager->handler();
+		TS_ASSERT_EQUALS(calls.count, 5u);
+
+		TS_ASSERT(_manager->getTimerStats(&timerProc<0>, stats));
+		TS_ASSERT_EQUALS(stats.calls, 5u);
+		TS_ASSERT_EQUALS(stats.overruns, 4u);
+		TS_ASSERT_EQUALS(stats.maxLateness, 45u);
+
+		// The deadlines are unchanged by the late call
+		runUntil(56, 61);
+		TS_ASSERT_EQUALS(calls.count, 6u);
+		TS_ASSERT_EQUALS(_order.size(), 6u);
+	}
+
+	void test_remove() {
+		Calls calls[4];
+		for (int i = 0; i < 4; i++)
+			initCalls(calls[i], i);
+
+		_manager->installTimerProc(&timerProc<0>, 5000, &calls[0], "t0");
+		_manager->installTimerProc(&timerProc<1>, 3000, &calls[1], "t1");
+		_manager->installDedicatedTimerProc(&timerProc<2>, 4000, &calls[2], "t2");
+		_manager->installTimerProc(&timerProc<3>, 2000, &calls[3], "t3");
+
+		_manager->removeTimerProc(&timerProc<1>);
+		runUntil(1, 100);
+		TS_ASSERT_EQUALS(calls[0].count, 19u);
+		TS_ASSERT_EQUALS(calls[1].count, 0u);
+		// Without thread support, dedicated timers are run by the handler
+		TS_ASSERT_EQUALS(calls[2].count, 24u);
+		TS_ASSERT_EQUALS(calls[3].count, 49u);
+
+		// Removal from within a callback
+		_removeFromCallback = &timerProc<0>;
+		runUntil(101, 200);
+		TS_ASSERT(calls[0].count <= 20u);
+		TS_ASSERT_EQUALS(calls[2].count, 49u);
+		TS_ASSERT_EQUALS(calls[3].count, 99u);
+
+		// The same callback can be installed again under the same name
+		_manager->removeTimerProc(&timerProc<2>);
+		_manager->installTimerProc(&timerProc<2>, 1000, &calls[2], "t2");
+		runUntil(201, 210);
+		TS_ASSERT_EQUALS(calls[2].count, 58u);
+	}
+};
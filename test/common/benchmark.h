@@ -0,0 +1,83 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/benchmark.h"
+#include "common/memstream.h"
+
+static uint32 s_fakeMicros = 0;
+
+static uint32 fakeClock() {
+	return s_fakeMicros;
+}
+
+class BenchmarkTestSuite : public CxxTest::TestSuite {
+public:
+	void setUp() {
+		s_fakeMicros = 0;
+		g_benchmark.start(&fakeClock);
+	}
+
+	void tearDown() {
+		g_benchmark.stop();
+	}
+
+	void test_exclusive_categories() {
+		s_fakeMicros = 100;
+		{
+			Common::BenchmarkScope rendering(Common::Benchmark::kCategoryRendering);
+			s_fakeMicros = 300;
+			{
+				// Nested scopes pause the enclosing one
+				Common::BenchmarkScope audio(Common::Benchmark::kCategoryAudio);
+				s_fakeMicros = 350;
+			}
+			s_fakeMicros = 400;
+		}
+		s_fakeMicros = 1000;
+		g_benchmark.endFrame();
+
+		const Common::Array<Common::Benchmark::Frame> &frames = g_benchmark.getFrames();
+		TS_ASSERT_EQUALS(frames.size(), 1U);
+		TS_ASSERT_EQUALS(frames[0].time[Common::Benchmark::kCategoryScript], 700U);
+		TS_ASSERT_EQUALS(frames[0].time[Common::Benchmark::kCategoryRendering], 250U);
+		TS_ASSERT_EQUALS(frames[0].time[Common::Benchmark::kCategoryAudio], 50U);
+		TS_ASSERT_EQUALS(frames[0].time[Common::Benchmark::kCategoryScaling], 0U);
+		TS_ASSERT_EQUALS(frames[0].getTotal(), 1000U);
+	}
+
+	void test_frame_split_inside_scope() {
+		Common::BenchmarkScope rendering(Common::Benchmark::kCategoryRendering);
+		s_fakeMicros = 10;
+		g_benchmark.endFrame();
+		s_fakeMicros = 30;
+		g_benchmark.endFrame();
+
+		const Common::Array<Common::Benchmark::Frame> &frames = g_benchmark.getFrames();
+		TS_ASSERT_EQUALS(frames.size(), 2U);
+		TS_ASSERT_EQUALS(frames[0].time[Common::Benchmark::kCategoryRendering], 10U);
+		TS_ASSERT_EQUALS(frames[1].time[Common::Benchmark::kCategoryRendering], 20U);
+	}
+
+	void test_inactive() {
+		g_benchmark.stop();
+
+		{
+			Common::BenchmarkScope rendering(Common::Benchmark::kCategoryRendering);
+			s_fakeMicros = 10;
+		}
+		g_benchmark.endFrame();
+
+		TS_ASSERT(!g_benchmark.isActive());
+		TS_ASSERT_EQUALS(g_benchmark.getFrames().size(), 0U);
+	}
+
+	void test_csv() {
+		s_fakeMicros = 5;
+		g_benchmark.endFrame();
+
+		Common::MemoryWriteStreamDynamic stream;
+		g_benchmark.writeFrames(stream);
+
+		Common::String csv((const char *)stream.getData(), stream.size());
+		TS_ASSERT_EQUALS(csv, "frame,script/VM,rendering,scaling,audio mixing,total\n0,5,0,0,0,5\n");
+	}
+};
@@ -149,4 +149,124 @@ class BitStreamTestSuite : public CxxTest::TestSuite
 		TS_ASSERT_EQUALS(bs.peekBits(5), 12u);
 		TS_ASSERT(!bs.eos());
 	}
+
+	void test_peek_bits_past_end() {
+		byte contents[] = { 'a', 'b' };
+
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+
+		Common::BitStream8MSB bs(ms);
+		bs.skip(11);
+		TS_ASSERT_EQUALS(bs.peekBits(8), 0x10u);
+		TS_ASSERT_EQUALS(bs.pos(), 11u);
+
+		Common::BitStream8LSB bsLSB(ms);
+		bsLSB.rewind();
+		bsLSB.skip(11);
+		TS_ASSERT_EQUALS(bsLSB.peekBits(8), 12u);
+		TS_ASSERT_EQUALS(bsLSB.pos(), 11u);
+	}
+
+	void test_memory() {
+		static const byte contents[] = { 0x78, 0x56, 0x34, 0x12, 0xF0, 0xDE, 0xBC, 0x9A };
+
+		Common::BitStream32LELSB bs(contents, sizeof(contents));
+		TS_ASSERT_EQUALS(bs.size(), 64u);
+		TS_ASSERT_EQUALS(bs.getBits(4), 0x8u);
+		TS_ASSERT_EQUALS(bs.getBits(32), 0x01234567u);
+		TS_ASSERT_EQUALS(bs.peekBits(28), 0x9ABCDEFu);
+		bs.skip(24);
+		TS_ASSERT_EQUALS(bs.pos(), 60u);
+		TS_ASSERT_EQUALS(bs.getBits(4), 0x9u);
+		TS_ASSERT(bs.eos());
+
+		bs.rewind();
+		TS_ASSERT_EQUALS(bs.getBits(16), 0x5678u);
+
+		Common::BitStream32BEMSB bsBE(contents, sizeof(contents));
+		TS_ASSERT_EQUALS(bsBE.getBits(12), 0x785u);
+		TS_ASSERT_EQUALS(bsBE.getBits(32), 0x63412F0Du);
+		TS_ASSERT_EQUALS(bsBE.getBits(20), 0xEBC9Au);
+		TS_ASSERT(bsBE.eos());
+	}
+
+	void test_skip_values() {
+		byte contents[64];
+		for (int i = 0; i < 64; i++)
+			contents[i] = i;
+
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+
+		Common::BitStream16BEMSB bs(ms);
+		bs.skip(3);
+		bs.skip(200);
+		TS_ASSERT_EQUALS(bs.pos(), 203u);
+		TS_ASSERT_EQUALS(bs.getBits(5), 25u);
+
+		Common::BitStream16BEMSB bsMem(contents, sizeof(contents));
+		bsMem.skip(3);
+		bsMem.skip(200);
+		TS_ASSERT_EQUALS(bsMem.pos(), 203u);
+		TS_ASSERT_EQUALS(bsMem.getBits(5), 25u);
+	}
+
+	/**
+	 * Read all layouts with all sizes from 1 to 32 bits, from a stream and
+	 * from memory, and compare with the bits taken one at a time.
+	 */
+	template<int valueBits, bool isLE, bool isMSB2LSB>
+	void checkLayout() {
+		byte contents[64];
+		uint32 seed = 1;
+		for (int i = 0; i < 64; i++) {
+			seed = seed * 1103515245 + 12345;
+			contents[i] = seed >> 24;
+		}
+
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+
+		Common::BitStreamImpl<valueBits, isLE, isMSB2LSB> bs(ms);
+		Common::BitStreamImpl<valueBits, isLE, isMSB2LSB> bsMem(contents, sizeof(contents));
+
+		uint32 pos = 0;
+		for (uint8 n = 1; pos + n <= 64 * 8; n = n % 32 + 1) {
+			uint32 expected = 0;
+			for (uint8 i = 0; i < n; i++) {
+				// The bit at pos + i, in the order of the layout
+				const uint32 value = (pos + i) / valueBits;
+				uint32 bit = (pos + i) % valueBits;
+				if (isMSB2LSB)
+					bit = valueBits - 1 - bit;
+
+				const uint32 byteInValue = isLE ? (bit / 8) : (valueBits / 8 - 1 - bit / 8);
+				const byte b = contents[value * (valueBits / 8) + byteInValue];
+
+				if (isMSB2LSB)
+					expected = (expected << 1) | ((b >> (bit % 8)) & 1);
+				else
+					expected |= ((b >> (bit % 8)) & 1) << i;
+			}
+
+			TS_ASSERT_EQUALS(bs.peekBits(n), expected);
+			TS_ASSERT_EQUALS(bs.getBits(n), expected);
+			TS_ASSERT_EQUALS(bsMem.getBits(n), expected);
+
+			pos += n;
+			TS_ASSERT_EQUALS(bs.pos(), pos);
+			TS_ASSERT_EQUALS(bsMem.pos(), pos);
+		}
+	}
+
+	void test_layouts() {
+		checkLayout<8, false, true>();
+		checkLayout<8, false, false>();
+		checkLayout<16, true, true>();
+		checkLayout<16, true, false>();
+		checkLayout<16, false, true>();
+		checkLayout<16, false, false>();
+		checkLayout<32, true, true>();
+		checkLayout<32, true, false>();
+		checkLayout<32, false, true>();
+		checkLayout<32, false, false>();
+	}
 };
@@ -0,0 +1,98 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/framescheduler.h"
+
+class FrameSchedulerTestSuite : public CxxTest::TestSuite {
+public:
+	void test_first_frame_due() {
+		Common::FrameScheduler scheduler;
+		scheduler.reset(1000);
+
+		TS_ASSERT(scheduler.isDue(1000));
+		TS_ASSERT_EQUALS(scheduler.getDelay(1000), 0U);
+	}
+
+	void test_deadline() {
+		Common::FrameScheduler scheduler;
+		scheduler.reset(0);
+
+		scheduler.beginFrame(0);
+		scheduler.endFrame(5, 66);
+
+		TS_ASSERT_EQUALS(scheduler.getDeadline(), 66U);
+		TS_ASSERT(!scheduler.isDue(65));
+		TS_ASSERT(scheduler.isDue(66));
+		TS_ASSERT_EQUALS(scheduler.getDelay(5), 61U);
+		TS_ASSERT_EQUALS(scheduler.getDelay(70), 0U);
+	}
+
+	void test_no_drift() {
+		Common::FrameScheduler scheduler;
+		scheduler.reset(0);
+
+		// Every wake-up comes in 3 ms late; the deadlines must still
+		// stay on the 50 ms grid.
+		uint32 now = 0;
+		for (int i = 0; i < 10; i++) {
+			scheduler.beginFrame(now);
+			scheduler.endFrame(now + 1, 50);
+			now = scheduler.getDeadline() + 3;
+		}
+
+		TS_ASSERT_EQUALS(scheduler.getDeadline(), 500U);
+
+		const Common::FrameScheduler::Stats &stats = scheduler.getStats();
+		TS_ASSERT_EQUALS(stats.frames, 10U);
+		TS_ASSERT_EQUALS(stats.lateFrames, 9U);
+		TS_ASSERT_EQUALS(stats.totalLateness, 27U);
+		TS_ASSERT_EQUALS(stats.maxLateness, 3U);
+		TS_ASSERT_EQUALS(stats.busyTime, 10U);
+	}
+
+	void test_resync() {
+		Common::FrameScheduler scheduler;
+		scheduler.reset(0);
+
+		scheduler.beginFrame(0);
+		scheduler.endFrame(0, 50);
+
+		// Way behind schedule: do not try to catch up
+		scheduler.beginFrame(1000);
+		scheduler.endFrame(1010, 50);
+
+		TS_ASSERT_EQUALS(scheduler.getDeadline(), 1050U);
+	}
+
+	void test_wrap_around() {
+		Common::FrameScheduler scheduler;
+		scheduler.reset(0xFFFFFFF0);
+
+		scheduler.beginFrame(0xFFFFFFF0);
+		scheduler.endFrame(0xFFFFFFF0, 32);
+
+		TS_ASSERT_EQUALS(scheduler.getDeadline(), 16U);
+		TS_ASSERT(!scheduler.isDue(0xFFFFFFFF));
+		TS_ASSERT_EQUALS(scheduler.getDelay(0xFFFFFFFF), 17U);
+		TS_ASSERT(scheduler.isDue(16));
+	}
+
+	void test_rates() {
+		Common::FrameScheduler scheduler;
+		scheduler.reset(0);
+
+		uint32 now = 0;
+		for (int i = 0; i < 60; i++) {
+			scheduler.wakeUp();
+			scheduler.beginFrame(now);
+			scheduler.endFrame(now, 50);
+			now = scheduler.getDeadline();
+		}
+
+		TS_ASSERT_EQUALS(scheduler.getFramesPerSecond100(3000), 2000U);
+		TS_ASSERT_EQUALS(scheduler.getWakeUpsPerSecond(3000), 20U);
+
+		scheduler.resetStats(3000);
+		TS_ASSERT_EQUALS(scheduler.getStats().frames, 0U);
+		TS_ASSERT_EQUALS(scheduler.getFramesPerSecond100(3000), 0U);
+	}
+};
@@ -0,0 +1,152 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/bitstream.h"
+#include "common/huffman.h"
+#include "common/memstream.h"
+
+/**
+ * A code with lengths from 1 to 20 bits, which takes the primary and two
+ * levels of secondary tables: 0, 10, 110, ... 1111111111111111110 and
+ * 11111111111111111110, 11111111111111111111.
+ */
+static const uint32 s_longCodeCount = 21;
+
+static void makeLongCode(uint32 *codes, uint8 *lengths, bool msb2lsb) {
+	for (uint32 i = 0; i < s_longCodeCount; i++) {
+		lengths[i] = MIN<uint32>(i + 1, s_longCodeCount - 1);
+
+		// i ones, then a zero, but for the last code
+		uint32 code = (i == s_longCodeCount - 1) ? ((1 << lengths[i]) - 1) : (((1 << i) - 1) << 1);
+
+		if (!msb2lsb) {
+			uint32 reversed = 0;
+			for (uint32 j = 0; j < lengths[i]; j++)
+				reversed |= ((code >> j) & 1) << (lengths[i] - 1 - j);
+			code = reversed;
+		}
+
+		codes[i] = code;
+	}
+}
+
+class HuffmanTestSuite : public CxxTest::TestSuite {
+public:
+	void test_get_symbol() {
+		// Codes 0, 10, 110, 111 for the symbols 'a' to 'd'
+		static const uint32 codes[] = { 0, 2, 6, 7 };
+		static const uint8 lengths[] = { 1, 2, 3, 3 };
+		static const uint32 symbols[] = { 'a', 'b', 'c', 'd' };
+
+		// abcd dcba a, padded with zeroes
+		static const byte contents[] = { 0x5B, 0xFD, 0x00, 0x00, 0x00 };
+
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+		Common::BitStream8MSB bs(ms);
+
+		Common::Huffman h(0, 4, codes, lengths, symbols);
+
+		static const char expected[] = "abcddcbaa";
+		for (uint32 i = 0; i < sizeof(expected) - 1; i++)
+			TS_ASSERT_EQUALS(h.getSymbol(bs), (uint32)expected[i]);
+
+		TS_ASSERT_EQUALS(bs.pos(), 19u);
+	}
+
+	void test_set_symbols() {
+		static const uint32 codes[] = { 0, 2, 6, 7 };
+		static const uint8 lengths[] = { 1, 2, 3, 3 };
+		static const uint32 symbols[] = { 10, 11, 12, 13 };
+
+		static const byte contents[] = { 0x5B, 0x00, 0x00 };
+
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+		Common::BitStream8MSB bs(ms);
+
+		Common::Huffman h(0, 4, codes, lengths);
+		TS_ASSERT_EQUALS(h.getSymbol(bs), 0u);
+
+		// The tables have been built by now, and must see the new symbols
+		h.setSymbols(symbols);
+		TS_ASSERT_EQUALS(h.getSymbol(bs), 11u);
+		TS_ASSERT_EQUALS(h.getSymbol(bs), 12u);
+
+		h.setSymbols();
+		TS_ASSERT_EQUALS(h.getSymbol(bs), 2u);
+	}
+
+	void test_long_codes_msb() {
+		uint32 codes[s_longCodeCount];
+		uint8 lengths[s_longCodeCount];
+		makeLongCode(codes, lengths, true);
+
+		// Every symbol once, longest first
+		byte contents[64];
+		memset(contents, 0, sizeof(contents));
+
+		uint32 bit = 0;
+		for (int i = s_longCodeCount - 1; i >= 0; i--)
+			for (int j = lengths[i] - 1; j >= 0; j--, bit++)
+				if ((codes[i] >> j) & 1)
+					contents[bit >> 3] |= 0x80 >> (bit & 7);
+
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+		Common::BitStream8MSB bs(ms);
+
+		Common::Huffman h(0, s_longCodeCount, codes, lengths);
+
+		for (int i = s_longCodeCount - 1; i >= 0; i--)
+			TS_ASSERT_EQUALS(h.getSymbol(bs), (uint32)i);
+
+		TS_ASSERT_EQUALS(bs.pos(), bit);
+	}
+
+	void test_long_codes_lsb() {
+		uint32 codes[s_longCodeCount];
+		uint8 lengths[s_longCodeCount];
+		makeLongCode(codes, lengths, false);
+
+		byte contents[64];
+		memset(contents, 0, sizeof(contents));
+
+		// Bit j of a code read LSB to MSB is the j-th bit read
+		uint32 bit = 0;
+		for (int i = s_longCodeCount - 1; i >= 0; i--)
+			for (int j = 0; j < lengths[i]; j++, bit++)
+				if ((codes[i] >> j) & 1)
+					contents[bit >> 3] |= 1 << (bit & 7);
+
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+		Common::BitStream32LELSB bs(ms);
+
+		Common::Huffman h(0, s_longCodeCount, codes, lengths);
+
+		for (int i = s_longCodeCount - 1; i >= 0; i--)
+			TS_ASSERT_EQUALS(h.getSymbol(bs), (uint32)i);
+
+		TS_ASSERT_EQUALS(bs.pos(), bit);
+	}
+
+	void test_end_of_stream() {
+		uint32 codes[s_longCodeCount];
+		uint8 lengths[s_longCodeCount];
+		makeLongCode(codes, lengths, true);
+
+		// 0, 10, 110, 110 and zeroes, the last ones with fewer bits left
+		// than the longest code
+		static const byte contents[] = { 0x5B, 0x00, 0x00 };
+
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+		Common::BitStream8MSB bs(ms);
+
+		Common::Huffman h(0, s_longCodeCount, codes, lengths);
+
+		TS_ASSERT_EQUALS(h.getSymbol(bs), 0u);
+		TS_ASSERT_EQUALS(h.getSymbol(bs), 1u);
+		TS_ASSERT_EQUALS(h.getSymbol(bs), 2u);
+		TS_ASSERT_EQUALS(h.getSymbol(bs), 2u);
+		for (uint32 i = 0; i < 15; i++)
+			TS_ASSERT_EQUALS(h.getSymbol(bs), 0u);
+
+		TS_ASSERT(bs.eos());
+	}
+};
@@ -0,0 +1,212 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/memstream.h"
+#include "common/unzip.h"
+#include "common/zlib.h"
+
+/**
+ * Builds a zip archive in memory, with one member per addMember() call.
+ */
+class ZipTestBuilder {
+public:
+	void addMember(const char *name, const byte *data, uint32 size, bool compress) {
+		Member member;
+		member.name = name;
+		member.offset = _archive.size();
+		member.size = size;
+		member.compressedSize = size;
+		member.method = 0;
+		member.crc = 0;
+
+		// Without zlib, the gzip writer leaves the data as it is. With it, the
+		// gzip output is the raw deflate data between a 10 byte header and a
+		// trailer holding the CRC and the size.
+		Common::MemoryWriteStreamDynamic *gzipData = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::YES);
+		Common::WriteStream *gzip = Common::wrapCompressedWriteStream(gzipData);
+		gzip->write(data, size);
+		gzip->finalize();
+
+		const byte *compressed = data;
+		if (gzip != gzipData) {
+			const byte *trailer = gzipData->getData() + gzipData->size() - 8;
+			member.crc = READ_LE_UINT32(trailer);
+			if (compress) {
+				member.method = 8;
+				member.compressedSize = gzipData->size() - 18;
+				compressed = gzipData->getData() + 10;
+			}
+		}
+
+		_archive.writeUint32LE(0x04034B50);
+		writeMemberInfo(member);
+		_archive.writeUint16LE(0);	// extra field length
+		_archive.writeString(member.name);
+		_archive.write(compressed, member.compressedSize);
+		delete gzip;
+
+		_members.push_back(member);
+	}
+
+	Common::SeekableReadStream *finish() {
+		const uint32 centralDirOffset = _archive.size();
+
+		for (uint i = 0; i < _members.size(); i++) {
+			_archive.writeUint32LE(0x02014B50);
+			_archive.writeUint16LE(20);	// version made by
+			writeMemberInfo(_members[i]);
+			_archive.writeUint16LE(0);	// extra field length
+			_archive.writeUint16LE(0);	// comment length
+			_archive.writeUint16LE(0);	// disk number
+			_archive.writeUint16LE(0);	// internal attributes
+			_archive.writeUint32LE(0);	// external attributes
+			_archive.writeUint32LE(_members[i].offset);
+			_archive.writeString(_members[i].name);
+		}
+
+		_archive.writeUint32LE(0x06054B50);
+		_archive.writeUint16LE(0);	// disk number
+		_archive.writeUint16LE(0);	// disk with the central directory
+		_archive.writeUint16LE(_members.size());
+		_archive.writeUint16LE(_members.size());
+		_archive.writeUint32LE(_archive.size() - centralDirOffset - 12);
+		_archive.writeUint32LE(centralDirOffset);
+		_archive.writeUint16LE(0);	// comment length
+
+		// The read stream takes over the written data
+		return new Common::MemoryReadStream(_archive.getData(), _archive.size(), DisposeAfterUse::YES);
+	}
+
+private:
+	struct Member {
+		Common::String name;
+		uint32 offset;
+		uint32 size;
+		uint32 compressedSize;
+		uint16 method;
+		uint32 crc;
+	};
+
+	void writeMemberInfo(const Member &member) {
+		_archive.writeUint16LE(20);	// version needed
+		_archive.writeUint16LE(0);	// flags
+		_archive.writeUint16LE(member.method);
+		_archive.writeUint32LE(0);	// time and date
+		_archive.writeUint32LE(member.crc);
+		_archive.writeUint32LE(member.compressedSize);
+		_archive.writeUint32LE(member.size);
+		_archive.writeUint16LE(member.name.size());
+	}
+
+	Common::MemoryWriteStreamDynamic _archive;
+	Common::Array<Member> _members;
+};
+
+class UnzipTestSuite : public CxxTest::TestSuite {
+	enum {
+		kBigSize = 600000
+	};
+
+	static byte bigByte(uint32 pos) {
+		return (pos * 7 + (pos >> 12)) & 0xFF;
+	}
+
+	Common::Archive *createArchive(bool compress) {
+		ZipTestBuilder builder;
+
+		byte *big = (byte *)malloc(kBigSize);
+		for (uint32 i = 0; i < kBigSize; i++)
+			big[i] = bigByte(i);
+		builder.addMember("big.bin", big, kBigSize, compress);
+		free(big);
+
+		const char *text = "Hello, zip world!";
+		builder.addMember("text.txt", (const byte *)text, strlen(text), false);
+
+		return Common::makeZipArchive(builder.finish());
+	}
+
+	void checkBigStream(Common::SeekableReadStream *stream) {
+		TS_ASSERT_EQUALS(stream->size(), kBigSize);
+
+		// Read all of it in odd sized pieces
+		byte buf[1000];
+		uint32 pos = 0;
+		bool ok = true;
+		while (pos < kBigSize) {
+			const uint32 len = stream->read(buf, 999);
+			for (uint32 i = 0; i < len; i++)
+				ok = ok && buf[i] == bigByte(pos + i);
+			pos += len;
+			if (!len)
+				break;
+		}
+		TS_ASSERT(ok);
+		TS_ASSERT_EQUALS(pos, (uint32)kBigSize);
+		TS_ASSERT(!stream->err());
+
+		stream->readByte();
+		TS_ASSERT(stream->eos());
+
+		// Seek backwards and forwards
+		static const int32 positions[] = { 0, 500000, 10, 300000, 299999, 262145, kBigSize - 1 };
+		for (int i = 0; i < ARRAYSIZE(positions); i++) {
+			TS_ASSERT(stream->seek(positions[i]));
+			TS_ASSERT_EQUALS(stream->pos(), positions[i]);
+			TS_ASSERT(!stream->eos());
+			TS_ASSERT_EQUALS(stream->readByte(), bigByte(positions[i]));
+		}
+
+		TS_ASSERT(stream->seek(-2, SEEK_END));
+		TS_ASSERT_EQUALS(stream->readByte(), bigByte(kBigSize - 2));
+		TS_ASSERT(!stream->err());
+	}
+
+public:
+	void test_stored() {
+		Common::Archive *archive = createArchive(false);
+		TS_ASSERT(archive);
+
+		Common::SeekableReadStream *stream = archive->createReadStreamForMember("BIG.BIN");
+		TS_ASSERT(stream);
+		checkBigStream(stream);
+
+		delete stream;
+		delete archive;
+	}
+
+	void test_deflated() {
+#ifdef USE_ZLIB
+		Common::Archive *archive = createArchive(true);
+		TS_ASSERT(archive);
+
+		Common::SeekableReadStream *stream = archive->createReadStreamForMember("big.bin");
+		TS_ASSERT(stream);
+		checkBigStream(stream);
+
+		delete stream;
+		delete archive;
+#endif
+	}
+
+	void test_members_outlive_archive() {
+		Common::Archive *archive = createArchive(true);
+
+		Common::SeekableReadStream *text = archive->createReadStreamForMember("text.txt");
+		Common::SeekableReadStream *big = archive->createReadStreamForMember("big.bin");
+		TS_ASSERT(!archive->createReadStreamForMember("missing"));
+		delete archive;
+
+		// Interleaved reads from members sharing the archive stream
+		TS_ASSERT_EQUALS(text->readLine(), "Hello, zip world!");
+		if (big) {
+			TS_ASSERT(big->seek(123456));
+			TS_ASSERT_EQUALS(big->readByte(), bigByte(123456));
+		}
+		TS_ASSERT(text->seek(7));
+		TS_ASSERT_EQUALS(text->readLine(), "zip world!");
+
+		delete text;
+		delete big;
+	}
+};
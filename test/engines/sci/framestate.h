@@ -0,0 +1,44 @@
+#include <cxxtest/TestSuite.h>
+
+#include "sci/graphics/helpers.h"
+
+class FrameStateTestSuite : public CxxTest::TestSuite {
+	static Common::Array<int16> makeState(int16 x) {
+		Common::Array<int16> state;
+		state.push_back(1);
+		state.push_back(x);
+		return state;
+	}
+
+public:
+	void test_unchanged_frame() {
+		Sci::FrameState shown;
+		const Common::Array<int16> state = makeState(10);
+
+		TS_ASSERT(!shown.isShown(state));
+		shown.setShown(state);
+		TS_ASSERT(shown.isShown(state));
+		TS_ASSERT(!shown.isShown(makeState(11)));
+	}
+
+	void test_empty_state() {
+		// Nothing is shown before the first frame, not even an empty one
+		Sci::FrameState shown;
+		TS_ASSERT(!shown.isShown(Common::Array<int16>()));
+	}
+
+	void test_movie_then_unchanged_frame() {
+		Sci::FrameState shown;
+		const Common::Array<int16> state = makeState(10);
+		shown.setShown(state);
+
+		// A movie drew to the screen, as playVideo() does before it calls
+		// GfxScreen::invalidateCopiedScreen(). The next frame has to be
+		// drawn, although the scripts changed nothing.
+		shown.invalidate();
+		TS_ASSERT(!shown.isShown(state));
+
+		shown.setShown(state);
+		TS_ASSERT(shown.isShown(state));
+	}
+};
@@ -0,0 +1,116 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "common/endian.h"
+#include "sci/engine/instruction_cache.h"
+
+class InstructionCacheTestSuite : public CxxTest::TestSuite {
+	Common::Array<byte> _code;
+	Common::Array<uint32> _offsets;
+
+	/**
+	 * Decodes instructions laid out like the SCI ones: opcode n has n % 4
+	 * parameters, which are bytes if the low bit of the extended opcode is
+	 * set and words otherwise. Opcode 0x7F with the low bit set is followed
+	 * by a null-terminated string, like op_file.
+	 */
+	static int decode(const byte *src, byte &extOpcode, int16 opparams[4]) {
+		int offset = 0;
+		extOpcode = src[offset++];
+		memset(opparams, 0, 4 * sizeof(int16));
+
+		if (extOpcode == 0xFF) {
+			while (src[offset++]) {}
+			return offset;
+		}
+
+		for (int i = 0; i < (extOpcode >> 1) % 4; i++) {
+			if (extOpcode & 1) {
+				opparams[i] = src[offset++];
+			} else {
+				opparams[i] = (int16)READ_LE_UINT16(src + offset);
+				offset += 2;
+			}
+		}
+		return offset;
+	}
+
+	void makeScript(int count) {
+		uint32 seed = 1;
+		for (int i = 0; i < count; i++) {
+			_offsets.push_back(_code.size());
+			seed = seed * 1103515245 + 12345;
+			byte extOpcode = (seed >> 16) & 0xFF;
+			if (i % 50 == 49)
+				extOpcode = 0xFF;
+			else if (extOpcode == 0xFF)
+				extOpcode = 0xFD;
+			_code.push_back(extOpcode);
+
+			if (extOpcode == 0xFF) {
+				for (int j = 0; j < 20; j++)
+					_code.push_back('a' + j);
+				_code.push_back(0);
+				continue;
+			}
+
+			const int length = ((extOpcode >> 1) % 4) * ((extOpcode & 1) ? 1 : 2);
+			for (int j = 0; j < length; j++) {
+				seed = seed * 1103515245 + 12345;
+				_code.push_back(seed >> 24);
+			}
+		}
+	}
+
+	/** Read every instruction through the cache and decode it directly */
+	bool readAll(Sci::InstructionCache &cache) {
+		for (uint i = 0; i < _offsets.size(); i++) {
+			byte cachedOpcode, decodedOpcode;
+			int16 cachedParams[4], decodedParams[4];
+			const int cachedLength = cache.read(_code.begin(), _code.size(), _offsets[i], decode, cachedOpcode, cachedParams);
+			const int decodedLength = decode(_code.begin() + _offsets[i], decodedOpcode, decodedParams);
+
+			if (cachedLength != decodedLength || cachedOpcode != decodedOpcode ||
+			    memcmp(cachedParams, decodedParams, sizeof(cachedParams)))
+				return false;
+		}
+		return true;
+	}
+
+public:
+	void setUp() {
+		makeScript(700);
+	}
+
+	void tearDown() {
+		_code.clear();
+		_offsets.clear();
+	}
+
+	void test_equivalence() {
+		// The first reads are decoded directly, the later ones are cached
+		Sci::InstructionCache cache;
+		for (int i = 0; i < 4; i++)
+			TS_ASSERT(readAll(cache));
+	}
+
+	void test_modified_code() {
+		Sci::InstructionCache cache;
+		for (int i = 0; i < 3; i++)
+			readAll(cache);
+
+		// Change the opcode, keeping the length, or the last parameter byte
+		// of some instructions
+		for (uint i = 0; i < _offsets.size(); i += 7) {
+			const uint32 offset = _offsets[i];
+			const uint32 end = (i + 1 < _offsets.size()) ? _offsets[i + 1] : _code.size();
+			if ((_code[offset] | 0x08) == 0xFF)
+				continue;
+			if (i % 2 || end - offset == 1)
+				_code[offset] ^= 0x08;
+			else
+				_code[end - 1] ^= 0x5A;
+		}
+		TS_ASSERT(readAll(cache));
+	}
+};
@@ -0,0 +1,121 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/colormasks.h"
+#include "graphics/scaler.h"
+#include "graphics/scaler/hqx.h"
+
+class HqxTestSuite : public CxxTest::TestSuite {
+	uint32 *_yuvTable;
+
+	/** Same as InitLUT() in graphics/scaler.cpp */
+	void initTable(const Graphics::PixelFormat &format) {
+		for (int color = 0; color < 65536; ++color) {
+			uint8 r, g, b;
+			format.colorToRGB(color, r, g, b);
+			const int Y = (r + g + b) >> 2;
+			const int u = 128 + ((r - b) >> 2);
+			const int v = 128 + ((-r + 2 * g - b) >> 3);
+			_yuvTable[color] = (Y << 16) | (u << 8) | v;
+		}
+	}
+
+	template<typename ColorMask>
+	void comparePatterns() {
+		uint32 seed = 1;
+		int w[9];
+
+		for (int i = 0; i < 200000; i++) {
+			// Mostly neighbours which are close to the center, so that all
+			// the thresholds are hit from both sides.
+			for (int j = 0; j < 9; j++) {
+				seed = seed * 1103515245 + 12345;
+				w[j] = (seed >> 16) & 0xFFFF;
+				if (j != 4 && (seed >> 13) & 3)
+					w[j] = (w[4] ^ ((seed >> 3) & 0x1CE7)) & 0xFFFF;
+			}
+
+			const int expected = hqxPatternScalar(_yuvTable, w[0], w[1], w[2], w[3], w[4], w[5], w[6], w[7], w[8]);
+			const int pattern = hqxPattern<ColorMask>(_yuvTable, w[0], w[1], w[2], w[3], w[4], w[5], w[6], w[7], w[8]);
+			if (pattern != expected) {
+				TS_ASSERT_EQUALS(pattern, expected);
+				break;
+			}
+		}
+	}
+
+#ifdef USE_HQ_SCALERS
+	/**
+	 * Scale an image in one pass and in bands, split the way the SDL
+	 * backend splits it between its scaler threads, and compare both.
+	 */
+	void compareBands(ScalerProc *proc, int scale) {
+		const int width = 64, height = 70, bands = 4;
+		const int srcPitch = (width + 2) * 2, dstPitch = width * scale * 2;
+
+		// The image has a border of one pixel, as the backend's has
+		uint16 *src = new uint16[(width + 2) * (height + 2)];
+		uint32 seed = 1;
+		for (int i = 0; i < (width + 2) * (height + 2); i++) {
+			seed = seed * 1103515245 + 12345;
+			src[i] = ((seed >> 16) & 3) * 0x2945;
+		}
+
+		const uint8 *srcStart = (const uint8 *)src + srcPitch + 2;
+		uint8 *single = new uint8[dstPitch * height * scale];
+		uint8 *banded = new uint8[dstPitch * height * scale];
+
+		proc(srcStart, srcPitch, single, dstPitch, width, height);
+		for (int i = 0; i < bands; i++) {
+			const int top = (height * i / bands) & ~1;
+			const int bottom = (i == bands - 1) ? height : (height * (i + 1) / bands) & ~1;
+			proc(srcStart + top * srcPitch, srcPitch, banded + top * scale * dstPitch, dstPitch, width, bottom - top);
+		}
+
+		TS_ASSERT(!memcmp(single, banded, dstPitch * height * scale));
+
+		delete[] src;
+		delete[] single;
+		delete[] banded;
+	}
+#endif
+
+public:
+	void setUp() {
+		_yuvTable = new uint32[65536];
+	}
+
+	void tearDown() {
+		delete[] _yuvTable;
+	}
+
+	void test_pattern_565() {
+		initTable(Graphics::createPixelFormat<565>());
+		comparePatterns<Graphics::ColorMasks<565> >();
+	}
+
+	void test_pattern_555() {
+		initTable(Graphics::createPixelFormat<555>());
+		comparePatterns<Graphics::ColorMasks<555> >();
+	}
+
+#ifdef USE_HQ_SCALERS
+	void test_bands() {
+		InitScalers(565);
+		compareBands(HQ2x, 2);
+		compareBands(HQ3x, 3);
+		DestroyScalers();
+	}
+#endif
+
+	void test_pattern_bits() {
+		initTable(Graphics::createPixelFormat<565>());
+
+		// Black center, white neighbours where the bit is set
+		for (int bits = 0; bits < 256; bits += 37) {
+			int w[8];
+			for (int j = 0; j < 8; j++)
+				w[j] = (bits & (1 << j)) ? 0xFFFF : 0;
+			TS_ASSERT_EQUALS(hqxPattern<Graphics::ColorMasks<565> >(_yuvTable, w[0], w[1], w[2], w[3], 0, w[4], w[5], w[6], w[7]), bits);
+		}
+	}
+};
@@ -0,0 +1,128 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/util.h"
+#include "graphics/pixelformat.h"
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+
+class YUVToRGBTestSuite : public CxxTest::TestSuite {
+	/** The color of a pixel, computed the way the lookup tables are built */
+	static uint32 toColor(const Graphics::PixelFormat &format, Graphics::YUVToRGBManager::LuminanceScale scale, byte y, byte u, byte v) {
+		const int16 cr = v - 128, cb = u - 128;
+		const int r = y + (int16)((0.419 / 0.299) * cr);
+		const int g = y + (int16)(-(0.299 / 0.419) * cr) + (int16)(-(0.114 / 0.331) * cb);
+		const int b = y + (int16)((0.587 / 0.331) * cb);
+
+		return format.RGBToColor(toChannel(scale, r), toChannel(scale, g), toChannel(scale, b));
+	}
+
+	static byte toChannel(Graphics::YUVToRGBManager::LuminanceScale scale, int value) {
+		if (scale == Graphics::YUVToRGBManager::kScaleFull)
+			return CLIP(value, 0, 255);
+
+		return (CLIP(value, 16, 235) - 16) * 255 / 219;
+	}
+
+	/** Check the color of a pixel */
+	static bool checkPixel(const Graphics::Surface &surface, int x, int y, uint32 expected) {
+		uint32 color;
+		if (surface.format.bytesPerPixel == 2)
+			color = *(const uint16 *)surface.getBasePtr(x, y);
+		else
+			color = *(const uint32 *)surface.getBasePtr(x, y);
+
+		TS_ASSERT_EQUALS(color, expected);
+		return color == expected;
+	}
+
+	/**
+	 * Convert images with every pair of chroma values, and compare each
+	 * pixel. The width is not a multiple of 16, and the pitch of the
+	 * surface larger than the width, so the vector code and the tables
+	 * both convert parts of every row.
+	 */
+	void compareFormat(const Graphics::PixelFormat &format, Graphics::YUVToRGBManager::LuminanceScale scale) {
+		const int width = 264, height = 256 * 2, pitch = 272;
+
+		byte *ySrc = new byte[pitch * height];
+		byte *uSrc = new byte[pitch * height];
+		byte *vSrc = new byte[pitch * height];
+
+		uint32 seed = 1;
+		for (int i = 0; i < pitch * height; i++) {
+			seed = seed * 1103515245 + 12345;
+			ySrc[i] = seed >> 16;
+		}
+
+		Graphics::Surface surface;
+		surface.create(pitch, height, format);
+		surface.w = width;
+
+		// 444, u and v from the position
+		for (int y = 0; y < height; y++) {
+			for (int x = 0; x < width; x++) {
+				uSrc[y * pitch + x] = x;
+				vSrc[y * pitch + x] = y;
+			}
+		}
+
+		YUVToRGBMan.convert444(&surface, scale, ySrc, uSrc, vSrc, width, height, pitch, pitch);
+
+		bool same = true;
+		for (int y = 0; y < height && same; y++) {
+			for (int x = 0; x < width && same; x++) {
+				const int i = y * pitch + x;
+				same = checkPixel(surface, x, y, toColor(format, scale, ySrc[i], uSrc[i], vSrc[i]));
+			}
+		}
+
+		// 420, u and v from the position of the 2x2 blocks
+		for (int y = 0; y < height / 2; y++) {
+			for (int x = 0; x < width / 2; x++) {
+				uSrc[y * pitch + x] = x * 2;
+				vSrc[y * pitch + x] = y;
+			}
+		}
+
+		YUVToRGBMan.convert420(&surface, scale, ySrc, uSrc, vSrc, width, height, pitch, pitch);
+
+		for (int y = 0; y < height && same; y++) {
+			for (int x = 0; x < width && same; x++) {
+				const int i = (y / 2) * pitch + (x / 2);
+				same = checkPixel(surface, x, y, toColor(format, scale, ySrc[y * pitch + x], uSrc[i], vSrc[i]));
+			}
+		}
+
+		// Nothing may be written past the width
+		for (int y = 0; y < height && same; y++)
+			for (int x = width; x < pitch && same; x++)
+				same = checkPixel(surface, x, y, 0);
+
+		surface.free();
+
+		delete[] ySrc;
+		delete[] uSrc;
+		delete[] vSrc;
+	}
+
+public:
+	void test_convert_565() {
+		compareFormat(Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0), Graphics::YUVToRGBManager::kScaleFull);
+		compareFormat(Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0), Graphics::YUVToRGBManager::kScaleITU);
+	}
+
+	void test_convert_1555() {
+		compareFormat(Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15), Graphics::YUVToRGBManager::kScaleFull);
+		compareFormat(Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15), Graphics::YUVToRGBManager::kScaleITU);
+	}
+
+	void test_convert_8888() {
+		compareFormat(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0), Graphics::YUVToRGBManager::kScaleFull);
+		compareFormat(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0), Graphics::YUVToRGBManager::kScaleITU);
+	}
+
+	void test_convert_888() {
+		compareFormat(Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0), Graphics::YUVToRGBManager::kScaleFull);
+		compareFormat(Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0), Graphics::YUVToRGBManager::kScaleITU);
+	}
+};
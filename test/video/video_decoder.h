@@ -0,0 +1,162 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/surface.h"
+#include "video/video_decoder.h"
+
+#include "test/system.h"
+
+/**
+ * A video of 10 frames at 10 fps, one pixel large. The pixel holds the
+ * number of the frame.
+ */
+class TestVideoDecoder : public Video::VideoDecoder {
+public:
+	bool loadStream(Common::SeekableReadStream *stream) { return false; }
+
+	void load() {
+		addTrack(new TestVideoTrack());
+	}
+
+private:
+	class TestVideoTrack : public FixedRateVideoTrack {
+	public:
+		TestVideoTrack() : _curFrame(-1), _reversed(false) {
+			_surface.create(1, 1, Graphics::PixelFormat::createFormatCLUT8());
+		}
+
+		~TestVideoTrack() {
+			_surface.free();
+		}
+
+		bool isSeekable() const { return true; }
+		bool seek(const Audio::Timestamp &time) {
+			_curFrame = getFrameAtTime(time) - 1;
+			return true;
+		}
+
+		uint16 getWidth() const { return 1; }
+		uint16 getHeight() const { return 1; }
+		Graphics::PixelFormat getPixelFormat() const { return _surface.format; }
+		int getCurFrame() const { return _curFrame; }
+		int getFrameCount() const { return 10; }
+
+		const Graphics::Surface *decodeNextFrame() {
+			_curFrame += _reversed ? -1 : 1;
+			*(byte *)_surface.pixels = _curFrame;
+			return &_surface;
+		}
+
+		bool setReverse(bool reverse) {
+			_reversed = reverse;
+			return true;
+		}
+
+		bool isReversed() const { return _reversed; }
+
+	protected:
+		Common::Rational getFrameRate() const { return 10; }
+
+	private:
+		Graphics::Surface _surface;
+		int _curFrame;
+		bool _reversed;
+	};
+};
+
+class VideoDecoderTestSuite : public CxxTest::TestSuite {
+	TestSystem *_system;
+	OSystem *_oldSystem;
+	TestVideoDecoder *_decoder;
+
+	static int pixel(const Graphics::Surface *frame) {
+		return frame ? *(const byte *)frame->pixels : -1;
+	}
+
+public:
+	void setUp() {
+		_oldSystem = g_system;
+		_system = new TestSystem();
+		g_system = _system;
+		_system->setMillis(0);
+
+		_decoder = new TestVideoDecoder();
+		_decoder->load();
+		_decoder->setDecodeAhead(3);
+		_decoder->start();
+	}
+
+	void tearDown() {
+		delete _decoder;
+		g_system = _oldSystem;
+		delete _system;
+	}
+
+	void test_queue_order() {
+		TS_ASSERT(_decoder->needsUpdate());
+		const Graphics::Surface *first = _decoder->decodeNextFrame();
+		TS_ASSERT_EQUALS(pixel(first), 0);
+
+		// Fill the queue while waiting for the next frame
+		_system->setMillis(10);
+		for (int i = 0; i < 5; i++)
+			_decoder->pump();
+
+		// The frame returned last is left intact, and the position is still
+		// the one of the frames returned
+		TS_ASSERT_EQUALS(pixel(first), 0);
+		TS_ASSERT_EQUALS(_decoder->getCurFrame(), 0);
+		TS_ASSERT(!_decoder->needsUpdate());
+		TS_ASSERT_EQUALS(_decoder->getTimeToNextFrame(), 90u);
+
+		for (int i = 1; i < 10; i++) {
+			_system->setMillis(i * 100);
+			TS_ASSERT(_decoder->needsUpdate());
+			TS_ASSERT_EQUALS(pixel(_decoder->decodeNextFrame()), i);
+			TS_ASSERT_EQUALS(_decoder->getCurFrame(), i);
+			_decoder->pump();
+		}
+
+		TS_ASSERT(_decoder->endOfVideo());
+	}
+
+	void test_no_decode_when_due() {
+		_decoder->decodeNextFrame();
+
+		// No time is left before the next frame
+		_system->setMillis(100);
+		_decoder->pump();
+		TS_ASSERT_EQUALS(_decoder->getCurFrame(), 0);
+		TS_ASSERT(_decoder->setReverse(true));
+	}
+
+	void test_flush() {
+		_decoder->decodeNextFrame();
+		_system->setMillis(10);
+		_decoder->pump();
+		_decoder->pump();
+
+		TS_ASSERT(_decoder->rewind());
+		TS_ASSERT_EQUALS(_decoder->getCurFrame(), -1);
+		TS_ASSERT_EQUALS(pixel(_decoder->decodeNextFrame()), 0);
+
+		_decoder->pump();
+		_decoder->pump();
+
+		TS_ASSERT(_decoder->seek(Audio::Timestamp(500, 1000)));
+		TS_ASSERT_EQUALS(_decoder->getCurFrame(), 4);
+		TS_ASSERT_EQUALS(pixel(_decoder->decodeNextFrame()), 5);
+	}
+
+	void test_reverse() {
+		_decoder->decodeNextFrame();
+		_system->setMillis(10);
+		_decoder->pump();
+
+		// The tracks are past the frame decoded ahead
+		TS_ASSERT(!_decoder->setReverse(true));
+
+		_system->setMillis(100);
+		TS_ASSERT_EQUALS(pixel(_decoder->decodeNextFrame()), 1);
+		TS_ASSERT(_decoder->setReverse(true));
+	}
+};
@@ -31,7 +31,6 @@
 #include "common/textconsole.h"
 #include "common/math.h"
 #include "common/stream.h"
-#include "common/substream.h"
 #include "common/file.h"
 #include "common/str.h"
 #include "common/bitstream.h"
@@ -59,8 +58,252 @@ static const uint16 kAudioFlagStereo = 0x2000;
 // Number of bits used to store first DC value in bundle
 static const uint32 kDCStartBits = 11;
 
+// SSE2 is always available on x86-64, and NEON on AArch64, so the vector
+// code is chosen at compile time.
+#if defined(__SSE2__)
+#define BINK_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define BINK_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(BINK_SSE2) || defined(BINK_NEON)
+#define BINK_SIMD
+#endif
+
+#define A1  2896 /* (1/sqrt(2))<<12 */
+#define A2  2217
+#define A3  3784
+#define A4 -5352
+
 namespace Video {
 
+#ifdef BINK_SIMD
+
+// The vector code keeps a row of 8 coefficients or pixels in a vector of
+// 16 bit lanes. The IDCT computes in 32 bit lanes, so it computes exactly
+// what IDCT_TRANSFORM computes, and narrows the results the way the scalar
+// code stores them: truncated to 16 bits for the coefficients, and to 8 bits
+// for the pixels. All its multiplications are of the 16 bit inputs, as sums
+// of two products, which SSE2 and NEON compute without a 32 bit multiply.
+
+#ifdef BINK_SSE2
+
+typedef __m128i BinkVec16;
+typedef __m128i BinkVec32;
+
+static inline BinkVec16 vecLoad16(const int16 *src) { return _mm_loadu_si128((const __m128i *)src); }
+static inline void vecStore16(int16 *dst, BinkVec16 x) { _mm_storeu_si128((__m128i *)dst, x); }
+
+static inline BinkVec32 vecAdd(BinkVec32 a, BinkVec32 b) { return _mm_add_epi32(a, b); }
+static inline BinkVec32 vecSub(BinkVec32 a, BinkVec32 b) { return _mm_sub_epi32(a, b); }
+static inline BinkVec32 vecShr11(BinkVec32 a) { return _mm_srai_epi32(a, 11); }
+static inline BinkVec32 vecRound8(BinkVec32 a) { return _mm_srai_epi32(_mm_add_epi32(a, _mm_set1_epi32(0x7F)), 8); }
+
+/** cx * x + cy * y, for the low or the high 4 lanes. */
+template<bool isHigh>
+static inline BinkVec32 vecMulAdd(BinkVec16 x, BinkVec16 y, int16 cx, int16 cy) {
+	const __m128i pairs = isHigh ? _mm_unpackhi_epi16(x, y) : _mm_unpacklo_epi16(x, y);
+	return _mm_madd_epi16(pairs, _mm_set_epi16(cy, cx, cy, cx, cy, cx, cy, cx));
+}
+
+static inline BinkVec16 vecNarrow(BinkVec32 lo, BinkVec32 hi) {
+	// Sign extend the low 16 bits first, so the saturation does nothing
+	lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+	hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+	return _mm_packs_epi32(lo, hi);
+}
+
+static inline void vecTranspose(BinkVec16 *r) {
+	const __m128i a0 = _mm_unpacklo_epi16(r[0], r[1]);
+	const __m128i a1 = _mm_unpackhi_epi16(r[0], r[1]);
+	const __m128i a2 = _mm_unpacklo_epi16(r[2], r[3]);
+	const __m128i a3 = _mm_unpackhi_epi16(r[2], r[3]);
+	const __m128i a4 = _mm_unpacklo_epi16(r[4], r[5]);
+	const __m128i a5 = _mm_unpackhi_epi16(r[4], r[5]);
+	const __m128i a6 = _mm_unpacklo_epi16(r[6], r[7]);
+	const __m128i a7 = _mm_unpackhi_epi16(r[6], r[7]);
+
+	const __m128i b0 = _mm_unpacklo_epi32(a0, a2);
+	const __m128i b1 = _mm_unpackhi_epi32(a0, a2);
+	const __m128i b2 = _mm_unpacklo_epi32(a1, a3);
+	const __m128i b3 = _mm_unpackhi_epi32(a1, a3);
+	const __m128i b4 = _mm_unpacklo_epi32(a4, a6);
+	const __m128i b5 = _mm_unpackhi_epi32(a4, a6);
+	const __m128i b6 = _mm_unpacklo_epi32(a5, a7);
+	const __m128i b7 = _mm_unpackhi_epi32(a5, a7);
+
+	r[0] = _mm_unpacklo_epi64(b0, b4);
+	r[1] = _mm_unpackhi_epi64(b0, b4);
+	r[2] = _mm_unpacklo_epi64(b1, b5);
+	r[3] = _mm_unpackhi_epi64(b1, b5);
+	r[4] = _mm_unpacklo_epi64(b2, b6);
+	r[5] = _mm_unpackhi_epi64(b2, b6);
+	r[6] = _mm_unpacklo_epi64(b3, b7);
+	r[7] = _mm_unpackhi_epi64(b3, b7);
+}
+
+/** The low bytes of the lanes, in the low half of the vector. */
+static inline __m128i vecToBytes(BinkVec16 x) {
+	return _mm_packus_epi16(_mm_and_si128(x, _mm_set1_epi16(0xFF)), _mm_setzero_si128());
+}
+
+/** Store the low bytes of the lanes. */
+static inline void vecPutBytes(byte *dst, BinkVec16 x) {
+	_mm_storel_epi64((__m128i *)dst, vecToBytes(x));
+}
+
+/** Add the low bytes of the lanes to the pixels, wrapping around. */
+static inline void vecAddBytes(byte *dst, BinkVec16 x) {
+	_mm_storel_epi64((__m128i *)dst, _mm_add_epi8(_mm_loadl_epi64((const __m128i *)dst), vecToBytes(x)));
+}
+
+/** Store the low bytes of the lanes, doubled in size, on two rows. */
+static inline void vecPutBytesScaled(byte *dst, uint32 pitch, BinkVec16 x) {
+	const __m128i bytes = vecToBytes(x);
+	const __m128i doubled = _mm_unpacklo_epi8(bytes, bytes);
+	_mm_storeu_si128((__m128i *)dst, doubled);
+	_mm_storeu_si128((__m128i *)(dst + pitch), doubled);
+}
+
+#endif // BINK_SSE2
+
+#ifdef BINK_NEON
+
+typedef int16x8_t BinkVec16;
+typedef int32x4_t BinkVec32;
+
+static inline BinkVec16 vecLoad16(const int16 *src) { return vld1q_s16(src); }
+static inline void vecStore16(int16 *dst, BinkVec16 x) { vst1q_s16(dst, x); }
+
+static inline BinkVec32 vecAdd(BinkVec32 a, BinkVec32 b) { return vaddq_s32(a, b); }
+static inline BinkVec32 vecSub(BinkVec32 a, BinkVec32 b) { return vsubq_s32(a, b); }
+static inline BinkVec32 vecShr11(BinkVec32 a) { return vshrq_n_s32(a, 11); }
+static inline BinkVec32 vecRound8(BinkVec32 a) { return vshrq_n_s32(vaddq_s32(a, vdupq_n_s32(0x7F)), 8); }
+
+/** cx * x + cy * y, for the low or the high 4 lanes. */
+template<bool isHigh>
+static inline BinkVec32 vecMulAdd(BinkVec16 x, BinkVec16 y, int16 cx, int16 cy) {
+	const int16x4_t xHalf = isHigh ? vget_high_s16(x) : vget_low_s16(x);
+	const int16x4_t yHalf = isHigh ? vget_high_s16(y) : vget_low_s16(y);
+	return vmlal_n_s16(vmull_n_s16(xHalf, cx), yHalf, cy);
+}
+
+static inline BinkVec16 vecNarrow(BinkVec32 lo, BinkVec32 hi) {
+	return vcombine_s16(vmovn_s32(lo), vmovn_s32(hi));
+}
+
+static inline void vecTranspose(BinkVec16 *r) {
+	const int16x8x2_t a0 = vtrnq_s16(r[0], r[1]);
+	const int16x8x2_t a1 = vtrnq_s16(r[2], r[3]);
+	const int16x8x2_t a2 = vtrnq_s16(r[4], r[5]);
+	const int16x8x2_t a3 = vtrnq_s16(r[6], r[7]);
+
+	const int32x4x2_t b0 = vtrnq_s32(vreinterpretq_s32_s16(a0.val[0]), vreinterpretq_s32_s16(a1.val[0]));
+	const int32x4x2_t b1 = vtrnq_s32(vreinterpretq_s32_s16(a0.val[1]), vreinterpretq_s32_s16(a1.val[1]));
+	const int32x4x2_t b2 = vtrnq_s32(vreinterpretq_s32_s16(a2.val[0]), vreinterpretq_s32_s16(a3.val[0]));
+	const int32x4x2_t b3 = vtrnq_s32(vreinterpretq_s32_s16(a2.val[1]), vreinterpretq_s32_s16(a3.val[1]));
+
+	r[0] = vreinterpretq_s16_s32(vcombine_s32(vget_low_s32(b0.val[0]), vget_low_s32(b2.val[0])));
+	r[1] = vreinterpretq_s16_s32(vcombine_s32(vget_low_s32(b1.val[0]), vget_low_s32(b3.val[0])));
+	r[2] = vreinterpretq_s16_s32(vcombine_s32(vget_low_s32(b0.val[1]), vget_low_s32(b2.val[1])));
+	r[3] = vreinterpretq_s16_s32(vcombine_s32(vget_low_s32(b1.val[1]), vget_low_s32(b3.val[1])));
+	r[4] = vreinterpretq_s16_s32(vcombine_s32(vget_high_s32(b0.val[0]), vget_high_s32(b2.val[0])));
+	r[5] = vreinterpretq_s16_s32(vcombine_s32(vget_high_s32(b1.val[0]), vget_high_s32(b3.val[0])));
+	r[6] = vreinterpretq_s16_s32(vcombine_s32(vget_high_s32(b0.val[1]), vget_high_s32(b2.val[1])));
+	r[7] = vreinterpretq_s16_s32(vcombine_s32(vget_high_s32(b1.val[1]), vget_high_s32(b3.val[1])));
+}
+
+/** The low bytes of the lanes. */
+static inline uint8x8_t vecToBytes(BinkVec16 x) {
+	return vmovn_u16(vreinterpretq_u16_s16(x));
+}
+
+/** Store the low bytes of the lanes. */
+static inline void vecPutBytes(byte *dst, BinkVec16 x) {
+	vst1_u8(dst, vecToBytes(x));
+}
+
+/** Add the low bytes of the lanes to the pixels, wrapping around. */
+static inline void vecAddBytes(byte *dst, BinkVec16 x) {
+	vst1_u8(dst, vadd_u8(vld1_u8(dst), vecToBytes(x)));
+}
+
+/** Store the low bytes of the lanes, doubled in size, on two rows. */
+static inline void vecPutBytesScaled(byte *dst, uint32 pitch, BinkVec16 x) {
+	const uint8x8_t bytes = vecToBytes(x);
+	const uint8x8x2_t doubled = vzip_u8(bytes, bytes);
+	const uint8x16_t row = vcombine_u8(doubled.val[0], doubled.val[1]);
+	vst1q_u8(dst, row);
+	vst1q_u8(dst + pitch, row);
+}
+
+#endif // BINK_NEON
+
+/**
+ * IDCT_TRANSFORM on the low or the high 4 columns of s. The products of the
+ * sums and differences of the inputs are expanded into products of the
+ * inputs.
+ */
+template<bool isRow, bool isHigh>
+static inline void vecIDCTTransform(const BinkVec16 *s, BinkVec32 *d) {
+	const BinkVec32 a0 = vecMulAdd<isHigh>(s[0], s[4], 1,  1);
+	const BinkVec32 a1 = vecMulAdd<isHigh>(s[0], s[4], 1, -1);
+	const BinkVec32 a2 = vecMulAdd<isHigh>(s[2], s[6], 1,  1);
+	const BinkVec32 a3 = vecShr11(vecMulAdd<isHigh>(s[2], s[6], A1, -A1));
+	const BinkVec32 a4 = vecMulAdd<isHigh>(s[5], s[3], 1,  1);
+	const BinkVec32 a6 = vecMulAdd<isHigh>(s[1], s[7], 1,  1);
+	const BinkVec32 b0 = vecAdd(a4, a6);
+	const BinkVec32 b1 = vecShr11(vecAdd(vecMulAdd<isHigh>(s[5], s[3], A3, -A3), vecMulAdd<isHigh>(s[1], s[7], A3, -A3)));
+	const BinkVec32 b2 = vecAdd(vecSub(vecShr11(vecMulAdd<isHigh>(s[5], s[3], A4, -A4)), b0), b1);
+	const BinkVec32 b3 = vecSub(vecShr11(vecAdd(vecMulAdd<isHigh>(s[1], s[7], A1, A1), vecMulAdd<isHigh>(s[5], s[3], -A1, -A1))), b2);
+	const BinkVec32 b4 = vecSub(vecAdd(vecShr11(vecMulAdd<isHigh>(s[1], s[7], A2, -A2)), b3), b1);
+
+	d[0] = vecAdd(vecAdd(a0, a2), b0);
+	d[1] = vecAdd(vecSub(vecAdd(a1, a3), a2), b2);
+	d[2] = vecAdd(vecAdd(vecSub(a1, a3), a2), b3);
+	d[3] = vecSub(vecSub(a0, a2), b4);
+	d[4] = vecAdd(vecSub(a0, a2), b4);
+	d[5] = vecSub(vecAdd(vecSub(a1, a3), a2), b3);
+	d[6] = vecSub(vecSub(vecAdd(a1, a3), a2), b2);
+	d[7] = vecSub(vecAdd(a0, a2), b0);
+
+	if (isRow)
+		for (int i = 0; i < 8; i++)
+			d[i] = vecRound8(d[i]);
+}
+
+/** Transform the block, and return its rows. */
+static inline void vecIDCT(const int16 *block, BinkVec16 *rows) {
+	BinkVec16 src[8];
+	BinkVec32 lo[8], hi[8];
+
+	for (int i = 0; i < 8; i++)
+		src[i] = vecLoad16(block + 8 * i);
+
+	// The columns
+	vecIDCTTransform<false, false>(src, lo);
+	vecIDCTTransform<false, true >(src, hi);
+
+	for (int i = 0; i < 8; i++)
+		src[i] = vecNarrow(lo[i], hi[i]);
+
+	// And the rows, as the columns of the transposed block
+	vecTranspose(src);
+
+	vecIDCTTransform<true, false>(src, lo);
+	vecIDCTTransform<true, true >(src, hi);
+
+	for (int i = 0; i < 8; i++)
+		rows[i] = vecNarrow(lo[i], hi[i]);
+
+	vecTranspose(rows);
+}
+
+#endif // BINK_SIMD
+
+
 BinkDecoder::BinkDecoder() {
 	_bink = 0;
 }
@@ -172,24 +415,32 @@ void BinkDecoder::readNextPacket() {
 	for (uint32 i = 0; i < _audioTracks.size(); i++) {
 		AudioInfo &audio = _audioTracks[i];
 
+		if (frameSize < 4)
+			error("Audio packet too big for the frame");
+
 		uint32 audioPacketLength = _bink->readUint32LE();
 
 		frameSize -= 4;
 
-		if (frameSize < audioPacketLength)
+		if (audioPacketLength > frameSize)
 			error("Audio packet too big for the frame");
 
 		if (audioPacketLength >= 4) {
 			// Get our track - audio index plus one as the first track is video
 			BinkAudioTrack *audioTrack = (BinkAudioTrack *)getTrack(i + 1);
-			uint32 audioPacketStart = _bink->pos();
 			uint32 audioPacketEnd   = _bink->pos() + audioPacketLength;
 
 			//                  Number of samples in bytes
 			audio.sampleCount = _bink->readUint32LE() / (2 * audio.channels);
 
-			audio.bits = new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink,
-					audioPacketStart + 4, audioPacketEnd), true);
+			// The bits are read straight from memory
+			byte *audioPacket = (byte *)malloc(audioPacketLength - 4);
+			if (_bink->read(audioPacket, audioPacketLength - 4) != audioPacketLength - 4) {
+				free(audioPacket);
+				error("Bink audio packet truncated");
+			}
+
+			audio.bits = new Common::BitStream32LELSB(audioPacket, audioPacketLength - 4, DisposeAfterUse::YES);
 
 			audioTrack->decodePacket();
 
@@ -202,11 +453,13 @@ void BinkDecoder::readNextPacket() {
 		}
 	}
 
-	uint32 videoPacketStart = _bink->pos();
-	uint32 videoPacketEnd   = _bink->pos() + frameSize;
+	byte *videoPacket = (byte *)malloc(frameSize);
+	if (_bink->read(videoPacket, frameSize) != frameSize) {
+		free(videoPacket);
+		error("Bink video packet truncated");
+	}
 
-	frame.bits = new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink,
-			videoPacketStart, videoPacketEnd), true);
+	frame.bits = new Common::BitStream32LELSB(videoPacket, frameSize, DisposeAfterUse::YES);
 
 	videoTrack->decodePacket(frame);
 
@@ -277,6 +530,7 @@ BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, const G
 	// surface.
 	_surface.h = height;
 	_surface.w = width;
+	_surfaceConverted = false;
 
 	// Give the planes a bit extra space
 	width  = _surface.w + 32;
@@ -321,6 +575,36 @@ BinkDecoder::BinkVideoTrack::~BinkVideoTrack() {
 	_surface.free();
 }
 
+const Graphics::Surface *BinkDecoder::BinkVideoTrack::decodeNextFrame() {
+	if (!_surfaceConverted) {
+		convertFrame(_surface);
+		_surfaceConverted = true;
+	}
+
+	return &_surface;
+}
+
+bool BinkDecoder::BinkVideoTrack::decodeNextFrameTo(Graphics::Surface &dst) {
+	// Odd-sized videos are converted with an extra row or column, which
+	// only our surface has room for
+	if (_surfaceWidth != _surface.w || _surfaceHeight != _surface.h)
+		return VideoTrack::decodeNextFrameTo(dst);
+
+	assert(dst.w >= _surface.w && dst.h >= _surface.h && dst.format == _surface.format);
+	convertFrame(dst);
+	return true;
+}
+
+void BinkDecoder::BinkVideoTrack::convertFrame(Graphics::Surface &dst) {
+	// Convert the YUV data we have to our format
+	// We're ignoring alpha for now
+	// The width used here is the surface-width, and not the video-width
+	// to allow for odd-sized videos.
+	assert(_oldPlanes[0] && _oldPlanes[1] && _oldPlanes[2]);
+	YUVToRGBMan.convert420(&dst, Graphics::YUVToRGBManager::kScaleITU, _oldPlanes[0], _oldPlanes[1], _oldPlanes[2],
+			_surfaceWidth, _surfaceHeight, _surfaceWidth, _surfaceWidth >> 1);
+}
+
 void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 	assert(frame.bits);
 
@@ -343,18 +627,12 @@ void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 			break;
 	}
 
-	// Convert the YUV data we have to our format
-	// We're ignoring alpha for now
-	// The width used here is the surface-width, and not the video-width
-	// to allow for odd-sized videos.
-	assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2]);
-	YUVToRGBMan.convert420(&_surface, Graphics::YUVToRGBManager::kScaleITU, _curPlanes[0], _curPlanes[1], _curPlanes[2],
-			_surfaceWidth, _surfaceHeight, _surfaceWidth, _surfaceWidth >> 1);
-
-	// And swap the planes with the reference planes
+	// Swap the planes with the reference planes, the frame is converted
+	// to RGB from there when it is returned
 	for (int i = 0; i < 4; i++)
 		SWAP(_curPlanes[i], _oldPlanes[i]);
 
+	_surfaceConverted = false;
 	_curFrame++;
 }
 
@@ -675,6 +953,14 @@ void BinkDecoder::BinkVideoTrack::blockScaledIntra(DecodeContext &ctx) {
 
 	readDCTCoeffs(*ctx.video, block, true);
 
+#ifdef BINK_SIMD
+	BinkVec16 rows[8];
+	vecIDCT(block, rows);
+
+	byte *dest = ctx.dest;
+	for (int j = 0; j < 8; j++, dest += ctx.pitch << 1)
+		vecPutBytesScaled(dest, ctx.pitch, rows[j]);
+#else
 	IDCT(block);
 
 	int16 *src   = block;
@@ -686,6 +972,7 @@ void BinkDecoder::BinkVideoTrack::blockScaledIntra(DecodeContext &ctx) {
 			dest1[0] = dest1[1] = dest2[0] = dest2[1] = src[i];
 
 	}
+#endif
 }
 
 void BinkDecoder::BinkVideoTrack::blockScaledFill(DecodeContext &ctx) {
@@ -807,9 +1094,14 @@ void BinkDecoder::BinkVideoTrack::blockResidue(DecodeContext &ctx) {
 
 	byte  *dst = ctx.dest;
 	int16 *src = block;
+#ifdef BINK_SIMD
+	for (int i = 0; i < 8; i++, dst += ctx.pitch, src += 8)
+		vecAddBytes(dst, vecLoad16(src));
+#else
 	for (int i = 0; i < 8; i++, dst += ctx.pitch, src += 8)
 		for (int j = 0; j < 8; j++)
 			dst[j] += src[j];
+#endif
 }
 
 void BinkDecoder::BinkVideoTrack::blockIntra(DecodeContext &ctx) {
@@ -1259,11 +1551,6 @@ void BinkDecoder::BinkVideoTrack::readResidue(VideoFrame &video, int16 *block, i
 	}
 }
 
-#define A1  2896 /* (1/sqrt(2))<<12 */
-#define A2  2217
-#define A3  3784
-#define A4 -5352
-
 #define IDCT_TRANSFORM(dest,s0,s1,s2,s3,s4,s5,s6,s7,d0,d1,d2,d3,d4,d5,d6,d7,munge,src) {\
     const int a0 = (src)[s0] + (src)[s4]; \
     const int a1 = (src)[s0] - (src)[s4]; \
@@ -1311,6 +1598,13 @@ static inline void IDCTCol(int16 *dest, const int16 *src) {
 }
 
 void BinkDecoder::BinkVideoTrack::IDCT(int16 *block) {
+#ifdef BINK_SIMD
+	BinkVec16 rows[8];
+	vecIDCT(block, rows);
+
+	for (int i = 0; i < 8; i++)
+		vecStore16(block + 8 * i, rows[i]);
+#else
 	int i;
 	int16 temp[64];
 
@@ -1319,9 +1613,18 @@ void BinkDecoder::BinkVideoTrack::IDCT(int16 *block) {
 	for (i = 0; i < 8; i++) {
 		IDCT_ROW( (&block[8*i]), (&temp[8*i]) );
 	}
+#endif
 }
 
 void BinkDecoder::BinkVideoTrack::IDCTAdd(DecodeContext &ctx, int16 *block) {
+#ifdef BINK_SIMD
+	BinkVec16 rows[8];
+	vecIDCT(block, rows);
+
+	byte *dest = ctx.dest;
+	for (int i = 0; i < 8; i++, dest += ctx.pitch)
+		vecAddBytes(dest, rows[i]);
+#else
 	int i, j;
 
 	IDCT(block);
@@ -1329,9 +1632,18 @@ void BinkDecoder::BinkVideoTrack::IDCTAdd(DecodeContext &ctx, int16 *block) {
 	for (i = 0; i < 8; i++, dest += ctx.pitch, block += 8)
 		for (j = 0; j < 8; j++)
 			 dest[j] += block[j];
+#endif
 }
 
 void BinkDecoder::BinkVideoTrack::IDCTPut(DecodeContext &ctx, int16 *block) {
+#ifdef BINK_SIMD
+	BinkVec16 rows[8];
+	vecIDCT(block, rows);
+
+	byte *dest = ctx.dest;
+	for (int i = 0; i < 8; i++, dest += ctx.pitch)
+		vecPutBytes(dest, rows[i]);
+#else
 	int i;
 	int16 temp[64];
 	for (i = 0; i < 8; i++)
@@ -1339,6 +1651,7 @@ void BinkDecoder::BinkVideoTrack::IDCTPut(DecodeContext &ctx, int16 *block) {
 	for (i = 0; i < 8; i++) {
 		IDCT_ROW( (&ctx.dest[i*ctx.pitch]), (&temp[8*i]) );
 	}
+#endif
 }
 
 BinkDecoder::BinkAudioTrack::BinkAudioTrack(BinkDecoder::AudioInfo &audio) : _audioInfo(&audio) {
@@ -147,7 +147,8 @@ private:
 		Graphics::PixelFormat getPixelFormat() const { return _surface.format; }
 		int getCurFrame() const { return _curFrame; }
 		int getFrameCount() const { return _frameCount; }
-		const Graphics::Surface *decodeNextFrame() { return &_surface; }
+		const Graphics::Surface *decodeNextFrame();
+		bool decodeNextFrameTo(Graphics::Surface &dst);
 
 		/** Decode a video packet. */
 		void decodePacket(VideoFrame &frame);
@@ -235,6 +236,7 @@ private:
 		Graphics::Surface _surface;
 		int _surfaceWidth; ///< The actual surface width
 		int _surfaceHeight; ///< The actual surface height
+		bool _surfaceConverted; ///< Does _surface hold the frame decoded last?
 
 		uint32 _id; ///< The BIK FourCC.
 
@@ -266,6 +268,9 @@ private:
 		/** Decode a plane. */
 		void decodePlane(VideoFrame &video, int planeIdx, bool isChroma);
 
+		/** Convert the frame decoded last to RGB. */
+		void convertFrame(Graphics::Surface &dst);
+
 		/** Read/Initialize a bundle for decoding a plane. */
 		void readBundle(VideoFrame &video, Source source);
 
@@ -110,6 +110,17 @@ const Graphics::Surface *QuickTimeDecoder::decodeNextFrame() {
 	return frame;
 }
 
+bool QuickTimeDecoder::decodeNextFrameTo(Graphics::Surface &dst) {
+	// The frames may have to be scaled first
+	const Graphics::Surface *frame = decodeNextFrame();
+
+	if (!frame)
+		return false;
+
+	copyFrame(*frame, dst);
+	return true;
+}
+
 Common::QuickTimeParser::SampleDesc *QuickTimeDecoder::readSampleDesc(Common::QuickTimeParser::Track *track, uint32 format, uint32 descSize) {
 	if (track->codecType == CODEC_TYPE_VIDEO) {
 		debug(0, "Video Codec FourCC: \'%s\'", tag2str(format));
@@ -67,6 +67,7 @@ public:
 	uint16 getWidth() const { return _width; }
 	uint16 getHeight() const { return _height; }
 	const Graphics::Surface *decodeNextFrame();
+	bool decodeNextFrameTo(Graphics::Surface &dst);
 	Audio::Timestamp getDuration() const { return Audio::Timestamp(0, _duration, _timeScale); }
 
 protected:
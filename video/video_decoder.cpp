@@ -30,9 +30,19 @@
 #include "common/system.h"
 
 #include "graphics/palette.h"
+#include "graphics/surface.h"
 
 namespace Video {
 
+struct VideoDecoder::QueuedFrame {
+	Graphics::Surface surface;
+	bool hasSurface;  ///< false if the video track returned no frame
+	byte palette[256 * 3];
+	bool dirtyPalette;
+	uint32 startTime; ///< The time the frame is due at
+	int curFrame;     ///< getCurFrame() before the frame was shown
+};
+
 VideoDecoder::VideoDecoder() {
 	_startTime = 0;
 	_dirtyPalette = false;
@@ -46,6 +56,10 @@ VideoDecoder::VideoDecoder() {
 	_endTime = 0;
 	_endTimeSet = false;
 	_nextVideoTrack = 0;
+	_decodeAheadFrames = 0;
+	_frameQueueHead = 0;
+	_frameQueueSize = 0;
+	_decodeTime = 0;
 
 	// Find the best format for output
 	_defaultHighColorFormat = g_system->getScreenFormat();
@@ -54,10 +68,16 @@ VideoDecoder::VideoDecoder() {
 		_defaultHighColorFormat = Graphics::PixelFormat(4, 8, 8, 8, 8, 8, 16, 24, 0);
 }
 
+VideoDecoder::~VideoDecoder() {
+	freeFrameQueue();
+}
+
 void VideoDecoder::close() {
 	if (isPlaying())
 		stop();
 
+	freeFrameQueue();
+
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		delete *it;
 
@@ -73,6 +93,7 @@ void VideoDecoder::close() {
 	_endTime = 0;
 	_endTimeSet = false;
 	_nextVideoTrack = 0;
+	_decodeTime = 0;
 }
 
 bool VideoDecoder::loadFile(const Common::String &filename) {
@@ -90,6 +111,94 @@ bool VideoDecoder::needsUpdate() const {
 	return hasFramesLeft() && getTimeToNextFrame() == 0;
 }
 
+void VideoDecoder::setDecodeAhead(uint frames) {
+	// The frames already decoded ahead are kept, they can't be decoded again
+	_decodeAheadFrames = frames;
+}
+
+bool VideoDecoder::canDecodeAhead() const {
+	return _frameQueueSize < _decodeAheadFrames && isPlaying() && !isPaused() &&
+		_nextVideoTrack && !_nextVideoTrack->isReversed() && hasFramesToDecode();
+}
+
+void VideoDecoder::pump() {
+	// Only decode when that won't make the next frame late
+	if (canDecodeAhead() && getTimeToNextFrame() > _decodeTime)
+		decodeAhead();
+}
+
+void VideoDecoder::decodeAhead() {
+	if (_frameQueue.size() < _decodeAheadFrames + 1)
+		growFrameQueue();
+
+	const uint32 start = g_system->getMillis();
+
+	QueuedFrame &frame = *_frameQueue[(_frameQueueHead + _frameQueueSize) % _frameQueue.size()];
+	frame.startTime = _nextVideoTrack->getNextFrameStartTime();
+	frame.curFrame = getDecodedFrame();
+	frame.hasSurface = false;
+	frame.dirtyPalette = false;
+
+	readNextPacket();
+
+	if (_nextVideoTrack) {
+		const Graphics::Surface *surface = _nextVideoTrack->decodeNextFrame();
+
+		if (surface) {
+			if (frame.surface.w != surface->w || frame.surface.h != surface->h || frame.surface.format != surface->format)
+				frame.surface.create(surface->w, surface->h, surface->format);
+
+			copyFrame(*surface, frame.surface);
+
+			frame.hasSurface = true;
+		}
+
+		if (_nextVideoTrack->hasDirtyPalette()) {
+			memcpy(frame.palette, _nextVideoTrack->getPalette(), sizeof(frame.palette));
+			frame.dirtyPalette = true;
+		}
+
+		findNextVideoTrack();
+	}
+
+	_frameQueueSize++;
+	updateDecodeTime(g_system->getMillis() - start);
+}
+
+void VideoDecoder::growFrameQueue() {
+	// Keep the frame returned last and the ones decoded ahead, in order
+	Common::Array<QueuedFrame *> queue;
+
+	for (uint i = 0; i < _frameQueue.size(); i++)
+		queue.push_back(_frameQueue[(_frameQueueHead + _frameQueue.size() - 1 + i) % _frameQueue.size()]);
+
+	while (queue.size() < _decodeAheadFrames + 1) {
+		QueuedFrame *frame = new QueuedFrame();
+		frame->hasSurface = false;
+		frame->dirtyPalette = false;
+		queue.push_back(frame);
+	}
+
+	_frameQueue = queue;
+	_frameQueueHead = 1;
+}
+
+void VideoDecoder::freeFrameQueue() {
+	for (uint i = 0; i < _frameQueue.size(); i++) {
+		_frameQueue[i]->surface.free();
+		delete _frameQueue[i];
+	}
+
+	_frameQueue.clear();
+	_frameQueueHead = 0;
+	_frameQueueSize = 0;
+}
+
+void VideoDecoder::updateDecodeTime(uint32 time) {
+	// Follow slower frames at once, faster ones gradually
+	_decodeTime = MAX(time, (_decodeTime * 7 + time) / 8);
+}
+
 void VideoDecoder::pauseVideo(bool pause) {
 	if (pause) {
 		_pauseLevel++;
@@ -168,6 +277,26 @@ Graphics::PixelFormat VideoDecoder::getPixelFormat() const {
 const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 	_needsUpdate = false;
 
+	// With decode-ahead, the tracks' surfaces are overwritten by pump(),
+	// so every frame returned is one from the queue
+	if (!_frameQueueSize && _decodeAheadFrames && _nextVideoTrack)
+		decodeAhead();
+
+	if (_frameQueueSize) {
+		const QueuedFrame &frame = *_frameQueue[_frameQueueHead];
+		_frameQueueHead = (_frameQueueHead + 1) % _frameQueue.size();
+		_frameQueueSize--;
+
+		if (frame.dirtyPalette) {
+			_palette = frame.palette;
+			_dirtyPalette = true;
+		}
+
+		return frame.hasSurface ? &frame.surface : 0;
+	}
+
+	const uint32 start = g_system->getMillis();
+
 	readNextPacket();
 
 	// If we have no next video track at this point, there shouldn't be
@@ -176,7 +305,37 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 		return 0;
 
 	const Graphics::Surface *frame = _nextVideoTrack->decodeNextFrame();
+	frameDecoded(start);
+	return frame;
+}
 
+bool VideoDecoder::decodeNextFrameTo(Graphics::Surface &dst) {
+	// The frames decoded ahead are in our surfaces already
+	if (_frameQueueSize) {
+		const Graphics::Surface *frame = VideoDecoder::decodeNextFrame();
+
+		if (!frame)
+			return false;
+
+		copyFrame(*frame, dst);
+		return true;
+	}
+
+	_needsUpdate = false;
+
+	const uint32 start = g_system->getMillis();
+
+	readNextPacket();
+
+	if (!_nextVideoTrack)
+		return false;
+
+	const bool decoded = _nextVideoTrack->decodeNextFrameTo(dst);
+	frameDecoded(start);
+	return decoded;
+}
+
+void VideoDecoder::frameDecoded(uint32 start) {
 	if (_nextVideoTrack->hasDirtyPalette()) {
 		_palette = _nextVideoTrack->getPalette();
 		_dirtyPalette = true;
@@ -185,7 +344,14 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 	// Look for the next video track here for the next decode.
 	findNextVideoTrack();
 
-	return frame;
+	updateDecodeTime(g_system->getMillis() - start);
+}
+
+void VideoDecoder::copyFrame(const Graphics::Surface &src, Graphics::Surface &dst) {
+	assert(dst.w >= src.w && dst.h >= src.h && dst.format == src.format);
+
+	for (int y = 0; y < src.h; y++)
+		memcpy(dst.getBasePtr(0, y), src.getBasePtr(0, y), src.w * src.format.bytesPerPixel);
 }
 
 bool VideoDecoder::setReverse(bool reverse) {
@@ -193,6 +359,10 @@ bool VideoDecoder::setReverse(bool reverse) {
 	if (reverse && hasAudio())
 		return false;
 
+	// The tracks are past the frames decoded ahead
+	if (reverse && _frameQueueSize)
+		return false;
+
 	// Attempt to make sure all the tracks are in the requested direction
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
 		if ((*it)->getTrackType() == Track::kTrackTypeVideo && ((VideoTrack *)*it)->isReversed() != reverse) {
@@ -213,6 +383,14 @@ const byte *VideoDecoder::getPalette() {
 }
 
 int VideoDecoder::getCurFrame() const {
+	// The frames decoded ahead have not been returned yet
+	if (_frameQueueSize)
+		return _frameQueue[_frameQueueHead]->curFrame;
+
+	return getDecodedFrame();
+}
+
+int VideoDecoder::getDecodedFrame() const {
 	int32 frame = -1;
 
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
@@ -254,10 +432,23 @@ uint32 VideoDecoder::getTime() const {
 }
 
 uint32 VideoDecoder::getTimeToNextFrame() const {
-	if (endOfVideo() || _needsUpdate || !_nextVideoTrack)
+	if (endOfVideo() || _needsUpdate)
 		return 0;
 
 	uint32 currentTime = getTime();
+
+	if (_frameQueueSize) {
+		uint32 nextFrameStartTime = _frameQueue[_frameQueueHead]->startTime;
+
+		if (nextFrameStartTime <= currentTime)
+			return 0;
+
+		return nextFrameStartTime - currentTime;
+	}
+
+	if (!_nextVideoTrack)
+		return 0;
+
 	uint32 nextFrameStartTime = _nextVideoTrack->getNextFrameStartTime();
 
 	if (_nextVideoTrack->isReversed()) {
@@ -276,6 +467,10 @@ uint32 VideoDecoder::getTimeToNextFrame() const {
 }
 
 bool VideoDecoder::endOfVideo() const {
+	// The frames decoded ahead are still to be returned
+	if (_frameQueueSize && (!isPlaying() || !_endTimeSet || _frameQueue[_frameQueueHead]->startTime < (uint)_endTime.msecs()))
+		return false;
+
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		if (!(*it)->endOfTrack() && (!isPlaying() || (*it)->getTrackType() != Track::kTrackTypeVideo || !_endTimeSet || ((VideoTrack *)*it)->getNextFrameStartTime() < (uint)_endTime.msecs()))
 			return false;
@@ -302,6 +497,8 @@ bool VideoDecoder::rewind() {
 	if (isPlaying())
 		stopAudio();
 
+	_frameQueueSize = 0;
+
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		if (!(*it)->rewind())
 			return false;
@@ -336,6 +533,8 @@ bool VideoDecoder::seek(const Audio::Timestamp &time) {
 	if (isPlaying())
 		stopAudio();
 
+	_frameQueueSize = 0;
+
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		if (!(*it)->seek(time))
 			return false;
@@ -496,6 +695,16 @@ bool VideoDecoder::VideoTrack::endOfTrack() const {
 	return getCurFrame() >= (getFrameCount() - 1);
 }
 
+bool VideoDecoder::VideoTrack::decodeNextFrameTo(Graphics::Surface &dst) {
+	const Graphics::Surface *frame = decodeNextFrame();
+
+	if (!frame)
+		return false;
+
+	copyFrame(*frame, dst);
+	return true;
+}
+
 Audio::Timestamp VideoDecoder::VideoTrack::getFrameTime(uint frame) const {
 	// Default implementation: Return an invalid (negative) number
 	return Audio::Timestamp().addFrames(-1);
@@ -773,6 +982,13 @@ bool VideoDecoder::hasFramesLeft() const {
 	// This is similar to endOfVideo(), except it doesn't take Audio into account (and returns true if not the end of the video)
 	// This is only used for needsUpdate() atm so that setEndTime() works properly
 	// And unlike endOfVideoTracks(), this takes into account _endTime
+	if (_frameQueueSize && (!isPlaying() || !_endTimeSet || _frameQueue[_frameQueueHead]->startTime < (uint)_endTime.msecs()))
+		return true;
+
+	return hasFramesToDecode();
+}
+
+bool VideoDecoder::hasFramesToDecode() const {
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		if ((*it)->getTrackType() == Track::kTrackTypeVideo && !(*it)->endOfTrack() && (!isPlaying() || !_endTimeSet || ((VideoTrack *)*it)->getNextFrameStartTime() < (uint)_endTime.msecs()))
 			return true;
@@ -52,7 +52,7 @@ namespace Video {
 class VideoDecoder {
 public:
 	VideoDecoder();
-	virtual ~VideoDecoder() {}
+	virtual ~VideoDecoder();
 
 	/////////////////////////////////////////
 	// Opening/Closing a Video
@@ -343,6 +343,23 @@ public:
 	 */
 	virtual const Graphics::Surface *decodeNextFrame();
 
+	/**
+	 * Decode the next frame into a surface of the caller.
+	 *
+	 * This works like decodeNextFrame(), but writes the frame to dst, e.g. the
+	 * surface returned by OSystem::lockScreen(), or a part of it. Tracks
+	 * converting their frames from YUV, like Bink's, convert them into dst
+	 * directly, so the frame is not copied from the decoder's own surface.
+	 *
+	 * A subclass overriding decodeNextFrame() must override this as well.
+	 *
+	 * @param dst the surface to write the frame to, at least as large as
+	 *            the video and in its pixel format
+	 * @return whether a frame was written, if not, the last frame should be
+	 *         kept on screen
+	 */
+	virtual bool decodeNextFrameTo(Graphics::Surface &dst);
+
 	/**
 	 * Set the default high color format for videos that convert from YUV.
 	 *
@@ -365,6 +382,40 @@ public:
 	 */
 	bool setReverse(bool reverse);
 
+	/**
+	 * Set the number of frames to decode ahead of the one shown.
+	 *
+	 * By default, each frame is decoded by decodeNextFrame(), when it is
+	 * due. With decode-ahead, the following frames are decoded by pump(),
+	 * which the engine calls while waiting for the next frame to become
+	 * due, and decodeNextFrame() then only returns the frame decoded
+	 * before. A frame that is expensive to decode no longer delays its
+	 * own display, as long as the frames before it left enough time.
+	 *
+	 * getCurFrame(), getTimeToNextFrame(), needsUpdate() and endOfVideo()
+	 * keep describing the frames returned, not the ones decoded ahead.
+	 * Seeking and rewinding drop the frames decoded ahead. Frames are only
+	 * decoded ahead while playing forward, and setReverse() fails while
+	 * there are any.
+	 *
+	 * This setting is kept when closing the video.
+	 *
+	 * @param frames the number of frames to decode ahead, 0 to disable
+	 */
+	void setDecodeAhead(uint frames);
+
+	/**
+	 * Get the number of frames to decode ahead of the one shown.
+	 */
+	uint getDecodeAhead() const { return _decodeAheadFrames; }
+
+	/**
+	 * Decode one frame ahead, if decode-ahead is enabled and there is time
+	 * left to do so before the next frame is due. Engines call this while
+	 * waiting for the next frame, as often as they check needsUpdate().
+	 */
+	void pump();
+
 	/////////////////////////////////////////
 	// Audio Control
 	/////////////////////////////////////////
@@ -545,6 +596,15 @@ protected:
 		 */
 		virtual const Graphics::Surface *decodeNextFrame() = 0;
 
+		/**
+		 * Decode the next frame into a surface of the caller
+		 *
+		 * By default, this copies the frame returned by decodeNextFrame().
+		 *
+		 * @see VideoDecoder::decodeNextFrameTo()
+		 */
+		virtual bool decodeNextFrameTo(Graphics::Surface &dst);
+
 		/**
 		 * Get the palette currently in use by this track
 		 */
@@ -804,6 +864,11 @@ protected:
 	 */
 	VideoTrack *findNextVideoTrack();
 
+	/**
+	 * Copy a frame to a surface at least as large, in the same pixel format.
+	 */
+	static void copyFrame(const Graphics::Surface &src, Graphics::Surface &dst);
+
 	/**
 	 * Typedef helpers for accessing tracks
 	 */
@@ -838,6 +903,29 @@ private:
 	// Default PixelFormat settings
 	Graphics::PixelFormat _defaultHighColorFormat;
 
+	// Frames decoded ahead, in a ring. The entry before _frameQueueHead
+	// holds the frame returned last, so it stays valid until the next one
+	// is returned.
+	struct QueuedFrame;
+	uint _decodeAheadFrames;
+	Common::Array<QueuedFrame *> _frameQueue;
+	uint _frameQueueHead, _frameQueueSize;
+	uint32 _decodeTime; ///< Time it takes to decode a frame, averaged, in ms
+
+	bool canDecodeAhead() const;
+	void decodeAhead();
+	void growFrameQueue();
+	void freeFrameQueue();
+	void updateDecodeTime(uint32 time);
+
+	/**
+	 * Take over the palette of the frame _nextVideoTrack decoded since the
+	 * given time, and find the track of the next frame.
+	 */
+	void frameDecoded(uint32 start);
+	int getDecodedFrame() const;
+	bool hasFramesToDecode() const;
+
 	// Internal helper functions
 	void stopAudio();
 	void startAudio();